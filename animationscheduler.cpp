@@ -0,0 +1,174 @@
+#include "animationscheduler.h"
+#include <QGraphicsItem>
+#include <QTimer>
+#include <QCoreApplication>
+#include <algorithm>
+
+// 调度器挂在 QApplication 下，随应用一起销毁，避免在静态析构阶段操作定时器
+AnimationScheduler& AnimationScheduler::instance() {
+    static AnimationScheduler* scheduler = new AnimationScheduler(QCoreApplication::instance());
+    return *scheduler;
+}
+
+AnimationScheduler::AnimationScheduler(QObject* parent)
+    : QObject(parent)
+{
+    timer = new QTimer(this);
+    timer->setTimerType(Qt::PreciseTimer);
+    timer->setInterval(frameIntervalMs);
+    connect(timer, &QTimer::timeout, this, &AnimationScheduler::tick);
+    clock.start();
+}
+
+int AnimationScheduler::newChannel() {
+    return nextChannel++;
+}
+
+int AnimationScheduler::createGroup(int channel, std::function<void()> finished) {
+    int id = nextGroup++;
+    groups[id] = Group{channel, 0, std::move(finished)};
+    ensureRunning();
+    return id;
+}
+
+void AnimationScheduler::animateOpacity(QGraphicsItem* item, qreal from, qreal to, int durationMs, int channel, int group) {
+    addTween(Tween{item, QPointF(from, 0), QPointF(to, 0), clock.elapsed(), durationMs, channel, group, Opacity});
+}
+
+void AnimationScheduler::animatePos(QGraphicsItem* item, const QPointF& from, const QPointF& to, int durationMs, int channel, int group) {
+    addTween(Tween{item, from, to, clock.elapsed(), durationMs, channel, group, Pos});
+}
+
+void AnimationScheduler::after(int channel, int delayMs, std::function<void()> action) {
+    auto once = [action = std::move(action)]() { action(); return false; };
+    steps.push_back(Step{clock.elapsed() + delayMs, 0, channel, channelEpoch[channel], once});
+    ensureRunning();
+}
+
+void AnimationScheduler::every(int channel, int intervalMs, std::function<bool()> step, int firstDelayMs) {
+    steps.push_back(Step{clock.elapsed() + firstDelayMs, std::max(1, intervalMs), channel,
+                         channelEpoch[channel], std::move(step)});
+    ensureRunning();
+}
+
+void AnimationScheduler::cancel(int channel) {
+    ++channelEpoch[channel];
+    tweens.erase(std::remove_if(tweens.begin(), tweens.end(),
+                                [channel](const Tween& t) { return t.channel == channel; }), tweens.end());
+    steps.erase(std::remove_if(steps.begin(), steps.end(),
+                               [channel](const Step& s) { return s.channel == channel; }), steps.end());
+    for (auto it = groups.begin(); it != groups.end(); ) {
+        if (it->second.channel == channel) it = groups.erase(it);
+        else ++it;
+    }
+}
+
+void AnimationScheduler::cancel(QGraphicsItem* item) {
+    for (size_t i = 0; i < tweens.size(); ) {
+        if (tweens[i].item != item) { ++i; continue; }
+        if (tweens[i].group) {
+            auto g = groups.find(tweens[i].group);
+            if (g != groups.end()) --g->second.remaining;
+        }
+        if (i + 1 != tweens.size()) tweens[i] = tweens.back();
+        tweens.pop_back();
+    }
+}
+
+void AnimationScheduler::finish(int channel) {
+    ++channelEpoch[channel];
+    for (const Tween& t : tweens) {
+        if (t.channel == channel) apply(t, 1.0);
+    }
+    tweens.erase(std::remove_if(tweens.begin(), tweens.end(),
+                                [channel](const Tween& t) { return t.channel == channel; }), tweens.end());
+    steps.erase(std::remove_if(steps.begin(), steps.end(),
+                               [channel](const Step& s) { return s.channel == channel; }), steps.end());
+    // 先摘出回调再执行，回调中可以继续添加动画
+    std::vector<std::function<void()>> callbacks;
+    for (auto it = groups.begin(); it != groups.end(); ) {
+        if (it->second.channel == channel) {
+            if (it->second.finished) callbacks.push_back(std::move(it->second.finished));
+            it = groups.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto& cb : callbacks) cb();
+}
+
+void AnimationScheduler::addTween(const Tween& t) {
+    if (t.group) {
+        auto g = groups.find(t.group);
+        if (g != groups.end()) ++g->second.remaining;
+    }
+    apply(t, 0.0);
+    tweens.push_back(t);
+    ensureRunning();
+}
+
+void AnimationScheduler::apply(const Tween& t, qreal progress) {
+    QPointF v = t.from + (t.to - t.from) * progress;
+    if (t.property == Opacity) t.item->setOpacity(v.x());
+    else t.item->setPos(v);
+}
+
+void AnimationScheduler::ensureRunning() {
+    if (!timer->isActive()) timer->start();
+}
+
+// 每帧推进所有补间，执行到期的步骤；没有任何任务时停止定时器
+void AnimationScheduler::tick() {
+    qint64 now = clock.elapsed();
+
+    // 推进补间，完成的补间用末尾元素覆盖删除
+    for (size_t i = 0; i < tweens.size(); ) {
+        const Tween& t = tweens[i];
+        qreal progress = t.duration <= 0 ? 1.0 : std::min<qreal>(1.0, qreal(now - t.start) / t.duration);
+        apply(t, progress);
+        if (progress < 1.0) { ++i; continue; }
+        if (t.group) {
+            auto g = groups.find(t.group);
+            if (g != groups.end()) --g->second.remaining;
+        }
+        if (i + 1 != tweens.size()) tweens[i] = tweens.back();
+        tweens.pop_back();
+    }
+
+    // 收集已完成的分组
+    std::vector<std::function<void()>> callbacks;
+    for (auto it = groups.begin(); it != groups.end(); ) {
+        if (it->second.remaining <= 0) {
+            if (it->second.finished) callbacks.push_back(std::move(it->second.finished));
+            it = groups.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // 取出到期的步骤再执行，步骤中可以安全地添加新任务或取消通道
+    std::vector<Step> due;
+    for (size_t i = 0; i < steps.size(); ) {
+        if (steps[i].due <= now) {
+            due.push_back(std::move(steps[i]));
+            if (i + 1 != steps.size()) steps[i] = std::move(steps.back());
+            steps.pop_back();
+        } else {
+            ++i;
+        }
+    }
+    std::sort(due.begin(), due.end(), [](const Step& a, const Step& b) { return a.due < b.due; });
+
+    // 回调里弹出模态对话框时会重入 tick，此时待执行的步骤已经移到局部数组中，不会重复执行
+    for (auto& cb : callbacks) cb();
+    for (Step& s : due) {
+        if (channelEpoch[s.channel] != s.epoch) continue;   // 所在通道已被取消
+        bool again = s.action();
+        if (again && s.interval > 0 && channelEpoch[s.channel] == s.epoch) {
+            s.due += s.interval;
+            steps.push_back(std::move(s));
+        }
+    }
+
+    if (tweens.empty() && steps.empty() && groups.empty()) timer->stop();
+}
@@ -0,0 +1,93 @@
+#ifndef ANIMATIONSCHEDULER_H
+#define ANIMATIONSCHEDULER_H
+
+#include <QObject>
+#include <QPointF>
+#include <QElapsedTimer>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+class QGraphicsItem;
+class QTimer;
+
+// AnimationScheduler 是全局唯一的动画调度器：一个帧定时器推进所有补间动画和定时步骤。
+// 补间存放在紧凑数组中，不为每个节点创建 QPropertyAnimation，也不为每个遍历步骤挂一个 QTimer。
+// 所有动画和步骤都属于某个通道（channel），可以按通道整体取消或立即完成，
+// 例如开始新的遍历前取消上一次遍历尚未执行的步骤。
+class AnimationScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr int frameIntervalMs = 16;
+
+    static AnimationScheduler& instance();
+
+    int  newChannel();  // 分配一个新的通道编号
+
+    // 创建一组补间，组内全部完成后调用 finished（组内没有补间时在下一帧调用）
+    int  createGroup(int channel, std::function<void()> finished);
+
+    // 透明度/位置补间；目标图元被删除前必须先 cancel 或 finish 其所在通道
+    void animateOpacity(QGraphicsItem* item, qreal from, qreal to, int durationMs, int channel, int group = 0);
+    void animatePos(QGraphicsItem* item, const QPointF& from, const QPointF& to, int durationMs, int channel, int group = 0);
+
+    void after(int channel, int delayMs, std::function<void()> action);     // 延时执行一次
+    // 从 firstDelayMs 后开始，每隔 intervalMs 执行一次 step，直到它返回 false
+    void every(int channel, int intervalMs, std::function<bool()> step, int firstDelayMs = 0);
+
+    void cancel(int channel);   // 丢弃通道内的补间、分组和步骤，不调用任何回调
+    void finish(int channel);   // 补间直接跳到终值并触发分组回调，丢弃尚未执行的步骤
+    // 丢弃作用在 item 上的所有补间，不改变它的属性；所在分组照常在其余补间完成后回调。
+    // 图元被回收复用或删除前调用，旧补间不会再覆盖新设置的值
+    void cancel(QGraphicsItem* item);
+
+    int  activeTweens() const { return static_cast<int>(tweens.size()); }
+    int  pendingSteps() const { return static_cast<int>(steps.size()); }
+
+private:
+    explicit AnimationScheduler(QObject* parent);
+
+    enum Property : quint8 { Opacity, Pos };
+
+    // 一个补间：目标图元、属性、起止值和时间
+    struct Tween {
+        QGraphicsItem* item;
+        QPointF from, to;       // 透明度只使用 x
+        qint64  start;
+        int     duration;
+        int     channel;
+        int     group;
+        Property property;
+    };
+
+    struct Group {
+        int channel;
+        int remaining;
+        std::function<void()> finished;
+    };
+
+    struct Step {
+        qint64 due;
+        int    interval;        // 0 表示只执行一次
+        int    channel;
+        int    epoch;           // 通道被取消后 epoch 变化，过期的步骤不再执行
+        std::function<bool()> action;
+    };
+
+    void addTween(const Tween& t);
+    void apply(const Tween& t, qreal progress);
+    void tick();
+    void ensureRunning();
+
+    QTimer* timer;
+    QElapsedTimer clock;
+    std::vector<Tween> tweens;
+    std::vector<Step> steps;
+    std::unordered_map<int, Group> groups;
+    std::unordered_map<int, int> channelEpoch;
+    int nextChannel = 1;
+    int nextGroup = 1;
+};
+
+#endif
@@ -0,0 +1,90 @@
+#include "arraystripitem.h"
+#include "loditems.h"
+#include <QPainter>
+#include <QPen>
+#include <QStyleOptionGraphicsItem>
+#include <algorithm>
+#include <cmath>
+
+ArrayStripItem::ArrayStripItem(QGraphicsItem* parent)
+    : QGraphicsItem(parent)
+{
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);  // 需要 exposedRect 只画可见的格子
+}
+
+void ArrayStripItem::setGroupSize(int d) {
+    groupSize = std::max(1, d);
+    update();
+}
+
+void ArrayStripItem::setValues(std::vector<int> newValues) {
+    prepareGeometryChange();
+    values = std::move(newValues);
+    marks.assign(values.size(), None);
+    marked.clear();
+}
+
+void ArrayStripItem::push(int value) {
+    prepareGeometryChange();
+    values.push_back(value);
+    marks.push_back(None);
+}
+
+void ArrayStripItem::pop() {
+    if (values.empty()) return;
+    update(cellRect(count() - 1).adjusted(0, 0, 0, LabelHeight));
+    prepareGeometryChange();
+    values.pop_back();
+    marks.pop_back();
+}
+
+void ArrayStripItem::swap(int i, int j) {
+    std::swap(values[i], values[j]);
+    update(cellRect(i));
+    update(cellRect(j));
+}
+
+void ArrayStripItem::setMark(int i, Mark mark) {
+    if (marks[i] == mark) return;
+    marks[i] = mark;
+    if (mark != None) marked.push_back(i);
+    update(cellRect(i));
+}
+
+void ArrayStripItem::clearMarks() {
+    for (int i : marked) {
+        if (i < count() && marks[i] != None) {
+            marks[i] = None;
+            update(cellRect(i));
+        }
+    }
+    marked.clear();
+}
+
+QRectF ArrayStripItem::boundingRect() const {
+    return QRectF(0, 0, std::max(1, count()) * CellWidth, CellHeight + LabelHeight);
+}
+
+void ArrayStripItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget*) {
+    const QRectF& exposed = option->exposedRect;
+    int first = std::max(0, int(std::floor(exposed.left() / CellWidth)));
+    int last = std::min(count() - 1, int(std::ceil(exposed.right() / CellWidth)));
+    bool labels = Lod::levelOf(option, painter) >= Lod::Label;
+
+    for (int i = first; i <= last; ++i) {
+        QRectF cell = cellRect(i);
+        painter->setPen(QPen(Qt::darkGray, 1));
+        QColor fill;
+        if (marks[i] == Active) fill = QColor(255, 140, 0);
+        else if (marks[i] == Settled) fill = QColor(0, 160, 0);
+        else if (i == 0) fill = QColor(200, 220, 255);
+        else fill = ((i - 1) / groupSize) % 2 ? QColor(235, 235, 235) : Qt::white;
+        painter->setBrush(fill);
+        painter->drawRect(cell);
+        if (!labels) continue;
+        painter->setPen(marks[i] == None ? Qt::black : Qt::white);
+        painter->drawText(cell, Qt::AlignCenter, QString::number(values[i]));
+        painter->setPen(Qt::darkGray);
+        painter->drawText(QRectF(cell.left(), CellHeight, CellWidth, LabelHeight), Qt::AlignCenter, QString::number(i));
+    }
+}
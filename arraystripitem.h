@@ -0,0 +1,46 @@
+#ifndef ARRAYSTRIPITEM_H
+#define ARRAYSTRIPITEM_H
+
+#include <QGraphicsItem>
+#include <QRectF>
+#include <vector>
+
+// ArrayStripItem 把一个整数数组画成一排格子，格子下方标出下标。
+// 与 EdgeLayerItem 一样用一个图元批量绘制所有格子，只画可见的部分。
+// 设置分组大小 d 后，下标 1 起每 d 个格子（d 叉堆中同一个节点的孩子）交替底色
+class ArrayStripItem : public QGraphicsItem
+{
+public:
+    static constexpr qreal CellWidth = 40;
+    static constexpr qreal CellHeight = 30;
+    static constexpr qreal LabelHeight = 16;    // 下标文字的高度
+
+    enum Mark : quint8 {
+        None,
+        Active,     // 正在比较或交换
+        Settled,    // 操作结束的位置
+    };
+
+    explicit ArrayStripItem(QGraphicsItem* parent = nullptr);
+
+    void setGroupSize(int d);
+    void setValues(std::vector<int> values);
+    void push(int value);
+    void pop();
+    void swap(int i, int j);
+    void setMark(int i, Mark mark);
+    void clearMarks();
+    int  count() const { return static_cast<int>(values.size()); }
+    QRectF cellRect(int i) const { return QRectF(i * CellWidth, 0, CellWidth, CellHeight); }
+
+    QRectF boundingRect() const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override;
+
+private:
+    std::vector<int> values;
+    std::vector<quint8> marks;
+    std::vector<int> marked;    // 带标记的下标，清除时不必扫描整个数组
+    int groupSize = 2;
+};
+
+#endif
@@ -1,23 +1,31 @@
 #ifndef ARROWITEM_H
 #define ARROWITEM_H
 
-#include <QObject>
 #include <QGraphicsPolygonItem>
 #include <QPolygonF>
 #include <QPen>
 #include <QBrush>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include "loditems.h"
 
-// ArrowItem 类用于在图形场景中绘制一个可视化箭头。
-class ArrowItem : public QObject, public QGraphicsPolygonItem
+// ArrowItem 类用于在图形场景中绘制一个独立的可视化箭头。
+// 它不继承 QObject：没有元对象、子对象列表和析构时的信号开销，只是一个普通图元。
+// 链表和树的大量箭头由 EdgeLayerItem 以享元方式批量绘制，ArrowItem 只用于零散的单个箭头。
+class ArrowItem : public QGraphicsPolygonItem
 {
-    Q_OBJECT
-    Q_PROPERTY(QPointF pos READ pos WRITE setPos)
-
 public:
     // 构造函数，接收箭头多边形形状和可选的父图元
     explicit ArrowItem(QPolygonF polygon, QGraphicsItem *parent = nullptr)
-        : QObject(), QGraphicsPolygonItem(polygon, parent)
+        : QGraphicsPolygonItem(polygon, parent)
+    {
+    }
+
+    // 箭头只在看得清时绘制，缩小到一定程度后省略
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override
     {
+        if (Lod::levelOf(option, painter) < Lod::Detail) return;
+        QGraphicsPolygonItem::paint(painter, option, widget);
     }
 };
 
@@ -0,0 +1,385 @@
+#include "binarytreemodel.h"
+#include <algorithm>
+#include <climits>
+#include <utility>
+
+int BinaryTreeModel::insertChild(int parentId, Side side, int value) {
+    if (parentId == npos) {
+        if (m_root != npos) return npos;   // 已有根节点
+    } else {
+        if (!isValid(parentId)) return npos;
+        int child = side == Left ? m_left[parentId] : m_right[parentId];
+        if (child != npos) return npos;    // 该位置已被占用
+    }
+    int id = allocate(value);
+    m_parent[id] = parentId;
+    if (parentId == npos) m_root = id;
+    else if (side == Left) m_left[parentId] = id;
+    else m_right[parentId] = id;
+    m_changes.notify(TreeEvent{TreeEvent::Inserted, id, value, parentId});
+    return id;
+}
+
+bool BinaryTreeModel::removeLeaf(int id) {
+    if (!isValid(id) || m_left[id] != npos || m_right[id] != npos) return false;
+    if (!m_levelOrder.empty() && m_levelOrder.back() == id) m_levelOrder.pop_back();
+    TreeEvent e{TreeEvent::Removed, id, m_value[id], m_parent[id]};
+    e.anchor = e.parent;
+    detach(id);
+    release(id);
+    m_changes.notify(e);
+    return true;
+}
+
+int BinaryTreeModel::appendLevelOrder() {
+    return appendLevelOrderValue(nextValue);
+}
+
+int BinaryTreeModel::appendLevelOrderValue(int value) {
+    // 槽位 i 的父节点位于槽位 (i-1)/2，奇数槽位是左孩子
+    int slot = static_cast<int>(m_levelOrder.size());
+    int parentId = slot == 0 ? npos : m_levelOrder[(slot - 1) / 2];
+    Side side = slot % 2 == 1 ? Left : Right;
+    if (value >= nextValue && value < INT_MAX) nextValue = value + 1;    // 之后自动递增的值接在最大值后面
+
+    int id = allocate(value);
+    m_parent[id] = parentId;
+    if (parentId == npos) m_root = id;
+    else if (side == Left) m_left[parentId] = id;
+    else m_right[parentId] = id;
+    m_levelOrder.push_back(id);
+    m_changes.notify(TreeEvent{TreeEvent::Inserted, id, value, parentId, slot});
+    return id;
+}
+
+int BinaryTreeModel::removeLastLevelOrder() {
+    if (m_levelOrder.empty()) return npos;
+    int id = m_levelOrder.back();
+    int slot = static_cast<int>(m_levelOrder.size()) - 1;
+    m_levelOrder.pop_back();
+    TreeEvent e{TreeEvent::Removed, id, m_value[id], m_parent[id], slot};
+    e.anchor = e.parent;
+    detach(id);
+    release(id);
+    m_changes.notify(e);
+    return id;
+}
+
+void BinaryTreeModel::appendLevelOrder(int count) {
+    m_levelOrder.reserve(m_levelOrder.size() + count);
+    for (int i = 0; i < count; ++i) appendLevelOrder();
+}
+
+int BinaryTreeModel::apply(const std::vector<TreeOperation>& ops) {
+    int applied = 0;
+    for (const TreeOperation& op : ops) {
+        switch (op.type) {
+        case TreeOperation::AppendLevelOrder:     appendLevelOrder(); ++applied; break;
+        case TreeOperation::RemoveLastLevelOrder: applied += removeLastLevelOrder() != npos; break;
+        case TreeOperation::Clear:                clear(); ++applied; break;
+        case TreeOperation::InsertKey:            applied += insertKey(op.key) != npos; break;
+        case TreeOperation::RemoveKey:            applied += removeKey(op.key); break;
+        }
+    }
+    return applied;
+}
+
+void BinaryTreeModel::setBalancing(Balancing b) {
+    clear();
+    m_balancing = b;
+}
+
+int BinaryTreeModel::find(int key) const {
+    int v = m_root;
+    while (v != npos && m_value[v] != key) v = key < m_value[v] ? m_left[v] : m_right[v];
+    return v;
+}
+
+int BinaryTreeModel::insertKey(int key) {
+    int parent = npos;
+    Side side = Left;
+    for (int v = m_root; v != npos; v = side == Left ? m_left[v] : m_right[v]) {
+        if (key == m_value[v]) return npos;
+        parent = v;
+        side = key < m_value[v] ? Left : Right;
+    }
+    int id = allocate(key);
+    m_parent[id] = parent;
+    if (parent == npos) m_root = id;
+    else if (side == Left) m_left[parent] = id;
+    else m_right[parent] = id;
+    m_changes.notify(TreeEvent{TreeEvent::Inserted, id, key, parent});
+
+    if (m_balancing == Avl) rebalanceAvl(parent);
+    else if (m_balancing == RedBlack) fixRedBlackInsert(id);
+    return id;
+}
+
+bool BinaryTreeModel::removeKey(int key) {
+    int z = find(key);
+    if (z == npos) return false;
+
+    int x, xParent;     // 顶替到空出位置上的节点（可能为空）及其父节点
+    Color removedColor; // 实际从原位置消失的颜色：z 只有一个孩子时是 z 的，否则是后继的
+    int successor = npos;
+    if (m_left[z] == npos || m_right[z] == npos) {
+        x = m_left[z] != npos ? m_left[z] : m_right[z];
+        xParent = m_parent[z];
+        removedColor = Color(m_meta[z]);
+        transplant(z, x);
+    } else {
+        // 后继节点整体接到 z 的位置，后继原来的右孩子接到后继原来的位置
+        int y = m_right[z];
+        while (m_left[y] != npos) y = m_left[y];
+        successor = y;
+        removedColor = Color(m_meta[y]);
+        x = m_right[y];
+        if (m_parent[y] == z) {
+            xParent = y;
+        } else {
+            xParent = m_parent[y];
+            transplant(y, x);
+            m_right[y] = m_right[z];
+            m_parent[m_right[y]] = y;
+        }
+        transplant(z, y);
+        m_left[y] = m_left[z];
+        m_parent[m_left[y]] = y;
+    }
+
+    if (!m_levelOrder.empty() && m_levelOrder.back() == z) m_levelOrder.pop_back();
+    TreeEvent e{TreeEvent::Removed, z, m_value[z], m_parent[z]};
+    e.anchor = xParent;
+    signed char zMeta = m_meta[z];  // 红黑树为颜色，AVL 为高度
+    m_left[z] = m_right[z] = m_parent[z] = npos;
+    release(z);
+    m_changes.notify(e);
+
+    if (m_balancing == Avl) {
+        if (successor != npos) m_meta[successor] = zMeta;   // 后继先继承 z 原位置的高度，再自下而上修正
+        rebalanceAvl(xParent);
+    } else if (m_balancing == RedBlack) {
+        if (successor != npos) setColor(successor, Color(zMeta));    // 后继继承 z 的颜色
+        if (removedColor == Black) fixRedBlackRemove(x, xParent);
+    }
+    return true;
+}
+
+// 节点池整体交换，编号不变；平衡策略随之交换，控件据此同步模式
+void BinaryTreeModel::adopt(BinaryTreeModel& staged) {
+    m_value.swap(staged.m_value); m_left.swap(staged.m_left); m_right.swap(staged.m_right);
+    m_parent.swap(staged.m_parent); m_meta.swap(staged.m_meta); m_alive.swap(staged.m_alive);
+    m_free.swap(staged.m_free); m_levelOrder.swap(staged.m_levelOrder);
+    std::swap(m_root, staged.m_root);
+    std::swap(m_size, staged.m_size);
+    std::swap(nextValue, staged.nextValue);
+    std::swap(m_balancing, staged.m_balancing);
+    m_changes.notify(TreeEvent{TreeEvent::Reset});
+}
+
+void BinaryTreeModel::applyLinks(const std::vector<Link>& links, int root, int capacity) {
+    for (int id = capacity; id < this->capacity(); ++id) m_size -= m_alive[id];
+    m_value.resize(capacity, 0); m_left.resize(capacity, npos); m_right.resize(capacity, npos);
+    m_parent.resize(capacity, npos); m_meta.resize(capacity, 0); m_alive.resize(capacity, 0);
+    for (const Link& l : links) {
+        if (l.id >= capacity) continue;     // 随后被清空的树中的节点
+        m_size += int(l.alive) - int(m_alive[l.id]);
+        m_value[l.id] = l.value;
+        m_left[l.id] = l.left;
+        m_right[l.id] = l.right;
+        m_parent[l.id] = l.parent;
+        m_alive[l.id] = l.alive;
+    }
+    m_root = root;
+}
+
+void BinaryTreeModel::clear() {
+    m_value.clear(); m_left.clear(); m_right.clear(); m_parent.clear();
+    m_meta.clear(); m_alive.clear(); m_free.clear(); m_levelOrder.clear();
+    m_root = npos;
+    m_size = 0;
+    nextValue = 1;
+    m_changes.notify(TreeEvent{TreeEvent::Cleared});
+}
+
+// 从节点池取一个槽位，优先复用空闲槽位
+int BinaryTreeModel::allocate(int value) {
+    int id;
+    if (!m_free.empty()) {
+        id = m_free.back();
+        m_free.pop_back();
+    } else {
+        id = capacity();
+        m_value.push_back(0); m_left.push_back(npos); m_right.push_back(npos);
+        m_parent.push_back(npos); m_meta.push_back(0); m_alive.push_back(0);
+    }
+    m_value[id] = value;
+    m_left[id] = m_right[id] = m_parent[id] = npos;
+    m_meta[id] = m_balancing == RedBlack ? Red : 1;   // 新节点：红色 / 高度为 1
+    m_alive[id] = 1;
+    ++m_size;
+    return id;
+}
+
+void BinaryTreeModel::release(int id) {
+    m_alive[id] = 0;
+    m_free.push_back(id);
+    --m_size;
+}
+
+void BinaryTreeModel::transplant(int u, int v) {
+    int p = m_parent[u];
+    if (p == npos) m_root = v;
+    else if (m_left[p] == u) m_left[p] = v;
+    else m_right[p] = v;
+    if (v != npos) m_parent[v] = p;
+}
+
+// x 是父节点 p 的左孩子时右旋，否则左旋；x 靠内侧的子树改挂到 p 下
+void BinaryTreeModel::rotateUp(int x) {
+    int p = m_parent[x];
+    int g = m_parent[p];
+    if (m_left[p] == x) {
+        int inner = m_right[x];
+        m_left[p] = inner;
+        if (inner != npos) m_parent[inner] = p;
+        m_right[x] = p;
+    } else {
+        int inner = m_left[x];
+        m_right[p] = inner;
+        if (inner != npos) m_parent[inner] = p;
+        m_left[x] = p;
+    }
+    m_parent[p] = x;
+    m_parent[x] = g;
+    if (g == npos) m_root = x;
+    else if (m_left[g] == p) m_left[g] = x;
+    else m_right[g] = x;
+    if (m_balancing == Avl) {
+        updateHeight(p);
+        updateHeight(x);
+    }
+    m_changes.notify(TreeEvent{TreeEvent::Rotated, p, m_value[p], x});
+}
+
+void BinaryTreeModel::updateHeight(int id) {
+    m_meta[id] = static_cast<signed char>(1 + std::max(height(m_left[id]), height(m_right[id])));
+}
+
+// 沿父链向上更新高度，左右高度差超过 1 时做单旋或双旋；某个节点高度不变且无需旋转时，上方不受影响
+void BinaryTreeModel::rebalanceAvl(int from) {
+    for (int v = from; v != npos; v = m_parent[v]) {
+        int before = m_meta[v];
+        updateHeight(v);
+        int balance = height(m_left[v]) - height(m_right[v]);
+        if (balance > 1) {
+            int l = m_left[v];
+            if (height(m_left[l]) < height(m_right[l])) rotateUp(m_right[l]);   // 左右型先左旋
+            rotateUp(m_left[v]);
+            v = m_parent[v];    // 继续检查旋转后子树根的祖先
+        } else if (balance < -1) {
+            int r = m_right[v];
+            if (height(m_right[r]) < height(m_left[r])) rotateUp(m_left[r]);   // 右左型先右旋
+            rotateUp(m_right[v]);
+            v = m_parent[v];
+        } else if (m_meta[v] == before) {
+            break;
+        }
+    }
+}
+
+void BinaryTreeModel::setColor(int id, Color c) {
+    if (m_meta[id] == c) return;
+    m_meta[id] = c;
+    m_changes.notify(TreeEvent{TreeEvent::Recolored, id, m_value[id], m_parent[id]});
+}
+
+// 新插入的红节点与红色父节点冲突时：叔节点为红则变色上移，否则旋转后结束
+void BinaryTreeModel::fixRedBlackInsert(int z) {
+    while (z != m_root && isRed(m_parent[z])) {
+        int p = m_parent[z];
+        int g = m_parent[p];    // 父节点为红，必然不是根
+        bool parentIsLeft = m_left[g] == p;
+        int uncle = parentIsLeft ? m_right[g] : m_left[g];
+        if (isRed(uncle)) {
+            setColor(p, Black);
+            setColor(uncle, Black);
+            setColor(g, Red);
+            z = g;
+            continue;
+        }
+        if (z == (parentIsLeft ? m_right[p] : m_left[p])) {
+            rotateUp(z);    // 内侧的情况先转成外侧
+            std::swap(z, p);
+        }
+        setColor(p, Black);
+        setColor(g, Red);
+        rotateUp(p);
+    }
+    setColor(m_root, Black);
+}
+
+// 删除黑节点后，顶替位置的 x 多带一层“黑色”，按兄弟节点的颜色分情况旋转或上移
+void BinaryTreeModel::fixRedBlackRemove(int x, int xParent) {
+    while (x != m_root && !isRed(x)) {
+        int p = x != npos ? m_parent[x] : xParent;
+        if (x == m_left[p]) {
+            int w = m_right[p];
+            if (isRed(w)) {
+                setColor(w, Black);
+                setColor(p, Red);
+                rotateUp(w);
+                w = m_right[p];
+            }
+            if (!isRed(m_left[w]) && !isRed(m_right[w])) {
+                setColor(w, Red);
+                x = p;
+                continue;
+            }
+            if (!isRed(m_right[w])) {
+                setColor(m_left[w], Black);
+                setColor(w, Red);
+                rotateUp(m_left[w]);
+                w = m_right[p];
+            }
+            setColor(w, Color(m_meta[p]));
+            setColor(p, Black);
+            setColor(m_right[w], Black);
+            rotateUp(w);
+        } else {
+            int w = m_left[p];
+            if (isRed(w)) {
+                setColor(w, Black);
+                setColor(p, Red);
+                rotateUp(w);
+                w = m_left[p];
+            }
+            if (!isRed(m_left[w]) && !isRed(m_right[w])) {
+                setColor(w, Red);
+                x = p;
+                continue;
+            }
+            if (!isRed(m_left[w])) {
+                setColor(m_right[w], Black);
+                setColor(w, Red);
+                rotateUp(m_right[w]);
+                w = m_left[p];
+            }
+            setColor(w, Color(m_meta[p]));
+            setColor(p, Black);
+            setColor(m_left[w], Black);
+            rotateUp(w);
+        }
+        x = m_root;
+    }
+    if (x != npos) setColor(x, Black);
+}
+
+// 断开节点与父节点之间的链接
+void BinaryTreeModel::detach(int id) {
+    int p = m_parent[id];
+    if (p == npos) m_root = npos;
+    else if (m_left[p] == id) m_left[p] = npos;
+    else if (m_right[p] == id) m_right[p] = npos;
+    m_parent[id] = npos;
+}
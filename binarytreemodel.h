@@ -0,0 +1,122 @@
+#ifndef BINARYTREEMODEL_H
+#define BINARYTREEMODEL_H
+
+#include "modelsignal.h"
+#include <vector>
+
+// 二叉树变更事件
+struct TreeEvent {
+    enum Type {
+        Inserted,
+        Removed,
+        Cleared,
+        Rotated,    // id 绕父节点旋转下移，parent 为旋转后位于其上方的节点
+        Recolored,  // 红黑树中节点 id 的颜色改变
+        Reset,      // 整棵树被替换（导入），视图按模型重建
+    };
+    Type type;
+    int  id = -1;       // 节点编号（即节点池下标）
+    int  value = 0;     // 节点的值
+    int  parent = -1;   // 父节点编号，根节点为 -1
+    int  slot = -1;     // 层序追加时节点在完全二叉树中的槽位，其他方式插入时为 -1
+    int  anchor = -1;   // Removed：结构发生变化的最深节点（删除叶子时即父节点），其上方的子树形状都可能改变
+};
+
+// 批量操作中的一条操作
+struct TreeOperation {
+    enum Type { AppendLevelOrder, RemoveLastLevelOrder, Clear, InsertKey, RemoveKey };
+    Type type;
+    int  key = 0;       // InsertKey/RemoveKey 的键
+};
+
+// BinaryTreeModel 是不依赖 Qt 的二叉树模型。
+// 节点存放在连续的节点池中（结构数组：值、左右孩子、父节点都用下标表示），
+// 删除的槽位进入空闲链表复用，不存在逐节点的堆分配。
+//
+// 按键操作把节点的值当作键，按二叉搜索树组织，可选 AVL 或红黑树平衡，插入、删除、查找都是 O(log n)。
+// 平衡信息与其他字段一样按节点编号存放（AVL 为子树高度，红黑树为颜色），旋转和变色都以事件报告，
+// 视图据此播放节点移动。删除有两个孩子的节点时把后继节点整体接到被删节点的位置，节点的值不会互换。
+// 按键操作要求树本身满足二叉搜索树性质，不要与层序追加混用。
+class BinaryTreeModel
+{
+public:
+    static constexpr int npos = -1;
+    enum Side { Left, Right };
+    enum Balancing { Unbalanced, Avl, RedBlack };    // 按键操作的平衡策略
+
+    int  insertChild(int parentId, Side side, int value);  // 把新节点挂到 parentId 的一侧，parentId 为 npos 时作为根
+    bool removeLeaf(int id);        // 删除叶子节点
+    int  appendLevelOrder();        // 按层序在完全二叉树末尾追加节点，值自动递增
+    int  appendLevelOrderValue(int value);  // 按层序追加指定值的节点
+    int  removeLastLevelOrder();    // 删除完全二叉树的末尾节点，返回其编号，树空时返回 npos
+    void clear();                   // 清空二叉树并重置自动编号
+    // 与 staged 交换整棵树（含平衡策略），只广播一次 Reset。staged 在工作线程中构建，不能有订阅者
+    void adopt(BinaryTreeModel& staged);
+
+    // 一个节点的值和父子关系，用来让另一线程中的副本跟上本模型的结构变化
+    struct Link {
+        int  id;
+        int  value;
+        int  left, right, parent;
+        bool alive;
+    };
+    Link link(int id) const { return Link{id, m_value[id], m_left[id], m_right[id], m_parent[id], m_alive[id] != 0}; }
+    // 把节点池调整为 capacity 个槽位，按顺序覆盖 links 中的节点并设置根，不广播事件。
+    // 只维护结构（值、父子关系、存活标记），平衡信息、空闲链表和层序记录不随之更新，
+    // 打过补丁的模型只用于读取（例如布局），不要再对它做增删
+    void applyLinks(const std::vector<Link>& links, int root, int capacity);
+
+    void setBalancing(Balancing b); // 清空二叉树并切换平衡策略
+    Balancing balancing() const { return m_balancing; }
+    int  insertKey(int key);        // 按键插入并按需旋转，返回新节点编号；键已存在时返回 npos
+    bool removeKey(int key);        // 按键删除，键不存在时返回 false
+    int  find(int key) const;       // 按键查找，返回节点编号，找不到时返回 npos
+
+    // 批量接口：先把所有修改作用到模型上，视图在下一帧只做一次布局
+    void appendLevelOrder(int count);                       // 按层序连续追加 count 个节点
+    int  apply(const std::vector<TreeOperation>& ops);      // 依次执行操作列表，返回成功执行的条数
+
+    int  root() const { return m_root; }
+    int  left(int id) const { return m_left[id]; }
+    int  right(int id) const { return m_right[id]; }
+    int  parent(int id) const { return m_parent[id]; }
+    int  value(int id) const { return m_value[id]; }
+    bool isRed(int id) const { return id != npos && m_meta[id] == Red; }   // 红黑树模式下节点的颜色
+    int  height(int id) const { return id == npos ? 0 : m_meta[id]; }      // AVL 模式下的子树高度，叶子为 1
+    bool isValid(int id) const { return id >= 0 && id < capacity() && m_alive[id]; }
+    int  size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    int  capacity() const { return static_cast<int>(m_value.size()); }
+    const std::vector<int>& levelOrder() const { return m_levelOrder; }  // 层序追加的节点，下标即槽位
+
+    ModelSignal<TreeEvent>& changes() { return m_changes; }
+
+private:
+    friend class MorrisCursor;      // Morris 遍历需要临时改写右孩子链接（线索）
+
+    enum Color : signed char { Black = 0, Red = 1 };
+
+    int  allocate(int value);
+    void release(int id);
+    void detach(int id);
+    void transplant(int u, int v);  // 用 v 顶替 u 在其父节点下的位置
+    void rotateUp(int x);           // 把 x 旋转到其父节点的位置
+    void updateHeight(int id);
+    void rebalanceAvl(int from);    // 从 from 向上逐个恢复 AVL 平衡
+    void setColor(int id, Color c);
+    void fixRedBlackInsert(int z);
+    void fixRedBlackRemove(int x, int xParent);
+
+    std::vector<int>  m_value, m_left, m_right, m_parent;
+    std::vector<signed char> m_meta;    // AVL：子树高度；红黑树：颜色
+    std::vector<char> m_alive;
+    std::vector<int>  m_free;           // 空闲槽位
+    std::vector<int>  m_levelOrder;     // 完全二叉树模式下按槽位记录节点编号
+    int m_root = npos;
+    int m_size = 0;
+    int nextValue = 1;
+    Balancing m_balancing = Unbalanced;
+    ModelSignal<TreeEvent> m_changes;
+};
+
+#endif
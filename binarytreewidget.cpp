@@ -1,28 +1,40 @@
 #include "BinaryTreeWidget.h"
 #include "NodeItem.h"
+#include "loditems.h"
+#include "animationscheduler.h"
 
+#include <QApplication>
 #include <QGraphicsScene>
 #include <QGraphicsView>
-#include <QGraphicsLineItem>
 #include <QVBoxLayout>
 #include <QPushButton>
 #include <QHBoxLayout>
-#include <QPropertyAnimation>
+#include <QComboBox>
+#include <QLineEdit>
 #include <QMessageBox>
-#include <QTimer>
 #include <QPen>
 #include <QPainter>
+#include <QSignalBlocker>
+#include <QScrollBar>
+#include <QStyleOptionGraphicsItem>
 #include <cmath>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
 
 // BinaryTreeWidget 构造函数
 BinaryTreeWidget::BinaryTreeWidget(QWidget* parent)
-    : QWidget(parent), nextNodeId(1)
+    : QWidget(parent), positions(std::make_shared<TreeLayoutBuffer>())
 {
     // 创建并设置主布局
     auto *mainLayout = new QVBoxLayout(this);
 
     // 初始化 QGraphicsScene 和 QGraphicsView
     scene = new QGraphicsScene(this);
+    pool = std::make_unique<NodeItemPool>(scene);
     view  = new QGraphicsView(scene, this);
     view->setRenderHint(QPainter::Antialiasing);  // 启用抗锯齿
     view->setDragMode(QGraphicsView::ScrollHandDrag);  // 设置拖动模式
@@ -32,131 +44,631 @@ BinaryTreeWidget::BinaryTreeWidget(QWidget* parent)
 
     // 创建并设置控制按钮布局
     auto *hlay = new QHBoxLayout;
+    modeBox = new QComboBox(this);
+    modeBox->addItems({"完全二叉树", "二叉搜索树", "AVL树", "红黑树"});
     addButton    = new QPushButton("添加节点", this);
     removeButton = new QPushButton("删除末尾节点", this);
+    keyEdit = new QLineEdit(this);  // 输入框，用于指定键
+    keyEdit->setPlaceholderText("键");
+    insertKeyButton  = new QPushButton("插入", this);
+    removeKeyButton  = new QPushButton("删除", this);
+    findKeyButton    = new QPushButton("查找", this);
+    randomKeysButton = new QPushButton("随机插入20个", this);
     clearButton  = new QPushButton("清空", this);
+    benchButton  = new QPushButton("性能测试", this);
+    hlay->addWidget(modeBox);
     hlay->addWidget(addButton);
     hlay->addWidget(removeButton);
+    hlay->addWidget(keyEdit);
+    hlay->addWidget(insertKeyButton);
+    hlay->addWidget(removeKeyButton);
+    hlay->addWidget(findKeyButton);
+    hlay->addWidget(randomKeysButton);
     hlay->addWidget(clearButton);
+    hlay->addWidget(benchButton);
     mainLayout->addLayout(hlay);  // 添加按钮布局到主布局
+    importBar = new ImportBar(this);    // 从 CSV 或二进制文件批量导入
+    importBar->setJobFactory([this]() { return makeImportJob(); });
+    mainLayout->addWidget(importBar);
 
     // 连接按钮的点击信号到相应槽函数
     connect(addButton, &QPushButton::clicked, this, &BinaryTreeWidget::onAddNode);
     connect(removeButton, &QPushButton::clicked, this, &BinaryTreeWidget::onRemoveNode);
     connect(clearButton, &QPushButton::clicked, this, &BinaryTreeWidget::onClear);
+    connect(modeBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &BinaryTreeWidget::onModeChanged);
+    connect(insertKeyButton, &QPushButton::clicked, this, &BinaryTreeWidget::onInsertKey);
+    connect(removeKeyButton, &QPushButton::clicked, this, &BinaryTreeWidget::onRemoveKey);
+    connect(findKeyButton, &QPushButton::clicked, this, &BinaryTreeWidget::onFindKey);
+    connect(randomKeysButton, &QPushButton::clicked, this, &BinaryTreeWidget::onRandomKeys);
+    connect(benchButton, &QPushButton::clicked, this, &BinaryTreeWidget::onBenchmark);
+    connect(keyEdit, &QLineEdit::returnPressed, this, &BinaryTreeWidget::onInsertKey);
+    searchChannel = AnimationScheduler::instance().newChannel();
 
-    // 设置场景大小
-    scene->setSceneRect(0, 0, 800, 500);
+    batcher = new SceneBatcher(scene, [this]() { updateScene(); }, this);
+    batcher->setItemPool(pool.get());   // 淡出结束的节点归还图元池
+    overview = new AggregateBlockItem;  // 极度缩小时代替节点绘制的聚合色块
+    scene->addItem(overview);
+    edges = new EdgeLayerItem;  // 所有连线由一个图元批量绘制
+    scene->addItem(edges);
+
+    // 布局结果在工作线程中交出，转到界面线程处理
+    layoutWorker = std::make_unique<TreeLayoutWorker>(NodeSeparation,
+        [this](std::shared_ptr<const TreeLayoutBuffer> result) {
+            QMetaObject::invokeMethod(this, [this, result]() { onLayoutReady(result); }, Qt::QueuedConnection);
+        });
+
+    // 拖动平移时把图元重新绑定到视口内的节点
+    connect(view->horizontalScrollBar(), &QScrollBar::valueChanged, this, &BinaryTreeWidget::bindVisible);
+    connect(view->verticalScrollBar(),   &QScrollBar::valueChanged, this, &BinaryTreeWidget::bindVisible);
+
+    // 订阅模型变更，所有图元都由模型事件驱动
+    model.changes().subscribe([this](const TreeEvent& e) { onModelChanged(e); });
+
+    // 场景范围随布局增长，空树时也保留一块初始区域
+    updateSceneRect();
+    onModeChanged(0);
 }
 
 // 添加节点的槽函数
 void BinaryTreeWidget::onAddNode() {
-    // 创建一个新的节点
-    NodeItem* node = new NodeItem(nextNodeId++, nullptr);
-    node->setOpacity(0.0);  // 初始时设置节点的透明度为 0（不可见）
-    treeNodes.push_back(node);  // 将新节点添加到节点列表
-    scene->addItem(node);  // 将节点添加到场景中
-    animateNodeInsertion(node);  // 执行节点插入动画
-    updateScene();  // 更新场景布局
+    model.appendLevelOrder();  // 按层序追加节点，图元由 onModelChanged 创建
 }
 
 // 删除末尾节点的槽函数
 void BinaryTreeWidget::onRemoveNode() {
-    if (treeNodes.empty()) {
+    if (model.empty()) {
         // 如果树为空，显示提示信息
         QMessageBox::information(this, "提示", "二叉树为空！");
         return;
     }
-    // 获取末尾节点并执行删除动画
-    NodeItem* node = treeNodes.back();
-    animateNodeDeletion(node, [this]() { updateScene(); });
-    treeNodes.pop_back();  // 从节点列表中移除末尾节点
+    model.removeLastLevelOrder();
 }
 
 // 清空二叉树的槽函数
 void BinaryTreeWidget::onClear() {
-    // 删除所有节点
-    for (auto node : treeNodes) {
-        scene->removeItem(node);  // 从场景中移除节点
-        delete node;  // 删除节点
+    model.clear();
+}
+
+// 下拉框的顺序与 BinaryTreeModel::Balancing 一致，第 0 项为完全二叉树
+void BinaryTreeWidget::onModeChanged(int index) {
+    enableModeControls(index);
+    model.setBalancing(index > 0 ? BinaryTreeModel::Balancing(index - 1) : BinaryTreeModel::Unbalanced);
+}
+
+void BinaryTreeWidget::enableModeControls(int index) {
+    bool keyed = index > 0;
+    addButton->setEnabled(!keyed);
+    removeButton->setEnabled(!keyed);
+    keyEdit->setEnabled(keyed);
+    insertKeyButton->setEnabled(keyed);
+    removeKeyButton->setEnabled(keyed);
+    findKeyButton->setEnabled(keyed);
+    randomKeysButton->setEnabled(keyed);
+}
+
+bool BinaryTreeWidget::readKey(int& key) {
+    bool ok;
+    key = keyEdit->text().toInt(&ok);
+    if (!ok) QMessageBox::warning(this, "输入错误", "请输入整数键！");
+    return ok;
+}
+
+void BinaryTreeWidget::onInsertKey() {
+    int key;
+    if (!readKey(key)) return;
+    clearSearch();
+    if (model.insertKey(key) == BinaryTreeModel::npos)
+        QMessageBox::information(this, "提示", "该键已存在！");
+}
+
+void BinaryTreeWidget::onRemoveKey() {
+    int key;
+    if (!readKey(key)) return;
+    clearSearch();
+    if (!model.removeKey(key))
+        QMessageBox::warning(this, "错误", "未找到该键！");
+}
+
+void BinaryTreeWidget::onRandomKeys() {
+    static std::mt19937 rng(std::random_device{}());
+    std::uniform_int_distribution<int> dist(1, 999);
+    clearSearch();
+    for (int inserted = 0, tries = 0; inserted < 20 && tries < 1000; ++tries)
+        inserted += model.insertKey(dist(rng)) != BinaryTreeModel::npos;
+}
+
+// 在不挂监听器的模型上测量，三种策略和 std::map 使用同一组键：打乱的随机键，以及升序的有序键。
+// 有序键让二叉搜索树退化成链，每次操作 O(n)，因此有序键取得较少
+void BinaryTreeWidget::onBenchmark() {
+    const int randomCount = 200000, sortedCount = 20000;
+    std::vector<int> shuffled(randomCount);
+    std::iota(shuffled.begin(), shuffled.end(), 0);
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(42));
+    std::vector<int> sorted(sortedCount);
+    std::iota(sorted.begin(), sorted.end(), 0);
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+
+    // 从根开始逐层计数，得到树高（空树为 0）
+    auto treeHeight = [](const BinaryTreeModel& tree) {
+        std::vector<int> level, below;
+        if (tree.root() != BinaryTreeModel::npos) level.push_back(tree.root());
+        int height = 0;
+        for (; !level.empty(); ++height) {
+            below.clear();
+            for (int v : level) {
+                if (tree.left(v) != BinaryTreeModel::npos) below.push_back(tree.left(v));
+                if (tree.right(v) != BinaryTreeModel::npos) below.push_back(tree.right(v));
+            }
+            level.swap(below);
+        }
+        return height;
+    };
+
+    QString report = "单位为百万次/秒\n";
+    QElapsedTimer clock;
+    int misses = 0;
+    for (const std::vector<int>* keys : {&shuffled, &sorted}) {
+        const int n = static_cast<int>(keys->size());
+        auto rate = [n](qint64 ns) { return QString::number(n * 1000.0 / std::max<qint64>(1, ns), 'f', 2); };
+        report += QString("\n%1：%2 个键\n\t\t高度\t插入\t查找\t删除\n")
+                      .arg(keys == &shuffled ? "随机键" : "有序键").arg(n);
+        const std::pair<BinaryTreeModel::Balancing, const char*> modes[] = {
+            {BinaryTreeModel::Unbalanced, "二叉搜索树"}, {BinaryTreeModel::Avl, "AVL 树"},
+            {BinaryTreeModel::RedBlack, "红黑树"}};
+        for (auto [balancing, name] : modes) {
+            BinaryTreeModel bench;
+            bench.setBalancing(balancing);
+            clock.start();
+            for (int k : *keys) bench.insertKey(k);
+            qint64 insertNs = clock.nsecsElapsed();
+            int height = treeHeight(bench);
+            clock.start();
+            for (int k : *keys) misses += bench.find(k) == BinaryTreeModel::npos;
+            qint64 findNs = clock.nsecsElapsed();
+            clock.start();
+            for (int k : *keys) misses += !bench.removeKey(k);
+            qint64 removeNs = clock.nsecsElapsed();
+            report += QString("%1\t%2\t%3\t%4\t%5\n").arg(name).arg(height)
+                          .arg(rate(insertNs), rate(findNs), rate(removeNs));
+        }
+
+        std::map<int, int> reference;
+        clock.start();
+        for (int k : *keys) reference.emplace(k, k);
+        qint64 insertNs = clock.nsecsElapsed();
+        clock.start();
+        for (int k : *keys) misses += reference.count(k) == 0;
+        qint64 findNs = clock.nsecsElapsed();
+        clock.start();
+        for (int k : *keys) reference.erase(k);
+        qint64 removeNs = clock.nsecsElapsed();
+        report += QString("std::map\t\t%1\t%2\t%3\n").arg(rate(insertNs), rate(findNs), rate(removeNs));
     }
-    treeNodes.clear();  // 清空节点列表
-    nextNodeId = 1;  // 重置节点ID
-    updateScene();  // 更新场景
+    if (misses) report += QString("\n校验失败：%1 个键未找到").arg(misses);
+
+    QApplication::restoreOverrideCursor();
+    QMessageBox::information(this, "性能测试", report);
 }
 
-// 更新场景的函数，重新布局所有节点和连线
-void BinaryTreeWidget::updateScene() {
-    // 清除旧的连线
-    QList<QGraphicsItem*> items = scene->items();
-    for (auto it = items.begin(); it != items.end(); ++it) {
-        if (!dynamic_cast<NodeItem*>(*it)) {
-            scene->removeItem(*it);  // 删除非节点项
-            delete *it;  // 释放内存
+// 沿查找路径逐个点亮节点，命中的节点为绿色，一段时间后恢复
+void BinaryTreeWidget::onFindKey() {
+    int key;
+    if (!readKey(key)) return;
+    clearSearch();
+    if (model.find(key) == BinaryTreeModel::npos) {
+        QMessageBox::warning(this, "错误", "未找到该键！");
+        return;
+    }
+    for (int v = model.root(); v != BinaryTreeModel::npos;
+         v = key < model.value(v) ? model.left(v) : model.right(v)) {
+        searchPath.emplace_back(v, items[v]);
+        if (model.value(v) == key) break;
+    }
+    auto& scheduler = AnimationScheduler::instance();
+    auto next = std::make_shared<size_t>(0);
+    scheduler.every(searchChannel, 400, [this, next]() {
+        auto [id, node] = searchPath[*next];
+        bool last = ++*next == searchPath.size();
+        if (node && items[id] == node) node->setColors(last ? QColor(0, 160, 0) : QColor(255, 140, 0), Qt::white);
+        if (last) AnimationScheduler::instance().after(searchChannel, 1500, [this]() { clearSearch(); });
+        return !last;
+    });
+}
+
+void BinaryTreeWidget::clearSearch() {
+    AnimationScheduler::instance().cancel(searchChannel);
+    for (auto [id, node] : searchPath) {
+        if (node && id < static_cast<int>(items.size()) && items[id] == node) node->setColors(nodeColor(id), Qt::white);
+    }
+    searchPath.clear();
+}
+
+QColor BinaryTreeWidget::nodeColor(int id) const {
+    if (model.balancing() != BinaryTreeModel::RedBlack) return Qt::blue;
+    return model.isRed(id) ? QColor(200, 30, 30) : QColor(30, 30, 30);
+}
+
+// 模型变更后同步图元：只有已绑定图元的节点立即响应，其余节点等布局结果到达后按视口绑定
+void BinaryTreeWidget::onModelChanged(const TreeEvent& e) {
+    switch (e.type) {
+    case TreeEvent::Inserted: {
+        // 新节点先放在父节点当前的位置并连线，布局结果到达后与其他节点一起移到目标位置；
+        // 父节点没有图元（不在视口附近）时不建图元
+        positionsCurrent = false;
+        if (e.id >= static_cast<int>(items.size())) {
+            items.resize(e.id + 1, nullptr);
+            edgeOf.resize(e.id + 1, -1);
         }
+        layoutChanges.nodeInserted(model, e.id);    // 只标记新节点到根的路径
+        int parent = model.parent(e.id);
+        if (parent != BinaryTreeModel::npos && !items[parent]) {
+            batcher->requestLayout();
+            break;
+        }
+        NodeItem* node = pool->acquire(e.value);  // 优先复用已淡出回收的图元
+        items[e.id] = node;
+        boundIds.push_back(e.id);
+        node->setColors(nodeColor(e.id), Qt::white);
+        node->setPos(parent != BinaryTreeModel::npos ? items[parent]->pos() : QPointF(-R, 0));
+        if (parent != BinaryTreeModel::npos) addEdge(e.id);
+        syncRoot();     // 空树中插入的第一个节点成为根
+        batcher->fadeIn(node);  // 执行节点插入动画，同一帧内的插入只提交一次布局
+        break;
+    }
+    case TreeEvent::Removed: {
+        // 连线立即删除，其余节点在布局结果到达后移动到新位置，被删节点在原处淡出
+        positionsCurrent = false;
+        NodeItem* node = items[e.id];
+        removeEdge(e.id);
+        items[e.id] = nullptr;
+        if (shownRoot == e.id) shownRoot = BinaryTreeModel::npos;
+        syncRoot();     // 后继节点可能被接到根的位置
+        layoutChanges.nodeRemoved(model, e.id, e.anchor);
+        if (node) batcher->fadeOut(node);
+        batcher->requestLayout();
+        break;
+    }
+    case TreeEvent::Rotated:
+        // 连线按子节点记录，旋转后只需处理根的变化，几何随节点移动逐帧刷新
+        positionsCurrent = false;
+        syncRoot();
+        layoutChanges.invalidate(model, e.id);
+        batcher->requestLayout();
+        break;
+    case TreeEvent::Recolored:
+        if (items[e.id]) items[e.id]->setColors(nodeColor(e.id), Qt::white);
+        break;
+    case TreeEvent::Cleared:
+        discardItems();
+        updateScene();  // 布局线程随之清空
+        updateSceneRect();
+        break;
+    case TreeEvent::Reset:
+        // 整棵树被替换：导入时布局已在工作线程中算好，直接换入；
+        // 不经导入换入时（界面中没有这种用法）在这里整体布局。布局线程随后按新树重建增量布局的状态。
+        // 只为视口附近的节点创建图元，换入的耗时与节点数无关
+        discardItems();
+        if (staged) positions = std::move(staged->positions);
+        else positions = TreeLayoutWorker::layoutWhole(model, NodeSeparation);
+        updateScene();
+        items.assign(model.capacity(), nullptr);
+        edgeOf.assign(model.capacity(), -1);
+        shownRoot = model.root();
+        updateOverview(positions->changedBlocks);
+        updateSceneRect();
+        bindVisible();
+        break;
+    }
+}
+
+// 模型已清空或被替换，先丢掉引用节点编号的待办，再结束进行中的动画（淡出中的节点随之删除）。
+// 布局线程中的状态整体作废，还在路上的结果按编号识别为过期
+void BinaryTreeWidget::discardItems() {
+    ++layoutGeneration;
+    layoutChanges.invalidateAll();
+    positions = std::make_shared<TreeLayoutBuffer>();
+    positionsCurrent = true;    // 模型已清空，或随后换入与新树一致的布局
+    staleMoved.clear();
+    staleBlocks.clear();
+    overview->setBlocks({});
+    moves.clear();
+    batcher->finishAll();
+    moveRunning = false;   // finishAll 已丢弃挂起的移动步骤
+    // 回收所有绑定的图元
+    for (int id : boundIds) {
+        if (id >= static_cast<int>(items.size()) || !items[id]) continue;
+        pool->release(items[id]);
+        items[id] = nullptr;
     }
+    boundIds.clear();
+    items.clear();
+    searchPath.clear();
+    AnimationScheduler::instance().cancel(searchChannel);
+    shownRoot = BinaryTreeModel::npos;
+    edgeOf.clear();
+    edgeChild.clear();
+    edges->clear();  // 删除所有连线
+}
 
-    // 获取当前树的节点数
-    int n = treeNodes.size();
-    const qreal W = 800;  // 场景宽度
-    const qreal levelGap = 100;  // 节点之间的垂直间距
-    const qreal R = 20;  // 节点半径
-
-    // 布局所有节点
-    for (int i = 0; i < n; i++) {
-        int level = static_cast<int>(std::floor(std::log2(i + 1)));  // 计算节点所在层级
-        int idx = i - ((1 << level) - 1);  // 当前层级的索引
-        int count = 1 << level;  // 当前层级的节点数
-        qreal xGap = W / (count + 1.0);  // 计算横向间距
-        qreal x = xGap * (idx + 1) - R;  // 计算节点的横坐标
-        qreal y = level * levelGap;  // 计算节点的纵坐标
-        treeNodes[i]->setPos(x, y);  // 设置节点位置
-    }
-
-    // 绘制父子节点之间的连线
-    for (int i = 0; i < n; i++) {
-        int left  = 2*i + 1;  // 左子节点索引
-        int right = 2*i + 2;  // 右子节点索引
-        QPointF pc = treeNodes[i]->pos() + QPointF(R, R);  // 父节点中心点
-
-        // lambda 表达式，绘制父节点与子节点之间的连线
-        auto drawEdge = [&](int childIdx) {
-            if (childIdx < n) {
-                QPointF cc = treeNodes[childIdx]->pos() + QPointF(R, R);  // 子节点中心点
-                qreal ang = std::atan2(cc.y() - pc.y(), cc.x() - pc.x());  // 计算父子节点的角度
-                QPointF pEdge = pc  + QPointF(std::cos(ang)*R, std::sin(ang)*R);  // 父节点连线起点
-                QPointF cEdge = cc  - QPointF(std::cos(ang)*R, std::sin(ang)*R);  // 子节点连线终点
-                QGraphicsLineItem* edge = new QGraphicsLineItem(QLineF(pEdge, cEdge));  // 创建连线项
-                edge->setPen(QPen(Qt::black, 2));  // 设置线条颜色和粗细
-                scene->addItem(edge);  // 添加连线到场景中
+// 导入在工作线程中按当前模式填充暂存的树：完全二叉树按层序追加，其余模式按键插入（重复的键被跳过）。
+// 数据读完后整体布局
+ImportJob BinaryTreeWidget::makeImportJob() {
+    auto staging = std::make_shared<ImportStaging>();
+    int mode = modeBox->currentIndex();
+    staging->model.setBalancing(model.balancing());
+    ImportJob job;
+    job.consume = [staging, mode](const int* values, std::size_t count, std::string& error) {
+        BinaryTreeModel& tree = staging->model;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (mode == 0) tree.appendLevelOrderValue(values[i]);
+            else tree.insertKey(values[i]);
+            if (tree.size() > MaxImportNodes) {
+                error = "二叉树视图最多导入 " + std::to_string(MaxImportNodes) + " 个节点";
+                return false;
             }
-        };
-        drawEdge(left);  // 绘制左子节点连线
-        drawEdge(right);  // 绘制右子节点连线
-    }
-}
-
-// 节点插入动画
-void BinaryTreeWidget::animateNodeInsertion(NodeItem* node) {
-    // 创建一个节点插入的动画
-    auto *anim = new QPropertyAnimation(node, "opacity");
-    anim->setDuration(500);  // 动画持续时间 500ms
-    anim->setStartValue(0.0);  // 动画开始时透明度为 0
-    anim->setEndValue(1.0);  // 动画结束时透明度为 1
-    anim->start(QAbstractAnimation::DeleteWhenStopped);  // 动画结束时删除动画对象
-}
-
-// 节点删除动画
-void BinaryTreeWidget::animateNodeDeletion(NodeItem* node, std::function<void()> callback) {
-    // 创建一个节点删除的动画
-    auto *anim = new QPropertyAnimation(node, "opacity");
-    anim->setDuration(500);  // 动画持续时间 500ms
-    anim->setStartValue(1.0);  // 动画开始时透明度为 1
-    anim->setEndValue(0.0);  // 动画结束时透明度为 0
-    connect(anim, &QPropertyAnimation::finished, this, [=]() {
-        scene->removeItem(node);  // 动画结束后从场景中移除节点
-        delete node;  // 删除节点
-        if (callback) callback();  // 调用回调函数
-    });
-    anim->start(QAbstractAnimation::DeleteWhenStopped);  // 动画结束时删除动画对象
+        }
+        return true;
+    };
+    job.prepare = [staging]() {
+        staging->positions = TreeLayoutWorker::layoutWhole(staging->model, NodeSeparation);
+    };
+    job.commit = [this, staging, mode]() {
+        clearSearch();
+        if (modeBox->currentIndex() != mode) {
+            // 导入期间切换了模式：恢复导入时的模式，换入的树自带对应的平衡策略
+            QSignalBlocker block(modeBox);
+            modeBox->setCurrentIndex(mode);
+            enableModeControls(mode);
+        }
+        staged = staging.get();
+        model.adopt(staging->model);
+        staged = nullptr;
+    };
+    return job;
+}
+
+void BinaryTreeWidget::showEvent(QShowEvent* ev) {
+    QWidget::showEvent(ev);
+    bindVisible();
+}
+
+void BinaryTreeWidget::resizeEvent(QResizeEvent* ev) {
+    QWidget::resizeEvent(ev);
+    bindVisible();
+}
+
+// 视口（四周外扩 viewMargin）内的节点由布局结果中各层从左到右的顺序二分找出，只为这些节点绑定图元，
+// 其余图元隐藏后放回图元池；正在移动的图元等移动结束后再回收。
+// 相邻两层之间的连线互不交叉，两端的横坐标都随孩子的顺序递增，与范围相交的连线在孩子的顺序中也连成一段。
+// 模型变更后、布局结果到达前坐标与树对不上，此时不重新绑定，等采用结果时再绑定
+void BinaryTreeWidget::bindVisible() {
+    if (!positionsCurrent) return;
+    const TreeLayoutBuffer& lay = *positions;
+    if (bindMark.size() < items.size()) bindMark.resize(items.size(), 0);
+    ++bindRound;
+
+    QRectF vis = view->mapToScene(view->viewport()->rect()).boundingRect()
+                     .adjusted(-viewMargin, -viewMargin, viewMargin, viewMargin);
+    // 极度缩小时节点和连线都不绘制，由聚合色块代替，不绑定任何图元
+    bool aggregated = QStyleOptionGraphicsItem::levelOfDetailFromTransform(view->transform()) < Lod::Aggregate;
+    int levelCount = aggregated ? 0 : std::max(0, static_cast<int>(lay.levelStart.size()) - 1);
+    const int* order = lay.levels.data();
+
+    std::vector<int> next;
+    auto keep = [&](int id) {
+        if (bindMark[id] == bindRound) return;
+        bindMark[id] = bindRound;
+        next.push_back(id);
+    };
+    for (int d = 0; d < levelCount; ++d) {
+        qreal top = d * LevelGap;
+        if (top > vis.bottom()) break;
+        if (top + 2 * R < vis.top()) continue;
+        const int* end = order + lay.levelStart[d + 1];
+        const int* first = std::partition_point(order + lay.levelStart[d], end,
+                                                [&](int id) { return lay.x[id] + R < vis.left(); });
+        const int* last = std::partition_point(first, end, [&](int id) { return lay.x[id] - R <= vis.right(); });
+        for (const int* p = first; p != last; ++p) keep(*p);
+    }
+    for (const Move& m : moves)
+        if (items[m.id] == m.item) keep(m.id);
+
+    // 回收离开范围的图元，已删除或重复的编号直接跳过
+    for (int id : boundIds) {
+        if (id >= static_cast<int>(items.size()) || !items[id] || bindMark[id] == bindRound) continue;
+        pool->release(items[id]);
+        items[id] = nullptr;
+    }
+    // 为范围内还没有图元的节点绑定图元，直接放在布局位置
+    for (int id : next) {
+        if (items[id]) continue;
+        NodeItem* node = pool->acquire(model.value(id));
+        node->setColors(nodeColor(id), Qt::white);
+        node->setPos(nodePos(id));
+        items[id] = node;
+    }
+    boundIds.swap(next);
+
+    // 连线整体换成与范围相交的几条；移出范围但还在移动的节点保留连向父节点的连线
+    for (int child : edgeChild) edgeOf[child] = -1;
+    edgeChild.clear();
+    edges->clear();
+    for (int d = 1; d < levelCount; ++d) {
+        if ((d - 1) * LevelGap > vis.bottom()) break;
+        if (d * LevelGap + 2 * R < vis.top()) continue;
+        auto lo = [&](int c) { return std::min(lay.x[c], lay.x[model.parent(c)]); };
+        auto hi = [&](int c) { return std::max(lay.x[c], lay.x[model.parent(c)]); };
+        const int* end = order + lay.levelStart[d + 1];
+        const int* first = std::partition_point(order + lay.levelStart[d], end,
+                                                [&](int c) { return hi(c) + R < vis.left(); });
+        const int* last = std::partition_point(first, end, [&](int c) { return lo(c) - R <= vis.right(); });
+        for (const int* p = first; p != last; ++p) addEdge(*p);
+    }
+    for (int id : boundIds)
+        if (model.parent(id) != BinaryTreeModel::npos && edgeOf[id] < 0) addEdge(id);
+}
+
+// 把这段时间的结构变更连同相关节点的父子关系交给布局线程，界面不等待结果。
+// 还没开始计算的上一次提交会被这一次合并，不再单独计算
+void BinaryTreeWidget::updateScene() {
+    if (layoutChanges.empty()) return;
+    layoutWorker->submit(++layoutGeneration, layoutChanges.take(model));
+}
+
+// 只采用与模型当前的树一致的结果：之后又提交过布局、或者还有没提交的变更时，结果已经过期，
+// 其中移动过的节点先记下，随采用的结果一起移到最终位置。
+// 新节点从父节点的位置、已有节点从当前位置平移过去，连线跟随移动
+void BinaryTreeWidget::onLayoutReady(std::shared_ptr<const TreeLayoutBuffer> result) {
+    staleMoved.insert(staleMoved.end(), result->moved.begin(), result->moved.end());
+    staleBlocks.insert(staleBlocks.end(), result->changedBlocks.begin(), result->changedBlocks.end());
+    if (result->generation != layoutGeneration || !layoutChanges.empty()) return;
+    positions = std::move(result);
+    positionsCurrent = true;
+
+    // 正在移动的节点从当前位置重新出发；目标变化的节点加入或改写移动终点。
+    // moveSlot 按编号记录节点在 next 中的下标，用完后只复位用过的位置
+    if (moveSlot.size() < items.size()) moveSlot.resize(items.size(), -1);
+    std::vector<Move> next;
+    for (const Move& m : moves) {
+        if (items[m.id] != m.item) continue;
+        moveSlot[m.id] = static_cast<int>(next.size());
+        next.push_back(Move{m.id, m.item, m.item->pos(), m.to});
+    }
+    for (int id : staleMoved) {
+        // 节点已删除，或者编号来自清空之前的结果
+        if (id >= static_cast<int>(items.size()) || id >= static_cast<int>(positions->x.size()) || !items[id]) continue;
+        NodeItem* node = items[id];
+        QPointF target = nodePos(id);
+        int& slot = moveSlot[id];
+        if (node->pos() == target && slot < 0) continue;
+        if (slot >= 0) {
+            next[slot].to = target;
+        } else {
+            slot = static_cast<int>(next.size());
+            next.push_back(Move{id, node, node->pos(), target});
+        }
+    }
+    for (const Move& m : next) moveSlot[m.id] = -1;
+    staleMoved.clear();
+    moves.swap(next);
+    if (!moves.empty()) {
+        moveClock.start();
+        if (!moveRunning) {
+            moveRunning = true;
+            AnimationScheduler::instance().every(batcher->animationChannel(), AnimationScheduler::frameIntervalMs,
+                                                 [this]() { return stepMoves(); });
+        }
+    }
+
+    updateOverview(staleBlocks);
+    staleBlocks.clear();
+    updateSceneRect();
+    bindVisible();  // 新进入视口的节点绑定图元，移出视口的等移动结束后回收
+}
+
+// 场景范围跟随布局的包围盒，至少保留 800×500 的初始区域
+void BinaryTreeWidget::updateSceneRect() {
+    const qreal margin = 40;
+    QRectF bounds(positions->minX - R - margin, -margin,
+                  positions->maxX - positions->minX + 2 * R + 2 * margin,
+                  std::max(0, positions->height) * LevelGap + 2 * R + 2 * margin);
+    scene->setSceneRect(bounds.united(QRectF(-400, -margin, 800, 500)));
+}
+
+// 线性插值推进所有移动，每帧只刷新移动节点自身及其孩子的连线
+bool BinaryTreeWidget::stepMoves() {
+    qreal t = std::min<qreal>(1.0, qreal(moveClock.elapsed()) / MoveDurationMs);
+    for (const Move& m : moves) {
+        if (items[m.id] != m.item) continue;
+        m.item->setPos(m.from + (m.to - m.from) * t);
+    }
+    for (const Move& m : moves) {
+        if (items[m.id] != m.item) continue;
+        refreshEdge(m.id);
+        refreshEdge(model.left(m.id));
+        refreshEdge(model.right(m.id));
+    }
+    edges->commitMoves();
+    if (t < 1.0) return true;
+    moves.clear();
+    moveRunning = false;
+    bindVisible();  // 回收移出视口的图元
+    return false;
+}
+
+// 布局横坐标是节点中心，纵坐标按深度分层
+QPointF BinaryTreeWidget::nodePos(int id) const {
+    return QPointF(positions->x[id] - R, positions->depth[id] * LevelGap);
+}
+
+// 没有图元的一端取布局位置，还不在布局中的编号放在初始位置
+QPointF BinaryTreeWidget::shownPos(int id) const {
+    if (items[id]) return items[id]->pos();
+    if (id < static_cast<int>(positions->x.size())) return nodePos(id);
+    return QPointF(-R, 0);
+}
+
+// 父节点与 child 之间的连线，两端各缩进一个半径
+QLineF BinaryTreeWidget::edgeLine(int child) const {
+    QPointF pc = shownPos(model.parent(child)) + QPointF(R, R);  // 父节点中心点
+    QPointF cc = shownPos(child) + QPointF(R, R);  // 子节点中心点
+    qreal ang = std::atan2(cc.y() - pc.y(), cc.x() - pc.x());  // 计算父子节点的角度
+    QPointF pEdge = pc  + QPointF(std::cos(ang)*R, std::sin(ang)*R);  // 父节点连线起点
+    QPointF cEdge = cc  - QPointF(std::cos(ang)*R, std::sin(ang)*R);  // 子节点连线终点
+    return QLineF(pEdge, cEdge);
+}
+
+void BinaryTreeWidget::addEdge(int child) {
+    QLineF line = edgeLine(child);
+    edgeOf[child] = edges->addEdge(line.p1(), line.p2(), 0);  // 树的连线不带箭头
+    edgeChild.push_back(child);
+}
+
+// 用末尾的连线填补被删除连线的位置，边图层保持紧凑
+void BinaryTreeWidget::removeEdge(int child) {
+    int index = edgeOf[child];
+    if (index < 0) return;
+    int last = edges->count() - 1;
+    if (index != last) {
+        int moved = edgeChild[last];
+        QLineF line = edgeLine(moved);
+        edges->setEdge(index, line.p1(), line.p2());
+        edgeOf[moved] = index;
+        edgeChild[index] = moved;
+    }
+    edges->removeLast();
+    edgeChild.pop_back();
+    edgeOf[child] = -1;
+}
+
+void BinaryTreeWidget::syncRoot() {
+    int root = model.root();
+    if (root == shownRoot) return;
+    // 原根的连线只在它或新的父节点有图元时补上
+    int oldParent = shownRoot != BinaryTreeModel::npos ? model.parent(shownRoot) : BinaryTreeModel::npos;
+    if (oldParent != BinaryTreeModel::npos && edgeOf[shownRoot] < 0 && (items[shownRoot] || items[oldParent]))
+        addEdge(shownRoot);
+    if (root != BinaryTreeModel::npos && edgeOf[root] >= 0) removeEdge(root);
+    shownRoot = root;
+}
+
+void BinaryTreeWidget::refreshEdge(int child) {
+    if (child == BinaryTreeModel::npos || edgeOf[child] < 0) return;
+    QLineF line = edgeLine(child);
+    edges->moveEdge(edgeOf[child], line.p1(), line.p2());
+}
+
+// 概览色块由布局线程按层算好，这里只改写变化的色块
+void BinaryTreeWidget::updateOverview(const std::vector<int>& changed) {
+    const auto& blocks = positions->blocks;
+    overview->resizeBlocks(static_cast<int>(blocks.size()));
+    for (int i : changed) {
+        if (i >= static_cast<int>(blocks.size())) continue;     // 色块随后减少了
+        const TreeLayoutBuffer::Block& b = blocks[i];
+        overview->setBlock(i, QRectF(QPointF(b.left - R, b.depth * LevelGap),
+                                     QPointF(b.right + R, b.depth * LevelGap + 2 * R)));
+    }
+    if (positions->height < 0) overview->setBounds(QRectF());
+    else overview->setBounds(QRectF(positions->minX - R, 0, positions->maxX - positions->minX + 2 * R,
+                                    positions->height * LevelGap + 2 * R));
 }
@@ -2,39 +2,137 @@
 #define BINARYTREEWIDGET_H
 
 #include <QWidget>
+#include <QColor>
+#include <QElapsedTimer>
+#include <QLineF>
+#include <utility>
 #include <vector>
 #include "NodeItem.h"
-#include <QGraphicsLineItem>
+#include "binarytreemodel.h"
+#include "treelayoutworker.h"
+#include "scenebatcher.h"
+#include "loditems.h"
+#include "edgelayeritem.h"
+#include "nodeitempool.h"
+#include "importbar.h"
+#include <memory>
 
 class QGraphicsScene;
 class QGraphicsView;
 class QPushButton;
+class QComboBox;
+class QLineEdit;
 
-// BinaryTreeWidget 类用于展示二叉树的可视化控件，提供节点添加、删除、清空等功能
+// BinaryTreeWidget 类用于展示二叉树的可视化控件，提供节点添加、删除、清空等功能。
+// 完全二叉树模式按层序增删末尾节点；二叉搜索树、AVL 树、红黑树模式按键插入、删除、查找，旋转以节点移动的动画呈现。
+// 也可以从文件批量导入：完全二叉树按层序追加，其余模式按键插入。
+// 布局在工作线程中增量计算，界面线程只记录变更、换入算好的坐标并播放节点移动；
+// 只为视口附近的节点绑定图元，拖动平移时重新绑定
 class BinaryTreeWidget : public QWidget
 {
     Q_OBJECT
 public:
     explicit BinaryTreeWidget(QWidget* parent = nullptr);
 
+    // 二叉树模型，可脱离界面直接驱动；控件订阅其变更事件并据此绘制
+    BinaryTreeModel& treeModel() { return model; }
+
+protected:
+    void showEvent(QShowEvent* ev) override;
+    void resizeEvent(QResizeEvent* ev) override;
+
 private slots:
     void onAddNode();   // 插入节点槽函数
     void onRemoveNode();    // 删除节点槽函数
     void onClear(); // 清空二叉树槽函数
+    void onModeChanged(int index);  // 切换模式，清空二叉树
+    void onInsertKey();     // 按键插入
+    void onRemoveKey();     // 按键删除
+    void onFindKey();       // 按键查找并高亮查找路径
+    void onRandomKeys();    // 插入一批随机键
+    void onBenchmark();     // 比较三种平衡策略与 std::map 在随机和有序键上的插入、查找、删除吞吐量
+    void bindVisible();     // 把图元绑定到视口内的节点，回收离开视口的图元，连线只保留与视口相交的
 
 private:
+    static constexpr qreal R = 20;                  // 节点半径
+    static constexpr qreal NodeSeparation = 50;     // 同一层相邻节点中心的最小距离
+    static constexpr qreal LevelGap = 100;          // 相邻两层的垂直间距
+    static constexpr int   MoveDurationMs = 300;    // 重新布局后节点移动到新位置的时长
+    static constexpr int   MaxImportNodes = 1 << 20;    // 布局线程每次交出所有节点的坐标，导入的节点数以此为限
+    static constexpr qreal viewMargin = 400;   // 视口四周各外扩这么宽的场景坐标
+
+    // 导入时在工作线程中构建的树和布局，完成后在 Reset 事件中整体换入
+    struct ImportStaging {
+        BinaryTreeModel model;
+        std::shared_ptr<const TreeLayoutBuffer> positions;
+    };
+
+    // 一个正在移动的节点：图元被删除后 items[id] 不再指向它，移动随之作废
+    struct Move {
+        int       id;
+        NodeItem* item;
+        QPointF   from, to;
+    };
+
     QGraphicsScene* scene;
     QGraphicsView* view;
     QPushButton* addButton;
     QPushButton* removeButton;
     QPushButton* clearButton;
-    std::vector<NodeItem*> treeNodes;    // 存储节点的容器
-    int nextNodeId;
-
+    QComboBox* modeBox;     // 完全二叉树 / 二叉搜索树 / AVL 树 / 红黑树
+    QLineEdit* keyEdit;
+    QPushButton* insertKeyButton;
+    QPushButton* removeKeyButton;
+    QPushButton* findKeyButton;
+    QPushButton* randomKeysButton;
+    QPushButton* benchButton;
+    BinaryTreeModel model;  // 二叉树数据，与图元解耦
+    TreeLayoutChanges layoutChanges;    // 上次提交布局以来的结构变更
+    std::unique_ptr<TreeLayoutWorker> layoutWorker; // 在工作线程中做整齐布局，只重算变化路径上的轮廓
+    std::shared_ptr<const TreeLayoutBuffer> positions;  // 最近采用的布局结果，图元的目标位置
+    bool positionsCurrent = true;       // positions 与模型当前的树一致；不一致时不重新绑定图元
+    long long layoutGeneration = 0;     // 每次提交布局或丢弃图元时加一，用来识别过期的结果
+    std::vector<int> staleMoved;        // 过期结果中移动过的节点，随下一份采用的结果一起移动
+    std::vector<int> staleBlocks;       // 过期结果中变化的概览色块，同上
+    std::vector<int> moveSlot;          // 节点编号 → 在新移动列表中的下标，-1 表示不在其中；跨调用复用
+    std::unique_ptr<NodeItemPool> pool;     // 节点图元池：淡出的图元回收后供新节点复用
+    std::vector<NodeItem*> items;   // 按节点编号存储图元，没有绑定图元的节点为 nullptr
+    std::vector<int> boundIds;      // 绑定了图元的节点编号，可能含已删除或重复的编号，使用前核对 items
+    std::vector<unsigned> bindMark; // 节点编号 → 最近一次绑定时落在范围内的轮次
+    unsigned bindRound = 0;
+    std::vector<int> edgeOf;        // 节点编号 → 连向父节点的连线在边图层中的下标，-1 表示没有
+    std::vector<int> edgeChild;     // 边图层下标 → 连线下端的节点编号，删除时用末尾连线填补空位
+    std::vector<Move> moves;
+    QElapsedTimer moveClock;
+    bool moveRunning = false;       // 移动步骤是否已挂在调度器上
+    int shownRoot = BinaryTreeModel::npos;  // 图元中作为根（没有连线）的节点
+    std::vector<std::pair<int, NodeItem*>> searchPath;  // 查找时高亮的节点，恢复颜色前核对图元未被替换
+    int searchChannel;      // 查找高亮动画的通道
+    EdgeLayerItem* edges;   // 边图层：所有父子连线
+    SceneBatcher* batcher;  // 合并同一帧内的布局和淡入/淡出动画
+    AggregateBlockItem* overview;  // 聚合色块，用于极度缩小时的概览
+    ImportBar* importBar;   // 从文件批量导入
+    ImportStaging* staged = nullptr;    // 正在换入的导入结果，只在 adopt 期间非空
 
-    void updateScene(); // 重新绘制/更新整个场景
-    void animateNodeInsertion(NodeItem* node);  // 节点插入动画
-    void animateNodeDeletion(NodeItem* node, std::function<void()> callback);   // 节点删除动画，删除后执行回调函数
+    void onModelChanged(const TreeEvent& e);    // 根据模型变更事件增删图元
+    void updateScene(); // 把结构变更和树的副本提交给布局线程
+    void onLayoutReady(std::shared_ptr<const TreeLayoutBuffer> result); // 采用最新的布局结果，移动位置变化的节点
+    void updateSceneRect(); // 场景范围取布局的包围盒
+    void discardItems();    // 回收所有图元和连线，丢弃进行中的动画和待办
+    ImportJob makeImportJob();  // 按当前模式为一次导入准备暂存模型
+    bool stepMoves();   // 推进一帧节点移动，连线跟随端点，全部到位后返回 false
+    QPointF nodePos(int id) const;  // 节点在布局中的左上角坐标
+    QPointF shownPos(int id) const; // 有图元时取图元当前位置，否则取布局位置
+    QLineF edgeLine(int child) const;   // 按两端当前显示的位置计算父节点到 child 的连线
+    void addEdge(int child);    // 追加父节点到 child 的连线
+    void removeEdge(int child); // 删除 child 连向父节点的连线
+    void refreshEdge(int child);    // 按图元当前位置移动连线，需随后调用 edges->commitMoves()
+    void updateOverview(const std::vector<int>& changed);  // 按布局结果改写变化的概览色块
+    void syncRoot();        // 旋转或删除换了根之后，补上原根的连线、删除新根的连线
+    QColor nodeColor(int id) const;     // 节点的常规配色，红黑树模式下按颜色区分
+    void enableModeControls(int index); // 按模式启用层序或按键操作的按钮
+    bool readKey(int& key);     // 读取输入框中的键，不合法时提示并返回 false
+    void clearSearch();     // 取消查找动画并恢复高亮节点的颜色
 };
 
 #endif
@@ -0,0 +1,449 @@
+#include "btreemodel.h"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BTREE_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr int BinarySearchCutoff = 32;  // 区间不超过这么多键时改为 SIMD 线性统计
+
+#ifdef BTREE_USE_SSE2
+constexpr int PopCount4[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+#endif
+
+} // namespace
+
+BTreeModel::BTreeModel(Kind kind, int maxKeys) {
+    reset(kind, maxKeys);
+}
+
+void BTreeModel::reset(Kind kind, int maxKeys) {
+    m_kind = kind;
+    m_maxKeys = std::clamp(maxKeys, 2, maxFanout);
+    linesPerNode = (m_maxKeys + 1 + 15) / 16;   // 多留一个键位，分裂前可以先插入再拆分
+    childStride = m_maxKeys + 2;
+    clear();
+}
+
+void BTreeModel::clear() {
+    m_lines.clear(); m_children.clear(); m_count.clear(); m_next.clear(); m_leaf.clear(); m_free.clear();
+    m_root = npos;
+    m_size = 0;
+    m_height = 0;
+    m_nodes = 0;
+    m_changes.notify(BTreeEvent{BTreeEvent::Cleared});
+}
+
+// 从节点池取一个节点，优先复用释放的节点
+int BTreeModel::allocate(bool leaf) {
+    int node;
+    if (!m_free.empty()) {
+        node = m_free.back();
+        m_free.pop_back();
+    } else {
+        node = static_cast<int>(m_count.size());
+        m_lines.resize(m_lines.size() + linesPerNode);
+        m_children.resize(m_children.size() + childStride, npos);
+        m_count.push_back(0);
+        m_next.push_back(npos);
+        m_leaf.push_back(0);
+    }
+    m_count[node] = 0;
+    m_next[node] = npos;
+    m_leaf[node] = leaf;
+    ++m_nodes;
+    return node;
+}
+
+void BTreeModel::release(int node) {
+    m_free.push_back(node);
+    --m_nodes;
+}
+
+// 键有序，小于 key 的键数即下标。先二分缩小区间，再每次比较 4 个键
+int BTreeModel::lowerBound(int node, int key) const {
+    const int* k = keys(node);
+    int lo = 0, hi = m_count[node];
+    while (hi - lo > BinarySearchCutoff) {
+        int mid = lo + (hi - lo) / 2;
+        if (k[mid] < key) lo = mid + 1;
+        else hi = mid;
+    }
+    int less = 0;
+    int i = lo;
+#ifdef BTREE_USE_SSE2
+    const __m128i needle = _mm_set1_epi32(key);
+    for (; i + 4 <= hi; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(k + i));
+        less += PopCount4[_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(v, needle)))];
+    }
+#endif
+    for (; i < hi; ++i) less += k[i] < key;
+    return lo + less;
+}
+
+// B+ 树的分隔键等于右子树的最小键，命中时进入右边的孩子
+int BTreeModel::descend(int node, int key) const {
+    int i = lowerBound(node, key);
+    if (m_kind == BPlusTree && i < m_count[node] && keys(node)[i] == key) ++i;
+    return i;
+}
+
+bool BTreeModel::contains(int key) const {
+    return findNode(key) != npos;
+}
+
+int BTreeModel::findNode(int key) const {
+    for (int n = m_root; n != npos; ) {
+        int i = lowerBound(n, key);
+        bool hit = i < m_count[n] && keys(n)[i] == key;
+        if (m_leaf[n]) return hit ? n : npos;
+        if (hit && m_kind == BTree) return n;
+        n = child(n, hit ? i + 1 : i);
+    }
+    return npos;
+}
+
+bool BTreeModel::insert(int key) {
+    if (m_root == npos) {
+        m_root = allocate(true);
+        keySlots(m_root)[0] = key;
+        m_count[m_root] = 1;
+        m_size = 1;
+        m_height = 1;
+        m_changes.notify(BTreeEvent{BTreeEvent::Grown, m_root});
+        m_changes.notify(BTreeEvent{BTreeEvent::Inserted, m_root, npos, key});
+        return true;
+    }
+
+    // 下降到叶子，记录路径供分裂时向上插入分隔键
+    m_path.clear();
+    int n = m_root;
+    int i;
+    for (;;) {
+        i = lowerBound(n, key);
+        if (i < m_count[n] && keySlots(n)[i] == key) {
+            if (m_kind == BTree || m_leaf[n]) return false;
+            ++i;
+        }
+        if (m_leaf[n]) break;
+        m_path.emplace_back(n, i);
+        n = child(n, i);
+    }
+    int* k = keySlots(n);
+    std::copy_backward(k + i, k + m_count[n], k + m_count[n] + 1);
+    k[i] = key;
+    ++m_count[n];
+    ++m_size;
+    m_changes.notify(BTreeEvent{BTreeEvent::Inserted, n, npos, key});
+
+    // 节点超过 maxKeys 个键时分裂，分隔键插入父节点，可能一直分裂到根
+    while (m_count[n] > m_maxKeys) {
+        int sibling, separator;
+        split(n, sibling, separator);
+        m_changes.notify(BTreeEvent{BTreeEvent::Split, n, sibling, separator});
+        if (m_path.empty()) {
+            int r = allocate(false);
+            keySlots(r)[0] = separator;
+            children(r)[0] = n;
+            children(r)[1] = sibling;
+            m_count[r] = 1;
+            m_root = r;
+            ++m_height;
+            m_changes.notify(BTreeEvent{BTreeEvent::Grown, r});
+            break;
+        }
+        auto [p, at] = m_path.back();
+        m_path.pop_back();
+        int* pk = keySlots(p);
+        int* pc = children(p);
+        int c = m_count[p];
+        std::copy_backward(pk + at, pk + c, pk + c + 1);
+        pk[at] = separator;
+        std::copy_backward(pc + at + 1, pc + c + 1, pc + c + 2);
+        pc[at + 1] = sibling;
+        ++m_count[p];
+        n = p;
+    }
+    return true;
+}
+
+// 把有 maxKeys+1 个键的节点拆成两半。B 树和 B+ 树的内部节点把中间键上移；
+// B+ 树的叶子保留所有键，右半部分的第一个键复制到父节点作为分隔键，新叶子接入链表
+void BTreeModel::split(int node, int& sibling, int& separator) {
+    sibling = allocate(m_leaf[node]);   // 可能扩容节点池，指针在此之后再取
+    int cnt = m_count[node];
+    int* k = keySlots(node);
+    int* sk = keySlots(sibling);
+    if (m_leaf[node] && m_kind == BPlusTree) {
+        int left = cnt / 2;
+        std::copy(k + left, k + cnt, sk);
+        m_count[sibling] = cnt - left;
+        m_count[node] = left;
+        separator = sk[0];
+        m_next[sibling] = m_next[node];
+        m_next[node] = sibling;
+        return;
+    }
+    int mid = (cnt - 1) / 2;
+    separator = k[mid];
+    std::copy(k + mid + 1, k + cnt, sk);
+    if (!m_leaf[node]) std::copy(children(node) + mid + 1, children(node) + cnt + 1, children(sibling));
+    m_count[sibling] = cnt - mid - 1;
+    m_count[node] = mid;
+}
+
+bool BTreeModel::remove(int key) {
+    if (m_root == npos) return false;
+    m_path.clear();
+    int n = m_root;
+    int i;
+    for (;;) {
+        i = lowerBound(n, key);
+        bool hit = i < m_count[n] && keySlots(n)[i] == key;
+        if (m_leaf[n]) {
+            if (!hit) return false;
+            break;
+        }
+        if (hit && m_kind == BTree) {
+            // 键在内部节点中：用左子树中的前驱顶替，再从叶子删除前驱
+            m_path.emplace_back(n, i);
+            int holder = n, slot = i;
+            n = child(n, i);
+            while (!m_leaf[n]) {
+                m_path.emplace_back(n, m_count[n]);
+                n = child(n, m_count[n]);
+            }
+            i = m_count[n] - 1;
+            keySlots(holder)[slot] = keySlots(n)[i];
+            break;
+        }
+        if (hit) ++i;
+        m_path.emplace_back(n, i);
+        n = child(n, i);
+    }
+    int* k = keySlots(n);
+    std::copy(k + i + 1, k + m_count[n], k + i);
+    --m_count[n];
+    --m_size;
+    m_changes.notify(BTreeEvent{BTreeEvent::Removed, n, npos, key});
+    fixUnderflow(n);
+    return true;
+}
+
+// 节点键数不足 minKeys 时先向左右兄弟借键，兄弟也不富余时与兄弟合并，合并可能让父节点继续不足
+void BTreeModel::fixUnderflow(int n) {
+    while (n != m_root && m_count[n] < minKeys()) {
+        auto [p, i] = m_path.back();
+        m_path.pop_back();
+        int left = i > 0 ? child(p, i - 1) : npos;
+        int right = i < m_count[p] ? child(p, i + 1) : npos;
+        bool plusLeaf = m_kind == BPlusTree && m_leaf[n];
+        int* k = keySlots(n);
+        int c = m_count[n];
+
+        if (left != npos && m_count[left] > minKeys()) {
+            int* lk = keySlots(left);
+            int lc = m_count[left];
+            std::copy_backward(k, k + c, k + c + 1);
+            if (plusLeaf) {
+                k[0] = lk[lc - 1];
+                keySlots(p)[i - 1] = k[0];
+            } else {
+                k[0] = keySlots(p)[i - 1];
+                keySlots(p)[i - 1] = lk[lc - 1];
+                if (!m_leaf[n]) {
+                    int* ch = children(n);
+                    std::copy_backward(ch, ch + c + 1, ch + c + 2);
+                    ch[0] = child(left, lc);
+                }
+            }
+            ++m_count[n];
+            --m_count[left];
+            m_changes.notify(BTreeEvent{BTreeEvent::Borrowed, n, left});
+            return;
+        }
+        if (right != npos && m_count[right] > minKeys()) {
+            int* rk = keySlots(right);
+            int rc = m_count[right];
+            if (plusLeaf) {
+                k[c] = rk[0];
+                std::copy(rk + 1, rk + rc, rk);
+                keySlots(p)[i] = rk[0];
+            } else {
+                k[c] = keySlots(p)[i];
+                keySlots(p)[i] = rk[0];
+                std::copy(rk + 1, rk + rc, rk);
+                if (!m_leaf[n]) {
+                    int* rch = children(right);
+                    children(n)[c + 1] = rch[0];
+                    std::copy(rch + 1, rch + rc + 1, rch);
+                }
+            }
+            ++m_count[n];
+            --m_count[right];
+            m_changes.notify(BTreeEvent{BTreeEvent::Borrowed, n, right});
+            return;
+        }
+        mergeChildren(p, left != npos ? i - 1 : i);
+        n = p;
+    }
+
+    // 根的键被合并光时由唯一的孩子接任，树高减一
+    if (m_count[m_root] == 0) {
+        int old = m_root;
+        m_root = m_leaf[old] ? npos : child(old, 0);
+        release(old);
+        --m_height;
+        m_changes.notify(BTreeEvent{BTreeEvent::Shrunk, old});
+    }
+}
+
+void BTreeModel::mergeChildren(int parent, int i) {
+    int l = child(parent, i), r = child(parent, i + 1);
+    int* lk = keySlots(l);
+    int* rk = keySlots(r);
+    int lc = m_count[l], rc = m_count[r];
+    if (m_kind == BPlusTree && m_leaf[l]) {
+        std::copy(rk, rk + rc, lk + lc);
+        m_count[l] = lc + rc;
+        m_next[l] = m_next[r];
+    } else {
+        lk[lc] = keySlots(parent)[i];   // 分隔键下移到两半之间
+        std::copy(rk, rk + rc, lk + lc + 1);
+        if (!m_leaf[l]) std::copy(children(r), children(r) + rc + 1, children(l) + lc + 1);
+        m_count[l] = lc + rc + 1;
+    }
+    int* pk = keySlots(parent);
+    int* pc = children(parent);
+    int c = m_count[parent];
+    std::copy(pk + i + 1, pk + c, pk + i);
+    std::copy(pc + i + 2, pc + c + 1, pc + i + 1);
+    --m_count[parent];
+    release(r);
+    m_changes.notify(BTreeEvent{BTreeEvent::Merged, l, r});
+}
+
+int BTreeModel::rangeScan(int lo, int hi, std::vector<int>& out) const {
+    size_t before = out.size();
+    if (m_root == npos || lo > hi) return 0;
+
+    if (m_kind == BPlusTree) {
+        // 下降到 lo 所在的叶子，之后只沿叶子链表前进
+        int n = m_root;
+        while (!m_leaf[n]) n = child(n, descend(n, lo));
+        for (int i = lowerBound(n, lo); n != npos; n = m_next[n], i = 0) {
+            const int* k = keys(n);
+            for (; i < m_count[n]; ++i) {
+                if (k[i] > hi) return static_cast<int>(out.size() - before);
+                out.push_back(k[i]);
+            }
+        }
+        return static_cast<int>(out.size() - before);
+    }
+
+    // B 树按中序遍历：栈中每项为（节点, 下一个要输出的键下标）
+    std::vector<std::pair<int, int>> stack;
+    for (int n = m_root; n != npos; ) {
+        int i = lowerBound(n, lo);
+        stack.emplace_back(n, i);
+        n = m_leaf[n] ? npos : child(n, i);
+    }
+    while (!stack.empty()) {
+        auto [n, i] = stack.back();
+        if (i >= m_count[n]) {
+            stack.pop_back();
+            continue;
+        }
+        int k = keys(n)[i];
+        if (k > hi) break;
+        out.push_back(k);
+        stack.back().second = i + 1;
+        if (!m_leaf[n]) {
+            for (int c = child(n, i + 1); c != npos; c = m_leaf[c] ? npos : child(c, 0))
+                stack.emplace_back(c, 0);
+        }
+    }
+    return static_cast<int>(out.size() - before);
+}
+
+// 自底向上建树：先把键均匀分到各个叶子，再逐层把节点均匀分给父节点。
+// 每个节点约 perNode 个键（不少于 minKeys），比逐个插入少了所有分裂，节点也更满
+bool BTreeModel::bulkLoad(const std::vector<int>& sorted, double fill) {
+    for (size_t i = 1; i < sorted.size(); ++i)
+        if (!(sorted[i - 1] < sorted[i])) return false;
+
+    m_lines.clear(); m_children.clear(); m_count.clear(); m_next.clear(); m_leaf.clear(); m_free.clear();
+    m_root = npos;
+    m_size = static_cast<int>(sorted.size());
+    m_height = 0;
+    m_nodes = 0;
+    if (sorted.empty()) {
+        m_changes.notify(BTreeEvent{BTreeEvent::Rebuilt});
+        return true;
+    }
+
+    fill = std::clamp(fill, 0.5, 1.0);
+    const int perNode = std::min(m_maxKeys, std::max(2 * minKeys(), int(m_maxKeys * fill + 0.5)));
+    const int n = m_size;
+    std::vector<int> nodes, separators;    // separators[i] 位于 nodes[i] 与 nodes[i+1] 之间
+
+    // B+ 树的叶子装下所有键，分隔键取右边叶子的第一个键；B 树的叶子之间各拿走一个键作分隔键
+    bool plus = m_kind == BPlusTree;
+    int leaves = plus ? (n + perNode - 1) / perNode : (n + 1 + perNode) / (perNode + 1);
+    int leafKeys = plus ? n : n - (leaves - 1);
+    int base = leafKeys / leaves, extra = leafKeys % leaves;
+    m_lines.reserve(size_t(leaves) * linesPerNode * 11 / 10);
+    int pos = 0;
+    for (int j = 0; j < leaves; ++j) {
+        int cnt = base + (j < extra);
+        int leaf = allocate(true);
+        std::copy(sorted.begin() + pos, sorted.begin() + pos + cnt, keySlots(leaf));
+        m_count[leaf] = cnt;
+        if (!nodes.empty()) {
+            if (plus) {
+                m_next[nodes.back()] = leaf;
+                separators.push_back(sorted[pos]);
+            }
+        }
+        nodes.push_back(leaf);
+        pos += cnt;
+        if (!plus && j + 1 < leaves) separators.push_back(sorted[pos++]);
+    }
+    m_height = 1;
+    while (nodes.size() > 1) {
+        buildLevel(nodes, separators, perNode);
+        ++m_height;
+    }
+    m_root = nodes[0];
+    m_changes.notify(BTreeEvent{BTreeEvent::Rebuilt});
+    return true;
+}
+
+// 把一层节点均匀分给上一层的父节点，每个父节点最多 perNode+1 个孩子；父节点之间的分隔键继续上移
+void BTreeModel::buildLevel(std::vector<int>& nodes, std::vector<int>& separators, int perNode) {
+    std::vector<int> upper, upperSeparators;
+    int k = static_cast<int>(nodes.size());
+    int parents = (k + perNode) / (perNode + 1);
+    int base = k / parents, extra = k % parents;
+    int next = 0;
+    for (int j = 0; j < parents; ++j) {
+        int c = base + (j < extra);
+        int p = allocate(false);
+        int* pk = keySlots(p);
+        int* pc = children(p);
+        for (int t = 0; t < c; ++t) {
+            pc[t] = nodes[next + t];
+            if (t > 0) pk[t - 1] = separators[next + t - 1];
+        }
+        m_count[p] = c - 1;
+        next += c;
+        if (j + 1 < parents) upperSeparators.push_back(separators[next - 1]);
+        upper.push_back(p);
+    }
+    nodes.swap(upper);
+    separators.swap(upperSeparators);
+}
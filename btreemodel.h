@@ -0,0 +1,105 @@
+#ifndef BTREEMODEL_H
+#define BTREEMODEL_H
+
+#include "modelsignal.h"
+#include <utility>
+#include <vector>
+
+// B 树变更事件，视图据此播放分裂、合并动画
+struct BTreeEvent {
+    enum Type {
+        Inserted,   // 键 key 插入到叶子 node
+        Removed,    // 键 key 已删除，node 为实际删掉键的叶子
+        Split,      // node 分裂，右半部分放入新节点 sibling
+        Merged,     // 右兄弟 sibling 并入 node 后被释放
+        Borrowed,   // node 从兄弟 sibling 借了一个键
+        Grown,      // 出现新的根 node（插入第一个键或根分裂）
+        Shrunk,     // 根 node 变空被释放，树高减一
+        Cleared,
+        Rebuilt,    // 批量加载完成，整棵树重建
+    };
+    Type type;
+    int  node = -1;
+    int  sibling = -1;
+    int  key = 0;
+};
+
+// BTreeModel 是不依赖 Qt 的 B 树 / B+ 树，扇出（每个节点最多的键数）可配置。
+// 节点存放在节点池中，每个节点的键连续存放在按 64 字节对齐的缓存行上，
+// 节点内查找先二分缩小到 32 个键以内，再用 SSE2 一次比较 4 个键统计小于目标的个数。
+// maxKeys 取 15 时一个节点的键恰好占一条缓存行，取 1023 时占一个 4KB 页。
+// B+ 树的键都在叶子中，内部节点只存分隔键，叶子按键序串成链表用于范围扫描。
+class BTreeModel
+{
+public:
+    static constexpr int npos = -1;
+    static constexpr int cacheLineKeys = 15;    // 键数组（含分裂时的一个临时位）恰好一条缓存行
+    static constexpr int pageKeys = 1023;       // 键数组恰好一个 4KB 页
+    static constexpr int maxFanout = 1023;
+    enum Kind { BTree, BPlusTree };
+
+    explicit BTreeModel(Kind kind = BTree, int maxKeys = 4);
+
+    void reset(Kind kind, int maxKeys);     // 清空并切换类型和扇出，maxKeys 取值 2..1023
+    Kind kind() const { return m_kind; }
+    int  maxKeys() const { return m_maxKeys; }
+    int  minKeys() const { return m_maxKeys / 2; }  // 非根节点至少的键数
+
+    bool insert(int key);           // 键已存在时返回 false
+    bool remove(int key);           // 键不存在时返回 false
+    bool contains(int key) const;
+    int  findNode(int key) const;   // 键所在的节点（B+ 树为叶子），找不到时返回 npos
+    // 把 [lo, hi] 内的键按顺序追加到 out，返回追加的个数。B+ 树沿叶子链表扫描
+    int  rangeScan(int lo, int hi, std::vector<int>& out) const;
+    // 由严格递增的键批量建树，每个节点约填到 fill（0.5..1）的比例；输入无序或有重复时返回 false
+    bool bulkLoad(const std::vector<int>& sorted, double fill = 1.0);
+    void clear();
+
+    int  root() const { return m_root; }
+    int  size() const { return m_size; }
+    int  height() const { return m_height; }    // 空树为 0
+    int  nodeCount() const { return m_nodes; }
+    bool isLeaf(int node) const { return m_leaf[node]; }
+    int  keyCount(int node) const { return m_count[node]; }
+    const int* keys(int node) const { return reinterpret_cast<const int*>(&m_lines[size_t(node) * linesPerNode]); }
+    int  key(int node, int i) const { return keys(node)[i]; }
+    int  child(int node, int i) const { return m_children[size_t(node) * childStride + i]; }
+    int  nextLeaf(int node) const { return m_next[node]; }     // B+ 树叶子链表的后继
+    int  lowerBound(int node, int key) const;  // 节点内第一个不小于 key 的下标
+
+    ModelSignal<BTreeEvent>& changes() { return m_changes; }
+
+private:
+    struct alignas(64) KeyLine {
+        int k[16];
+    };
+
+    int* keySlots(int node) { return reinterpret_cast<int*>(&m_lines[size_t(node) * linesPerNode]); }
+    int* children(int node) { return &m_children[size_t(node) * childStride]; }
+    int  allocate(bool leaf);
+    void release(int node);
+    int  descend(int node, int key) const;      // 查找 key 时进入的孩子下标
+    void split(int node, int& sibling, int& separator);
+    void fixUnderflow(int node);
+    void mergeChildren(int parent, int i);      // 把第 i+1 个孩子并入第 i 个
+    void buildLevel(std::vector<int>& nodes, std::vector<int>& separators, int perNode);
+
+    Kind m_kind;
+    int  m_maxKeys;
+    int  linesPerNode;      // 每个节点的键占多少条缓存行（容纳 maxKeys+1 个键）
+    int  childStride;       // 每个节点的孩子槽位数（maxKeys+2）
+    std::vector<KeyLine> m_lines;
+    std::vector<int>  m_children;
+    std::vector<int>  m_count;
+    std::vector<int>  m_next;
+    std::vector<char> m_leaf;
+    std::vector<int>  m_free;
+    std::vector<std::pair<int, int>> m_path;    // 最近一次下降经过的（节点, 孩子下标）
+    int m_root = npos;
+    int m_size = 0;
+    int m_height = 0;
+    int m_nodes = 0;
+    ModelSignal<BTreeEvent> m_changes;
+};
+
+#endif
@@ -0,0 +1,56 @@
+#include "btreenodeitem.h"
+#include "loditems.h"
+#include <QPainter>
+#include <QFont>
+#include <QPen>
+#include <QStyleOptionGraphicsItem>
+#include <algorithm>
+
+BTreeNodeItem::BTreeNodeItem(QGraphicsItem* parent)
+    : QGraphicsItem(parent)
+{
+}
+
+void BTreeNodeItem::setKeys(const int* keys, int count) {
+    if (count == keyCount() && std::equal(keys, keys + count, m_keys.begin())) return;
+    if (count != keyCount()) prepareGeometryChange();
+    m_keys.assign(keys, keys + count);
+    if (m_highlight >= count) m_highlight = -1;
+    update();
+}
+
+void BTreeNodeItem::setLeaf(bool leaf) {
+    if (m_leaf == leaf) return;
+    m_leaf = leaf;
+    update();
+}
+
+void BTreeNodeItem::setHighlight(int cell, const QColor& color) {
+    m_highlight = cell;
+    m_highlightColor = color;
+    update();
+}
+
+QRectF BTreeNodeItem::boundingRect() const {
+    return QRectF(0, 0, width(), CellHeight);
+}
+
+// 缩小到看不清文字时只画整块底色。节点数最多几千个，不需要聚合色块
+void BTreeNodeItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget*) {
+    qreal lod = Lod::levelOf(option, painter);
+    QColor fill = m_leaf ? QColor(70, 130, 180) : QColor(40, 70, 140);
+    QRectF rect = boundingRect();
+    if (lod < Lod::Label) {
+        painter->setRenderHint(QPainter::Antialiasing, false);
+        painter->fillRect(rect, fill);
+        return;
+    }
+    painter->setPen(QPen(Qt::white, 1));
+    painter->setFont(QFont(painter->font().family(), 9));
+    for (int i = 0; i < keyCount(); ++i) {
+        QRectF cell(i * CellWidth, 0, CellWidth, CellHeight);
+        painter->setBrush(i == m_highlight ? m_highlightColor : fill);
+        painter->drawRect(cell);
+        painter->drawText(cell, Qt::AlignCenter, QString::number(m_keys[i]));
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef BTREENODEITEM_H
+#define BTREENODEITEM_H
+
+#include <QGraphicsItem>
+#include <QColor>
+#include <QRectF>
+#include <algorithm>
+#include <vector>
+
+class QPainter;
+class QStyleOptionGraphicsItem;
+class QWidget;
+
+// BTreeNodeItem 表示 B 树的一个节点：一排键格子，宽度随键数变化。
+// 与 ArrowItem 一样不继承 QObject，位置和透明度由调度器直接设置
+class BTreeNodeItem : public QGraphicsItem
+{
+public:
+    static constexpr qreal CellWidth = 36;     // 每个键格子的宽度
+    static constexpr qreal CellHeight = 30;
+
+    explicit BTreeNodeItem(QGraphicsItem* parent = nullptr);
+
+    void setKeys(const int* keys, int count);  // 键不变时不重绘
+    int  keyCount() const { return static_cast<int>(m_keys.size()); }
+    qreal width() const { return CellWidth * std::max<size_t>(1, m_keys.size()); }
+
+    void setLeaf(bool leaf);                    // 叶子与内部节点配色不同
+    void setHighlight(int cell, const QColor& color);   // 高亮一个键格子，cell 为 -1 时取消
+
+    QRectF boundingRect() const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override;
+
+private:
+    std::vector<int> m_keys;
+    bool   m_leaf = true;
+    int    m_highlight = -1;
+    QColor m_highlightColor;
+};
+
+#endif
@@ -0,0 +1,507 @@
+#include "btreewidget.h"
+#include "animationscheduler.h"
+
+#include <QGraphicsScene>
+#include <QGraphicsView>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QPushButton>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QSpinBox>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPainter>
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <set>
+
+BTreeWidget::BTreeWidget(QWidget* parent)
+    : QWidget(parent), model(BTreeModel::BTree, 4)
+{
+    auto *mainLayout = new QVBoxLayout(this);
+
+    scene = new QGraphicsScene(this);
+    view  = new QGraphicsView(scene, this);
+    view->setRenderHint(QPainter::Antialiasing);
+    view->setDragMode(QGraphicsView::ScrollHandDrag);
+    view->setResizeAnchor(QGraphicsView::AnchorUnderMouse);
+    view->setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+    mainLayout->addWidget(view);
+
+    // 控制面板
+    kindBox = new QComboBox(this);
+    kindBox->addItems({"B树", "B+树"});
+    fanoutBox = new QComboBox(this);
+    for (int m : {3, 4, 5, 7}) fanoutBox->addItem(QString("每节点最多 %1 键").arg(m), m);
+    fanoutBox->addItem(QString("每节点最多 %1 键（一条缓存行）").arg(BTreeModel::cacheLineKeys), BTreeModel::cacheLineKeys);
+    fanoutBox->setCurrentIndex(1);
+    keyEdit = new QLineEdit(this);
+    keyEdit->setPlaceholderText("键 / 下界");
+    hiEdit = new QLineEdit(this);
+    hiEdit->setPlaceholderText("上界");
+    insertButton = new QPushButton("插入", this);
+    removeButton = new QPushButton("删除", this);
+    findButton   = new QPushButton("查找", this);
+    rangeButton  = new QPushButton("范围查询", this);
+    bulkSpin = new QSpinBox(this);
+    bulkSpin->setRange(1, 5000);
+    bulkSpin->setValue(60);
+    bulkSpin->setPrefix("键数 ");
+    bulkButton   = new QPushButton("批量加载", this);
+    randomButton = new QPushButton("随机插入10个", this);
+    clearButton  = new QPushButton("清空", this);
+    benchButton  = new QPushButton("性能测试", this);
+
+    auto *hlay = new QHBoxLayout;
+    hlay->addWidget(kindBox);
+    hlay->addWidget(fanoutBox);
+    hlay->addWidget(keyEdit);
+    hlay->addWidget(hiEdit);
+    hlay->addWidget(insertButton);
+    hlay->addWidget(removeButton);
+    hlay->addWidget(findButton);
+    hlay->addWidget(rangeButton);
+    hlay->addWidget(bulkSpin);
+    hlay->addWidget(bulkButton);
+    hlay->addWidget(randomButton);
+    hlay->addWidget(clearButton);
+    hlay->addWidget(benchButton);
+    mainLayout->addLayout(hlay);
+
+    statusLabel = new QLabel(this);
+    mainLayout->addWidget(statusLabel);
+
+    connect(kindBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &BTreeWidget::onConfigChanged);
+    connect(fanoutBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &BTreeWidget::onConfigChanged);
+    connect(insertButton, &QPushButton::clicked, this, &BTreeWidget::onInsertKey);
+    connect(removeButton, &QPushButton::clicked, this, &BTreeWidget::onRemoveKey);
+    connect(findButton,   &QPushButton::clicked, this, &BTreeWidget::onFindKey);
+    connect(rangeButton,  &QPushButton::clicked, this, &BTreeWidget::onRangeScan);
+    connect(bulkButton,   &QPushButton::clicked, this, &BTreeWidget::onBulkLoad);
+    connect(randomButton, &QPushButton::clicked, this, &BTreeWidget::onRandomKeys);
+    connect(clearButton,  &QPushButton::clicked, this, &BTreeWidget::onClear);
+    connect(benchButton,  &QPushButton::clicked, this, &BTreeWidget::onBenchmark);
+    connect(keyEdit, &QLineEdit::returnPressed, this, &BTreeWidget::onInsertKey);
+    searchChannel = AnimationScheduler::instance().newChannel();
+
+    batcher = new SceneBatcher(scene, [this]() { updateScene(); }, this);
+    edges = new EdgeLayerItem;  // 孩子指针和叶子链表由一个图元批量绘制
+    edges->setZValue(-1);
+    scene->addItem(edges);
+
+    // 订阅模型变更，所有图元都由模型事件驱动
+    model.changes().subscribe([this](const BTreeEvent& e) { onModelChanged(e); });
+
+    updateScene();
+}
+
+void BTreeWidget::onConfigChanged() {
+    clearMarks();
+    model.reset(BTreeModel::Kind(kindBox->currentIndex()), fanoutBox->currentData().toInt());
+}
+
+bool BTreeWidget::readKey(QLineEdit* edit, int& key) {
+    bool ok;
+    key = edit->text().toInt(&ok);
+    if (!ok) QMessageBox::warning(this, "输入错误", "请输入整数键！");
+    return ok;
+}
+
+void BTreeWidget::onInsertKey() {
+    int key;
+    if (!readKey(keyEdit, key)) return;
+    clearMarks();
+    if (!model.insert(key)) QMessageBox::information(this, "提示", "该键已存在！");
+}
+
+void BTreeWidget::onRemoveKey() {
+    int key;
+    if (!readKey(keyEdit, key)) return;
+    clearMarks();
+    if (!model.remove(key)) QMessageBox::warning(this, "错误", "未找到该键！");
+}
+
+// 从根开始逐层点亮经过的格子：命中的键为绿色，其余为橙色（落在两键之间时点亮右边的键）
+void BTreeWidget::onFindKey() {
+    int key;
+    if (!readKey(keyEdit, key)) return;
+    clearMarks();
+    if (!model.contains(key)) {
+        QMessageBox::warning(this, "错误", "未找到该键！");
+        return;
+    }
+    for (int n = model.root(); n != BTreeModel::npos; ) {
+        int i = model.lowerBound(n, key);
+        bool hit = i < model.keyCount(n) && model.key(n, i) == key;
+        bool last = model.isLeaf(n) || (hit && model.kind() == BTreeModel::BTree);
+        marks.push_back(Mark{n, items[n], std::min(i, model.keyCount(n) - 1),
+                             last ? QColor(0, 160, 0) : QColor(255, 140, 0)});
+        if (last) break;
+        n = model.child(n, hit ? i + 1 : i);    // B+ 树中等于分隔键时进入右子树
+    }
+    playMarks(400);
+}
+
+// B+ 树的结果沿叶子链表连续排列；B 树的结果按中序分散在各层
+void BTreeWidget::onRangeScan() {
+    int lo, hi;
+    if (!readKey(keyEdit, lo) || !readKey(hiEdit, hi)) return;
+    clearMarks();
+    std::vector<int> found;
+    model.rangeScan(lo, hi, found);
+    statusLabel->setText(QString("[%1, %2] 内共 %3 个键").arg(lo).arg(hi).arg(found.size()));
+    const size_t shown = std::min<size_t>(found.size(), 200);     // 结果很多时只点亮前面一段
+    for (size_t j = 0; j < shown; ++j) {
+        int n = model.findNode(found[j]);
+        marks.push_back(Mark{n, items[n], model.lowerBound(n, found[j]), QColor(255, 140, 0)});
+    }
+    playMarks(150);
+}
+
+// 随机生成严格递增的键（相邻间隔 1..3），一次建成整棵树
+void BTreeWidget::onBulkLoad() {
+    static std::mt19937 rng(std::random_device{}());
+    std::uniform_int_distribution<int> gap(1, 3);
+    std::vector<int> keys(bulkSpin->value());
+    int k = 0;
+    for (int& key : keys) key = k += gap(rng);
+    clearMarks();
+    model.bulkLoad(keys);
+}
+
+void BTreeWidget::onRandomKeys() {
+    static std::mt19937 rng(std::random_device{}());
+    std::uniform_int_distribution<int> dist(1, 999);
+    clearMarks();
+    for (int inserted = 0, tries = 0; inserted < 10 && tries < 1000; ++tries)
+        inserted += model.insert(dist(rng));
+}
+
+void BTreeWidget::onClear() {
+    clearMarks();
+    model.clear();
+}
+
+// 在不挂监听器的模型上测量吞吐量，类型与当前选择相同，以 std::set 作参照
+void BTreeWidget::onBenchmark() {
+    const int n = 200000;
+    std::vector<int> keys(n);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+    std::vector<int> found;
+    found.reserve(n);
+    auto rate = [n](qint64 ns) { return QString::number(n * 1000.0 / std::max<qint64>(1, ns), 'f', 1); };
+
+    QString report = QString("%1：%2 个随机键，单位为百万次/秒\n\n扇出\t高度\t插入\t查找\t范围扫描\t删除\n")
+                         .arg(kindBox->currentText()).arg(n);
+    QElapsedTimer clock;
+    int misses = 0;
+    for (int m : {4, BTreeModel::cacheLineKeys, 63, 255, BTreeModel::pageKeys}) {
+        BTreeModel bench(model.kind(), m);
+        clock.start();
+        for (int k : keys) bench.insert(k);
+        qint64 insertNs = clock.nsecsElapsed();
+        int height = bench.height();
+        clock.start();
+        for (int k : keys) misses += !bench.contains(k);
+        qint64 findNs = clock.nsecsElapsed();
+        found.clear();
+        clock.start();
+        bench.rangeScan(0, n - 1, found);
+        qint64 scanNs = clock.nsecsElapsed();
+        misses += n - static_cast<int>(found.size());
+        clock.start();
+        for (int k : keys) bench.remove(k);
+        qint64 removeNs = clock.nsecsElapsed();
+        report += QString("%1\t%2\t%3\t%4\t%5\t%6\n").arg(m + 1).arg(height)
+                      .arg(rate(insertNs), rate(findNs), rate(scanNs), rate(removeNs));
+    }
+
+    std::set<int> reference;
+    clock.start();
+    for (int k : keys) reference.insert(k);
+    qint64 insertNs = clock.nsecsElapsed();
+    clock.start();
+    for (int k : keys) misses += reference.count(k) == 0;
+    qint64 findNs = clock.nsecsElapsed();
+    found.clear();
+    clock.start();
+    for (int k : reference) found.push_back(k);
+    qint64 scanNs = clock.nsecsElapsed();
+    clock.start();
+    for (int k : keys) reference.erase(k);
+    qint64 removeNs = clock.nsecsElapsed();
+    report += QString("std::set\t\t%1\t%2\t%3\t%4\n").arg(rate(insertNs), rate(findNs), rate(scanNs), rate(removeNs));
+    if (misses) report += QString("\n校验失败：%1 个键未找到").arg(misses);
+    QMessageBox::information(this, "性能测试", report);
+}
+
+void BTreeWidget::playMarks(int intervalMs) {
+    if (marks.empty()) return;
+    auto next = std::make_shared<size_t>(0);
+    AnimationScheduler::instance().every(searchChannel, intervalMs, [this, next]() {
+        const Mark& m = marks[(*next)++];
+        if (items[m.node] == m.item) m.item->setHighlight(m.cell, m.color);
+        bool last = *next == marks.size();
+        if (last) AnimationScheduler::instance().after(searchChannel, 1500, [this]() { clearMarks(); });
+        return !last;
+    });
+}
+
+void BTreeWidget::clearMarks() {
+    AnimationScheduler::instance().cancel(searchChannel);
+    for (const Mark& m : marks) {
+        if (m.node < static_cast<int>(items.size()) && items[m.node] == m.item) m.item->setHighlight(-1, QColor());
+    }
+    marks.clear();
+}
+
+BTreeNodeItem* BTreeWidget::createItem(int node, const QPointF& start, bool placed) {
+    if (node >= static_cast<int>(items.size())) items.resize(node + 1, nullptr);
+    auto* item = new BTreeNodeItem;
+    item->setOpacity(0.0);
+    item->setPos(start);
+    items[node] = item;
+    scene->addItem(item);
+    appearing.push_back(node);
+    if (!placed) unplaced.push_back(node);
+    return item;
+}
+
+// 被释放的节点从 items 中摘下，编号随即可以被复用；图元在动画结束后删除
+void BTreeWidget::retireItem(int node, const BTreeNodeItem* into) {
+    BTreeNodeItem* item = items[node];
+    items[node] = nullptr;
+    if (!item) return;
+    auto& scheduler = AnimationScheduler::instance();
+    int group = scheduler.createGroup(batcher->animationChannel(), [this, item]() {
+        scene->removeItem(item);
+        delete item;
+    });
+    if (into) scheduler.animatePos(item, item->pos(), into->pos(), MoveDurationMs, batcher->animationChannel(), group);
+    scheduler.animateOpacity(item, item->opacity(), 0.0, MoveDurationMs, batcher->animationChannel(), group);
+}
+
+// 模型变更后同步图元。键的变化统一在布局时刷新，这里只处理节点的创建和释放
+void BTreeWidget::onModelChanged(const BTreeEvent& e) {
+    switch (e.type) {
+    case BTreeEvent::Inserted:
+    case BTreeEvent::Removed:
+    case BTreeEvent::Borrowed:
+        batcher->requestLayout();
+        break;
+    case BTreeEvent::Split:
+        // 右半部分从原节点的位置滑向自己的位置
+        if (items[e.node]) createItem(e.sibling, items[e.node]->pos(), true);
+        else createItem(e.sibling, QPointF(), false);
+        batcher->requestLayout();
+        break;
+    case BTreeEvent::Grown: {
+        // 新根出现在原根的上方；第一个键插入时没有原根，直接出现在目标位置
+        int below = model.isLeaf(e.node) ? BTreeModel::npos : model.child(e.node, 0);
+        if (below != BTreeModel::npos && items[below]) createItem(e.node, items[below]->pos() - QPointF(0, LevelGap), true);
+        else createItem(e.node, QPointF(), false);
+        batcher->requestLayout();
+        break;
+    }
+    case BTreeEvent::Merged:
+        retireItem(e.sibling, items[e.node]);
+        batcher->requestLayout();
+        break;
+    case BTreeEvent::Shrunk:
+        retireItem(e.node, nullptr);
+        batcher->requestLayout();
+        break;
+    case BTreeEvent::Cleared:
+    case BTreeEvent::Rebuilt:
+        deleteAllItems();
+        if (e.type == BTreeEvent::Rebuilt) {
+            // 按层创建全部节点，布局后一起淡入
+            std::vector<int> level, below;
+            if (model.root() != BTreeModel::npos) level.push_back(model.root());
+            while (!level.empty()) {
+                below.clear();
+                for (int n : level) {
+                    createItem(n, QPointF(), false);
+                    if (model.isLeaf(n)) continue;
+                    for (int i = 0; i <= model.keyCount(n); ++i) below.push_back(model.child(n, i));
+                }
+                level.swap(below);
+            }
+            batcher->requestLayout();
+        } else {
+            updateScene();
+        }
+        break;
+    }
+}
+
+void BTreeWidget::deleteAllItems() {
+    // 先丢掉引用节点编号的待办，再结束进行中的动画（淡出中的节点随之删除）
+    appearing.clear();
+    unplaced.clear();
+    moves.clear();
+    batcher->finishAll();
+    moveRunning = false;   // finishAll 已丢弃挂起的移动步骤
+    clearMarks();
+    for (auto item : items) {
+        if (!item) continue;
+        scene->removeItem(item);
+        delete item;
+    }
+    items.clear();
+    edgeList.clear();
+    edges->clear();
+}
+
+// 整棵树重新布局：叶子从左到右依次排开，内部节点位于第一个和最后一个孩子的正中。
+// 节点数最多几千个，每帧全量布局的开销可以忽略；位置变化的节点从当前位置平移过去
+void BTreeWidget::updateScene() {
+    std::vector<std::vector<int>> levels;
+    if (model.root() != BTreeModel::npos) levels.push_back({model.root()});
+    while (!levels.empty() && !model.isLeaf(levels.back().front())) {
+        std::vector<int> below;
+        for (int n : levels.back())
+            for (int i = 0; i <= model.keyCount(n); ++i) below.push_back(model.child(n, i));
+        levels.push_back(std::move(below));
+    }
+
+    // 批量加载后、图元建好之前可能先被 finishAll 触发一次布局，此时跳过，等待随后的布局
+    for (const auto& level : levels) {
+        for (int n : level)
+            if (n >= static_cast<int>(items.size()) || !items[n]) return;
+    }
+
+    std::vector<QPointF> target(items.size());
+    for (const auto& level : levels) {
+        for (int n : level) {
+            items[n]->setKeys(model.keys(n), model.keyCount(n));
+            items[n]->setLeaf(model.isLeaf(n));
+        }
+    }
+    qreal minX = 0, maxX = 0;
+    if (!levels.empty()) {
+        qreal x = 0;
+        qreal y = (levels.size() - 1) * LevelGap;
+        for (int n : levels.back()) {
+            target[n] = QPointF(x, y);
+            x += items[n]->width() + LeafGap;
+        }
+        for (int d = static_cast<int>(levels.size()) - 2; d >= 0; --d) {
+            for (int n : levels[d]) {
+                int first = model.child(n, 0), last = model.child(n, model.keyCount(n));
+                qreal mid = (target[first].x() + items[first]->width() / 2 + target[last].x() + items[last]->width() / 2) / 2;
+                target[n] = QPointF(mid - items[n]->width() / 2, d * LevelGap);
+            }
+        }
+        // 根居中于横坐标 0
+        int root = model.root();
+        QPointF shift(-(target[root].x() + items[root]->width() / 2), 0);
+        minX = shift.x();
+        maxX = x - LeafGap + shift.x();
+        for (const auto& level : levels)
+            for (int n : level) target[n] += shift;
+    }
+
+    for (int n : unplaced) {
+        if (n < static_cast<int>(items.size()) && items[n]) items[n]->setPos(target[n]);
+    }
+    unplaced.clear();
+    auto& scheduler = AnimationScheduler::instance();
+    for (int n : appearing) {
+        if (n < static_cast<int>(items.size()) && items[n])
+            scheduler.animateOpacity(items[n], 0.0, 1.0, 400, batcher->animationChannel());
+    }
+    appearing.clear();
+
+    // 正在移动的节点从当前位置重新出发；目标变化的节点加入或改写移动终点
+    std::vector<int> slot(items.size(), -1);
+    std::vector<Move> next;
+    for (const Move& m : moves) {
+        if (items[m.node] != m.item) continue;
+        slot[m.node] = static_cast<int>(next.size());
+        next.push_back(Move{m.node, m.item, m.item->pos(), m.to});
+    }
+    for (const auto& level : levels) {
+        for (int n : level) {
+            BTreeNodeItem* item = items[n];
+            if (item->pos() == target[n] && slot[n] < 0) continue;
+            if (slot[n] >= 0) {
+                next[slot[n]].to = target[n];
+            } else {
+                slot[n] = static_cast<int>(next.size());
+                next.push_back(Move{n, item, item->pos(), target[n]});
+            }
+        }
+    }
+    moves.swap(next);
+    if (!moves.empty()) {
+        moveClock.start();
+        if (!moveRunning) {
+            moveRunning = true;
+            scheduler.every(batcher->animationChannel(), AnimationScheduler::frameIntervalMs,
+                            [this]() { return stepMoves(); });
+        }
+    }
+
+    // 连线按新的结构重建：内部节点每个孩子指针一条，B+ 树叶子之间各一个箭头
+    edgeList.clear();
+    for (size_t d = 0; d + 1 < levels.size(); ++d) {
+        for (int n : levels[d])
+            for (int i = 0; i <= model.keyCount(n); ++i) edgeList.push_back(Edge{n, model.child(n, i), i});
+    }
+    if (model.kind() == BTreeModel::BPlusTree && !levels.empty()) {
+        const auto& leaves = levels.back();
+        for (size_t j = 0; j + 1 < leaves.size(); ++j) edgeList.push_back(Edge{leaves[j], leaves[j + 1], -1});
+    }
+    edges->clear();
+    edges->reserve(static_cast<int>(edgeList.size()));
+    for (const Edge& e : edgeList) {
+        QLineF line = edgeLine(e);
+        edges->addEdge(line.p1(), line.p2(), e.slot < 0 ? EdgeLayerItem::Arrow : 0);
+    }
+
+    statusLabel->setText(QString("%1 个键，%2 个节点，高度 %3，每个节点最多 %4 个键")
+                             .arg(model.size()).arg(model.nodeCount()).arg(model.height()).arg(model.maxKeys()));
+
+    // 场景范围跟随布局的包围盒，至少保留 800×500 的初始区域
+    const qreal margin = 40;
+    QRectF bounds(minX - margin, -margin, maxX - minX + 2 * margin,
+                  levels.size() * LevelGap + 2 * margin);
+    scene->setSceneRect(bounds.united(QRectF(-400, -margin, 800, 500)));
+}
+
+bool BTreeWidget::stepMoves() {
+    qreal t = std::min<qreal>(1.0, qreal(moveClock.elapsed()) / MoveDurationMs);
+    for (const Move& m : moves) {
+        if (items[m.node] == m.item) m.item->setPos(m.from + (m.to - m.from) * t);
+    }
+    refreshEdges();
+    if (t < 1.0) return true;
+    moves.clear();
+    moveRunning = false;
+    return false;
+}
+
+void BTreeWidget::refreshEdges() {
+    for (size_t i = 0; i < edgeList.size(); ++i) {
+        QLineF line = edgeLine(edgeList[i]);
+        edges->moveEdge(static_cast<int>(i), line.p1(), line.p2());
+    }
+    edges->commitMoves();
+}
+
+// 孩子指针从父节点第 slot 个格子的左下角连到孩子顶边中点；叶子链表从右端连到下一片叶子的左端
+QLineF BTreeWidget::edgeLine(const Edge& e) const {
+    const BTreeNodeItem* from = items[e.from];
+    const BTreeNodeItem* to = items[e.to];
+    if (e.slot < 0) {
+        qreal y = BTreeNodeItem::CellHeight / 2;
+        return QLineF(from->pos() + QPointF(from->width(), y), to->pos() + QPointF(0, y));
+    }
+    return QLineF(from->pos() + QPointF(e.slot * BTreeNodeItem::CellWidth, BTreeNodeItem::CellHeight),
+                  to->pos() + QPointF(to->width() / 2, 0));
+}
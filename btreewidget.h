@@ -0,0 +1,114 @@
+#ifndef BTREEWIDGET_H
+#define BTREEWIDGET_H
+
+#include <QWidget>
+#include <QColor>
+#include <QElapsedTimer>
+#include <QLineF>
+#include <QPointF>
+#include <vector>
+#include "btreemodel.h"
+#include "btreenodeitem.h"
+#include "scenebatcher.h"
+#include "edgelayeritem.h"
+
+class QGraphicsScene;
+class QGraphicsView;
+class QPushButton;
+class QComboBox;
+class QLineEdit;
+class QSpinBox;
+class QLabel;
+
+// BTreeWidget 是 B 树 / B+ 树的可视化控件：每个节点画成一排键格子，扇出可选。
+// 插入后节点分裂时右半部分从原节点处滑出，删除引起的合并让被并入的节点滑向左兄弟并淡出；
+// B+ 树的叶子之间画出链表箭头，范围查询沿叶子依次点亮结果。“性能测试”比较不同扇出的吞吐量
+class BTreeWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit BTreeWidget(QWidget* parent = nullptr);
+
+    // B 树模型，可脱离界面直接驱动；控件订阅其变更事件并据此绘制
+    BTreeModel& treeModel() { return model; }
+
+private slots:
+    void onConfigChanged();     // 切换 B 树 / B+ 树或扇出，清空树
+    void onInsertKey();
+    void onRemoveKey();
+    void onFindKey();           // 查找并逐层点亮下降路径
+    void onRangeScan();         // 范围查询并逐个点亮结果
+    void onBulkLoad();          // 由随机的有序键批量建树
+    void onRandomKeys();        // 插入一批随机键
+    void onClear();
+    void onBenchmark();         // 比较各扇出下插入、查找、范围扫描、删除的吞吐量
+
+private:
+    static constexpr qreal LevelGap = 80;       // 相邻两层的垂直间距
+    static constexpr qreal LeafGap = 16;        // 相邻叶子之间的水平间距
+    static constexpr int   MoveDurationMs = 300;
+
+    // 一个正在移动的节点：图元被替换后 items[node] 不再指向它，移动随之作废
+    struct Move {
+        int            node;
+        BTreeNodeItem* item;
+        QPointF        from, to;
+    };
+
+    // 一条连线：父节点第 slot 个孩子指针，或 B+ 树叶子链表中 from 到 to 的箭头
+    struct Edge {
+        int  from, to;
+        int  slot;      // 叶子链表为 -1
+    };
+
+    // 一处高亮：恢复前核对图元未被替换
+    struct Mark {
+        int            node;
+        BTreeNodeItem* item;
+        int            cell;
+        QColor         color;
+    };
+
+    QGraphicsScene* scene;
+    QGraphicsView* view;
+    QComboBox* kindBox;     // B 树 / B+ 树
+    QComboBox* fanoutBox;   // 每个节点最多的键数
+    QLineEdit* keyEdit;
+    QLineEdit* hiEdit;      // 范围查询的上界
+    QPushButton* insertButton;
+    QPushButton* removeButton;
+    QPushButton* findButton;
+    QPushButton* rangeButton;
+    QSpinBox*    bulkSpin;
+    QPushButton* bulkButton;
+    QPushButton* randomButton;
+    QPushButton* clearButton;
+    QPushButton* benchButton;
+    QLabel* statusLabel;
+    BTreeModel model;
+    std::vector<BTreeNodeItem*> items;  // 按节点编号存储图元，空闲编号为 nullptr
+    std::vector<int> appearing;         // 本帧新建的节点，布局后淡入
+    std::vector<int> unplaced;          // 没有起始位置的新节点，布局后直接放到目标位置
+    std::vector<Move> moves;
+    std::vector<Edge> edgeList;         // 与边图层中的连线一一对应
+    QElapsedTimer moveClock;
+    bool moveRunning = false;
+    std::vector<Mark> marks;
+    int searchChannel;
+    EdgeLayerItem* edges;
+    SceneBatcher* batcher;  // 合并同一帧内的多次分裂、合并，只布局一次
+
+    void onModelChanged(const BTreeEvent& e);
+    BTreeNodeItem* createItem(int node, const QPointF& start, bool placed);  // placed 为 false 时布局后直接放到目标位置
+    void retireItem(int node, const BTreeNodeItem* into);  // 节点被释放：滑向 into（可为空）并淡出后删除
+    void deleteAllItems();
+    void updateScene();     // 重新布局整棵树，位置变化的节点平移过去，连线随之重建
+    bool stepMoves();
+    void refreshEdges();    // 按图元当前位置移动所有连线
+    QLineF edgeLine(const Edge& e) const;
+    bool readKey(QLineEdit* edit, int& key);
+    void playMarks(int intervalMs);     // 依次点亮 marks 中的格子，最后一处保持一段时间后恢复
+    void clearMarks();
+};
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef CHUNKEDORDER_H
+#define CHUNKEDORDER_H
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+// ChunkedOrder 按顺序保存元素指针，分成若干块，每块记下首元素的序号。
+// 按序号查找是对块的二分 O(log n)；在已知元素之后插入或删除已知元素只移动所在块内的指针，
+// 再更新其后各块的首序号，代价 O(MaxChunk + n / MaxChunk)，不必像连续数组那样整体重排。
+// 元素类型 T 需要有成员 `typename ChunkedOrder<T>::Chunk* chunk`，由本容器维护，指向元素所在的块。
+template <typename T>
+class ChunkedOrder
+{
+public:
+    struct Chunk {
+        std::vector<T*> items;
+        int first = 0;  // items[0] 的序号
+        int pos = 0;    // 在 chunks 中的下标
+    };
+
+    static constexpr int MaxChunk = 512;    // 块超过这么多元素时对半拆开
+
+    int  size() const { return count; }
+    bool empty() const { return count == 0; }
+    void clear() { chunks.clear(); count = 0; }
+    void swap(ChunkedOrder& other) { chunks.swap(other.chunks); std::swap(count, other.count); }
+
+    // 追加到末尾，均摊 O(1)；用于按顺序整体建立
+    void push_back(T* item) {
+        if (chunks.empty() || static_cast<int>(chunks.back()->items.size()) >= MaxChunk)
+            addChunk(static_cast<int>(chunks.size()), count);
+        Chunk* c = chunks.back().get();
+        c->items.push_back(item);
+        item->chunk = c;
+        ++count;
+    }
+
+    // 插到 prev 之后；prev 为空时插到最前面
+    void insertAfter(T* item, const T* prev) {
+        if (chunks.empty()) { push_back(item); return; }
+        Chunk* c = prev ? prev->chunk : chunks.front().get();
+        auto at = prev ? std::find(c->items.begin(), c->items.end(), prev) + 1 : c->items.begin();
+        c->items.insert(at, item);
+        item->chunk = c;
+        ++count;
+        shift(c->pos + 1, 1);
+        if (static_cast<int>(c->items.size()) > MaxChunk) split(c);
+    }
+
+    // 删除元素；块删空时移除，过小时与相邻块合并，避免块数随删除无限增长
+    void erase(T* item) {
+        Chunk* c = item->chunk;
+        c->items.erase(std::find(c->items.begin(), c->items.end(), item));
+        item->chunk = nullptr;
+        --count;
+        shift(c->pos + 1, -1);
+        if (c->items.empty()) { removeChunk(c->pos); return; }
+        int next = c->pos + 1;
+        if (next < static_cast<int>(chunks.size())
+            && c->items.size() + chunks[next]->items.size() <= MaxChunk / 2)
+            merge(c, chunks[next].get());
+        else if (c->pos > 0 && c->items.size() + chunks[c->pos - 1]->items.size() <= MaxChunk / 2)
+            merge(chunks[c->pos - 1].get(), c);
+    }
+
+    // 元素的序号，O(MaxChunk)
+    int rank(const T* item) const {
+        const Chunk* c = item->chunk;
+        return c->first + static_cast<int>(std::find(c->items.begin(), c->items.end(), item) - c->items.begin());
+    }
+
+    // 第 index 个元素，O(log n)
+    T* at(int index) const {
+        const Chunk* c = chunkOf(index);
+        return c->items[index - c->first];
+    }
+
+    // 依次访问序号 first..last 的元素：f(序号, 元素)
+    template <typename F>
+    void forRange(int first, int last, F f) const {
+        if (first > last) return;
+        for (int p = chunkOf(first)->pos, i = first; i <= last; ++p) {
+            const Chunk* c = chunks[p].get();
+            int end = std::min(last, c->first + static_cast<int>(c->items.size()) - 1);
+            for (; i <= end; ++i) f(i, *c->items[i - c->first]);
+        }
+    }
+
+private:
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    int count = 0;
+
+    const Chunk* chunkOf(int index) const {
+        auto it = std::upper_bound(chunks.begin(), chunks.end(), index,
+                                   [](int i, const std::unique_ptr<Chunk>& c) { return i < c->first; });
+        return (it - 1)->get();
+    }
+
+    void shift(int from, int delta) {
+        for (int p = from; p < static_cast<int>(chunks.size()); ++p) chunks[p]->first += delta;
+    }
+
+    void renumber(int from) {
+        for (int p = from; p < static_cast<int>(chunks.size()); ++p) chunks[p]->pos = p;
+    }
+
+    Chunk* addChunk(int pos, int first) {
+        auto c = std::make_unique<Chunk>();
+        c->first = first;
+        Chunk* raw = c.get();
+        chunks.insert(chunks.begin() + pos, std::move(c));
+        renumber(pos);
+        return raw;
+    }
+
+    void removeChunk(int pos) {
+        chunks.erase(chunks.begin() + pos);
+        renumber(pos);
+    }
+
+    void split(Chunk* c) {
+        int keep = static_cast<int>(c->items.size()) / 2;
+        Chunk* half = addChunk(c->pos + 1, c->first + keep);
+        half->items.assign(c->items.begin() + keep, c->items.end());
+        c->items.resize(keep);
+        for (T* t : half->items) t->chunk = half;
+    }
+
+    // 把 b 的元素接到 a 之后并移除 b，b 紧跟在 a 后面
+    void merge(Chunk* a, Chunk* b) {
+        for (T* t : b->items) t->chunk = a;
+        a->items.insert(a->items.end(), b->items.begin(), b->items.end());
+        removeChunk(b->pos);
+    }
+};
+
+#endif
@@ -1,20 +1,21 @@
 #include "DoublyLinkedListWidget.h"
 #include "NodeItem.h"
-#include "ArrowItem.h"
+#include "animationscheduler.h"
+#include "loditems.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
-#include <QGraphicsLineItem>
-#include <QPropertyAnimation>
-#include <QSequentialAnimationGroup>
 #include <QMessageBox>
-#include <QTimer>
 #include <QPen>
+#include <QScrollBar>
+#include <QStyleOptionGraphicsItem>
 #include <cmath>
+#include <algorithm>
+#include <iterator>
 
 // 构造函数，初始化控件并连接信号槽
 DoublyLinkedListWidget::DoublyLinkedListWidget(QWidget* parent)
-    : QWidget(parent), nextNodeId(1)
+    : QWidget(parent), model(LinkedListModel::Doubly)
 {
     auto *vlay = new QVBoxLayout(this);
 
@@ -42,6 +43,15 @@ DoublyLinkedListWidget::DoublyLinkedListWidget(QWidget* parent)
     hlay->addWidget(removeSpecifiedButton);
     hlay->addWidget(clearButton);
     vlay->addLayout(hlay);
+    opBar = new OpLogBar(&model, this);  // 录制/回放操作日志
+    vlay->addWidget(opBar);
+    importBar = new ImportBar(this);    // 从 CSV 或二进制文件批量导入
+    importBar->setJobFactory([this]() { return makeImportJob(); });
+    vlay->addWidget(importBar);
+    // 导入完成时整条链表被替换，录进日志要逐个节点编码，千万级导入会卡住界面，所以录制期间不能导入
+    connect(opBar, &OpLogBar::recordingChanged, importBar, [this](bool recording) {
+        importBar->setBlocked(recording ? "录制期间不能导入，请先停止录制" : QString());
+    });
 
     // 连接信号与槽
     connect(addEndButton, &QPushButton::clicked, this, &DoublyLinkedListWidget::onAddEnd);
@@ -49,29 +59,42 @@ DoublyLinkedListWidget::DoublyLinkedListWidget(QWidget* parent)
     connect(addAfterButton, &QPushButton::clicked, this, &DoublyLinkedListWidget::onAddAfter);
     connect(removeSpecifiedButton, &QPushButton::clicked, this, &DoublyLinkedListWidget::onRemoveSpecified);
     connect(clearButton, &QPushButton::clicked, this, &DoublyLinkedListWidget::onClear);
+
+    pool = std::make_unique<NodeItemPool>(scene);
+    batcher = new SceneBatcher(scene, [this]() { updateScene(); }, this);
+    batcher->setItemPool(pool.get());   // 淡出结束的节点归还图元池
+    overview = new AggregateBlockItem;  // 极度缩小时代替节点绘制的聚合色块
+    scene->addItem(overview);
+    edges = new EdgeLayerItem;  // 所有前向/后向连线由一个图元批量绘制
+    scene->addItem(edges);
+
+    // 拖动平移时把图元重新绑定到视口内的槽位
+    connect(view->horizontalScrollBar(), &QScrollBar::valueChanged, this, &DoublyLinkedListWidget::bindVisible);
+    connect(view->verticalScrollBar(),   &QScrollBar::valueChanged, this, &DoublyLinkedListWidget::bindVisible);
+
+    // 订阅模型变更，所有图元都由模型事件驱动
+    model.changes().subscribe([this](const ListEvent& e) { onModelChanged(e); });
+}
+
+// 模型先于子控件销毁，先停止录制和回放，取消对模型的订阅
+DoublyLinkedListWidget::~DoublyLinkedListWidget() {
+    opBar->stop();
 }
 
 // 在链表末尾添加节点
 void DoublyLinkedListWidget::onAddEnd() {
-    NodeItem* node = new NodeItem(nextNodeId++, nullptr);
-    node->setOpacity(0.0);
-    nodes.push_back(node);
-    scene->addItem(node);
-    animateNodeInsertion(node);
-    QTimer::singleShot(600, this, &DoublyLinkedListWidget::updateScene);
+    model.append();
 }
 
 // 删除链表末尾节点
 void DoublyLinkedListWidget::onRemoveEnd() {
-    if (nodes.empty()) {
+    if (model.empty()) {
         QMessageBox::information(this, "提示", "链表为空！");
         return;
     }
-    int idx = nodes.size() - 1;
-    NodeItem* node = nodes.back();
-    animatePointerTraversal(idx, [=]() {
-        animateNodeDeletion(node, [=]() { updateScene(); });
-        nodes.pop_back();
+    int id = model.back().id;
+    animatePointerTraversal(id, [=]() {
+        model.remove(id);   // 动画期间节点已被其他操作删除时不做任何事
     });
 }
 
@@ -79,16 +102,10 @@ void DoublyLinkedListWidget::onRemoveEnd() {
 void DoublyLinkedListWidget::onAddAfter() {
     bool ok; int target = targetLineEdit->text().toInt(&ok);
     if (!ok) { QMessageBox::warning(this,"输入错误","请输入合法编号"); return; }
-    int pos=-1; for (int i=0;i<(int)nodes.size();++i)
-        if(nodes[i]->getValue()==target){pos=i;break;}
-    if(pos<0){QMessageBox::warning(this,"错误","未找到目标节点");return;}
-    animatePointerTraversal(pos, [=]() {
-        NodeItem* node = new NodeItem(nextNodeId++, nullptr);
-        node->setOpacity(0.0);
-        nodes.insert(nodes.begin()+pos+1, node);
-        scene->addItem(node);
-        animateNodeInsertion(node);
-        updateScene();
+    auto found = nodeIndex.find(target);    // 通过索引 O(1) 查找目标节点
+    if(found==nodeIndex.end()){QMessageBox::warning(this,"错误","未找到目标节点");return;}
+    animatePointerTraversal(target, [=]() {
+        model.insertAfter(target);  // 动画期间目标节点已被删除时返回 -1
     });
     targetLineEdit->clear();
 }
@@ -97,112 +114,218 @@ void DoublyLinkedListWidget::onAddAfter() {
 void DoublyLinkedListWidget::onRemoveSpecified() {
     bool ok; int target = targetLineEdit->text().toInt(&ok);
     if (!ok){ QMessageBox::warning(this,"输入错误","请输入合法编号"); return; }
-    int pos=-1; for(int i=0;i<(int)nodes.size();++i)
-        if(nodes[i]->getValue()==target){pos=i;break;}
-    if(pos<0){ QMessageBox::warning(this,"错误","未找到目标节点"); return;}
-    animatePointerTraversal(pos, [=]() {
-        NodeItem* node = nodes[pos];
-        animateNodeDeletion(node, [=]() {
-            nodes.erase(nodes.begin()+pos);
-            updateScene();
-        });
+    auto found = nodeIndex.find(target);    // 通过索引 O(1) 查找目标节点
+    if(found==nodeIndex.end()){ QMessageBox::warning(this,"错误","未找到目标节点"); return;}
+    animatePointerTraversal(target, [=]() {
+        model.remove(target);
     });
     targetLineEdit->clear();
 }
 
 // 清空链表，移除所有节点和连接
 void DoublyLinkedListWidget::onClear() {
-    for(auto* n: nodes){ scene->removeItem(n); delete n; }
-    for(auto* l: linesFwd){ scene->removeItem(l); delete l; }
-    for(auto* l: linesBwd){ scene->removeItem(l); delete l; }
-    for(auto* a: arrowsFwd){ scene->removeItem(a); delete a; }
-    for(auto* a: arrowsBwd){ scene->removeItem(a); delete a; }
-    nodes.clear(); linesFwd.clear(); linesBwd.clear();
-    arrowsFwd.clear(); arrowsBwd.clear();
-    nextNodeId=1;
+    model.clear();
+}
+
+// 模型变更后同步节点：只记录节点并请求布局，图元在绑定可见槽位时才创建；删除时已绑定的图元淡出
+void DoublyLinkedListWidget::onModelChanged(const ListEvent& e) {
+    switch (e.type) {
+    case ListEvent::Inserted: {
+        auto pos = e.prevId < 0 ? nodes.begin() : std::next(nodeIndex.at(e.prevId));
+        Slot* prev = e.prevId < 0 ? nullptr : &*std::prev(pos);
+        auto it = nodes.insert(pos, Slot{e.id, e.value, nullptr, nullptr, true});
+        nodeIndex[e.id] = it;
+        order.insertAfter(&*it, prev);  // 只改动前驱所在的块
+        freshIds.push_back(e.id);
+        batcher->requestLayout();  // 同一帧内的插入只布局一次
+        break;
+    }
+    case ListEvent::Removed: {
+        auto found = nodeIndex.find(e.id);
+        NodeItem* node = found->second->item;
+        order.erase(&*found->second);
+        nodes.erase(found->second);
+        nodeIndex.erase(found);
+        if (node) batcher->fadeOut(node);
+        else batcher->requestLayout();
+        break;
+    }
+    case ListEvent::Cleared:
+        releaseAll();
+        updateScene();
+        break;
+    case ListEvent::Reset:
+        // 整条链表被替换：导入时槽位已在工作线程中按顺序建好，直接交换；否则按模型重建
+        releaseAll();
+        if (staged) {
+            nodes.swap(staged->nodes);
+            nodeIndex.swap(staged->nodeIndex);
+            order.swap(staged->order);
+        } else {
+            nodeIndex.reserve(model.size());
+            for (const ListNode& n : model) {
+                nodeIndex[n.id] = nodes.insert(nodes.end(), Slot{n.id, n.value});
+                order.push_back(&nodes.back());
+            }
+        }
+        updateScene();
+        break;
+    }
+}
+
+void DoublyLinkedListWidget::releaseAll() {
+    batcher->finishAll();  // 先结束进行中的动画，淡出中的节点随之删除
+    for(Slot& s: nodes) if(s.item) pool->release(s.item);
+    nodes.clear(); nodeIndex.clear(); order.clear();
+    boundIds.clear(); freshIds.clear();
+    edges->clear(); edgeFirst = 0;
+}
+
+// 与单链表相同：工作线程建好暂存链表和槽位，界面线程只交换容器
+ImportJob DoublyLinkedListWidget::makeImportJob() {
+    auto staging = std::make_shared<ImportStaging>(model.kind());
+    ImportJob job;
+    job.consume = [staging](const int* values, std::size_t count, std::string&) {
+        staging->model.appendMany(values, count);
+        return true;
+    };
+    job.prepare = [staging]() {
+        staging->nodeIndex.reserve(staging->model.size());
+        for (const ListNode& n : staging->model) {
+            Slot& s = staging->nodes.emplace_back(Slot{n.id, n.value});
+            staging->nodeIndex[n.id] = std::prev(staging->nodes.end());
+            staging->order.push_back(&s);
+        }
+    };
+    job.commit = [this, staging]() {
+        staged = staging.get();
+        model.adopt(staging->model);
+        staged = nullptr;
+    };
+    return job;
+}
+
+void DoublyLinkedListWidget::showEvent(QShowEvent* ev) {
+    QWidget::showEvent(ev);
+    bindVisible();
+}
+
+void DoublyLinkedListWidget::resizeEvent(QResizeEvent* ev) {
+    QWidget::resizeEvent(ev);
+    bindVisible();
 }
 
-// 更新场景，重新排列节点并更新连线和箭头
+// 更新场景：场景范围和概览色块由槽位公式直接算出，节点图元只在 bindVisible 中定位
 void DoublyLinkedListWidget::updateScene() {
-    // 清除旧连线与箭头
-    for(auto* l: linesFwd){ scene->removeItem(l); delete l; }
-    for(auto* a: arrowsFwd){ scene->removeItem(a); delete a; }
-    for(auto* l: linesBwd){ scene->removeItem(l); delete l; }
-    for(auto* a: arrowsBwd){ scene->removeItem(a); delete a; }
-    linesFwd.clear(); arrowsFwd.clear();
-    linesBwd.clear(); arrowsBwd.clear();
-
-    int n = nodes.size();
+    int n = static_cast<int>(nodes.size());
+
+    // 未绑定的槽位没有图元，场景范围按首尾槽位显式设置
+    QRectF br(slotPos(0), slotPos(std::max(0, n-1)) + QPointF(40,40));
+    scene->setSceneRect(br.adjusted(-20,-20,20,20));
+
+    // 每 64 个节点概括为一个色块，供极度缩小时绘制；色块只由槽位决定，只改槽位数变化波及的末尾色块
+    int count = (n + 63) / 64;
+    overview->resizeBlocks(count);
+    for (int k = std::min(overviewSlots, n) / 64; k < count; ++k)
+        overview->setBlock(k, QRectF(slotPos(k*64), slotPos(std::min(k*64+63, n-1)) + QPointF(40,40)));
+    overview->setBounds(n > 0 ? QRectF(slotPos(0), slotPos(n-1) + QPointF(40,40)) : QRectF());
+    overviewSlots = n;
+
+    bindVisible();
+}
+
+// 只为视口（左右外扩 viewMargin）内的槽位绑定图元，其余图元隐藏后放回备用列表，
+// 场景中的图元数只与视口大小有关，与链表长度无关
+void DoublyLinkedListWidget::bindVisible() {
     const qreal startX=50, gap=100, y=80;
-    for(int i=0;i<n;++i){
-        nodes[i]->setPos(startX + i*gap, y);
+    int n = static_cast<int>(order.size());
+    int first = 0, last = -1;
+    QRectF vis = view->mapToScene(view->viewport()->rect()).boundingRect()
+                     .adjusted(-viewMargin, 0, viewMargin, 0);
+    // 极度缩小时由聚合色块代替，不绑定任何图元
+    bool aggregated = QStyleOptionGraphicsItem::levelOfDetailFromTransform(view->transform()) < Lod::Aggregate;
+    if (!aggregated && vis.bottom() >= y && vis.top() <= y+40) {
+        first = std::max(0, int(std::ceil((vis.left()-startX-40) / gap)));
+        last  = std::min(n-1, int(std::floor((vis.right()-startX) / gap)));
     }
 
-    for(int i=0;i+1<n;++i){
-        drawConnection(nodes[i],   nodes[i+1], true);
-        drawConnection(nodes[i+1], nodes[i],   false);
+    // 回收离开绑定范围的图元
+    std::vector<int> kept;
+    for (int id : boundIds) {
+        auto found = nodeIndex.find(id);
+        if (found == nodeIndex.end() || !found->second->item) continue;
+        Slot& s = *found->second;
+        int index = order.rank(&s);
+        if (index >= first && index <= last) { kept.push_back(id); continue; }
+        pool->release(s.item);
+        s.item = nullptr;
     }
+
+    auto& scheduler = AnimationScheduler::instance();
+    order.forRange(first, last, [&](int i, Slot& s) {
+        if (!s.item) {
+            s.item = pool->acquire(s.value);
+            kept.push_back(s.id);
+            if (s.fresh) {  // 刚插入的节点淡入
+                s.item->setOpacity(0.0);
+                scheduler.animateOpacity(s.item, 0.0, 1.0, 500, batcher->animationChannel());
+            }
+        }
+        s.item->setPos(slotPos(i));
+    });
+    boundIds.swap(kept);
+
+    for (int id : freshIds) {
+        auto found = nodeIndex.find(id);
+        if (found != nodeIndex.end()) found->second->fresh = false;
+    }
+    freshIds.clear();
+
+    syncEdges(first, std::max(0, std::min(last, n-2) - first + 1));
 }
 
-// 绘制连接两个节点的前向或后向连线
-void DoublyLinkedListWidget::drawConnection(NodeItem* a, NodeItem* b, bool forward) {
-    QPointF pa = a->pos() + QPointF(20,20);
-    QPointF pb = b->pos() + QPointF(20,20);
+QPointF DoublyLinkedListWidget::slotPos(int index) const {
+    const qreal startX=50, gap=100, y=80;
+    return QPointF(startX + index*gap, y);
+}
+
+// 连线几何只由槽位决定，绑定范围移动时原地改写已有条目，只在末尾增删差额
+void DoublyLinkedListWidget::syncEdges(int first, int count) {
+    if (first == edgeFirst && 2*count == edges->count()) return;
+    edgeFirst = first;
+    int reuse = std::min(count, edges->count() / 2);
+    for (int k = 0; k < reuse; ++k) {
+        QLineF l = connection(first + k);
+        edges->moveEdge(2*k, l.p1(), l.p2());       // 前向指针
+        edges->moveEdge(2*k + 1, l.p2(), l.p1());   // 后向指针
+    }
+    if (reuse > 0) edges->commitMoves();
+    if (edges->count() > 2*count) edges->removeLast(edges->count() - 2*count);
+    while (edges->count() < 2*count) {
+        QLineF l = connection(first + edges->count() / 2);
+        edges->addEdge(l.p1(), l.p2());
+        edges->addEdge(l.p2(), l.p1());
+    }
+}
+
+// 第 index 个槽位与下一个槽位之间的连线，两端各缩进一个半径
+QLineF DoublyLinkedListWidget::connection(int index) const {
+    QPointF pa = slotPos(index) + QPointF(20,20);
+    QPointF pb = slotPos(index+1) + QPointF(20,20);
     qreal ang = std::atan2(pb.y()-pa.y(), pb.x()-pa.x());
     constexpr qreal R=20;
     QPointF aEdge = pa + QPointF(std::cos(ang)*R, std::sin(ang)*R);
     QPointF bEdge = pb - QPointF(std::cos(ang)*R, std::sin(ang)*R);
+    return QLineF(aEdge, bEdge);
+}
 
-    auto *line = new QGraphicsLineItem(QLineF(aEdge,bEdge));
-    line->setPen(QPen(Qt::black,2));
-    scene->addItem(line);
-    if(forward) linesFwd.push_back(line);
-    else         linesBwd.push_back(line);
-
-    QPolygonF tri;
-    tri << QPointF(0,0) << QPointF(-8,-5) << QPointF(-8,5);
-    auto *arrow = new ArrowItem(tri);
-    arrow->setBrush(Qt::black);
-    arrow->setPos(bEdge);
-    arrow->setRotation(ang * 180.0/M_PI);
-    scene->addItem(arrow);
-    if(forward) arrowsFwd.push_back(arrow);
-    else         arrowsBwd.push_back(arrow);
-}
-
-// 动画展示指针遍历到目标节点
-void DoublyLinkedListWidget::animatePointerTraversal(int targetIndex, std::function<void()> callback) {
-    if (nodes.empty() || targetIndex < 0 || targetIndex >= (int)nodes.size()) {
+// 动画展示指针遍历到目标节点，结束后执行回调；由全局调度器在下一帧触发
+void DoublyLinkedListWidget::animatePointerTraversal(int targetId, std::function<void()> callback) {
+    if (nodes.empty() || !nodeIndex.count(targetId)) {
         if (callback) callback();
         return;
     }
-    QSequentialAnimationGroup* group = new QSequentialAnimationGroup(this);
-    connect(group, &QSequentialAnimationGroup::finished, this, [=]() {
+    AnimationScheduler::instance().after(batcher->animationChannel(), 0, [=]() {
         if (callback) callback();
     });
-    group->start(QAbstractAnimation::DeleteWhenStopped);
-}
-
-// 节点插入时的动画效果
-void DoublyLinkedListWidget::animateNodeInsertion(NodeItem* node) {
-    auto *anim = new QPropertyAnimation(node, "opacity");
-    anim->setDuration(500);
-    anim->setStartValue(0.0);
-    anim->setEndValue(1.0);
-    anim->start(QAbstractAnimation::DeleteWhenStopped);
-}
-
-// 节点删除时的动画效果
-void DoublyLinkedListWidget::animateNodeDeletion(NodeItem* node, std::function<void()> callback) {
-    auto *anim = new QPropertyAnimation(node, "opacity");
-    anim->setDuration(500);
-    anim->setStartValue(1.0);
-    anim->setEndValue(0.0);
-    connect(anim, &QPropertyAnimation::finished, this, [=]() {
-        scene->removeItem(node);
-        delete node;
-        if (callback) callback();
-    });
-    anim->start(QAbstractAnimation::DeleteWhenStopped);
 }
-
@@ -6,10 +6,20 @@
 #include <QGraphicsView>
 #include <QLineEdit>
 #include <QPushButton>
-#include <QGraphicsLineItem>
+#include <QLineF>
 #include "NodeItem.h"
-#include "ArrowItem.h"
+#include "edgelayeritem.h"
+#include "linkedlistmodel.h"
+#include "scenebatcher.h"
+#include "loditems.h"
+#include "nodeitempool.h"
+#include "oplogbar.h"
+#include "importbar.h"
+#include "chunkedorder.h"
+#include <memory>
 #include <vector>
+#include <list>
+#include <unordered_map>
 #include <functional>
 
 // DoublyLinkedListWidget 类用于展示双向链表的可视化控件，提供节点的插入、删除、清空等操作
@@ -18,6 +28,16 @@ class DoublyLinkedListWidget : public QWidget
     Q_OBJECT
 public:
     explicit DoublyLinkedListWidget(QWidget* parent = nullptr);
+    ~DoublyLinkedListWidget() override;
+
+    // 链表模型，可脱离界面直接驱动；控件订阅其变更事件并据此绘制
+    LinkedListModel& listModel() { return model; }
+
+    int materializedCount() const { return static_cast<int>(boundIds.size()); }  // 当前绑定了图元的节点数
+
+protected:
+    void showEvent(QShowEvent* ev) override;
+    void resizeEvent(QResizeEvent* ev) override;
 
 private slots:
     void onAddEnd();    // 在链表尾部插入节点槽函数
@@ -25,8 +45,29 @@ private slots:
     void onAddAfter();  // 在指定节点后插入新节点槽函数
     void onRemoveSpecified();   // 删除指定节点槽函数
     void onClear(); // 清空双向链表槽函数
+    void bindVisible();     // 把图元绑定到视口内的槽位，回收离开视口的图元
 
 private:
+    // 显示中的一个节点：只有在视口（外扩一圈）内时才绑定图元
+    struct Slot {
+        int id;
+        int value;
+        NodeItem* item = nullptr;
+        ChunkedOrder<Slot>::Chunk* chunk = nullptr;    // 在 order 中所在的块，由 order 维护
+        bool fresh = false;     // 刚插入，绑定图元时淡入
+    };
+
+    // 导入时在工作线程中构建的链表和槽位，完成后在 Reset 事件中整体换入
+    struct ImportStaging {
+        explicit ImportStaging(LinkedListModel::Kind kind) : model(kind) {}
+        LinkedListModel model;
+        std::list<Slot> nodes;
+        std::unordered_map<int, std::list<Slot>::iterator> nodeIndex;
+        ChunkedOrder<Slot> order;
+    };
+
+    static constexpr qreal viewMargin = 400;   // 视口左右各外扩这么宽的场景坐标
+
     QGraphicsScene* scene;
     QGraphicsView*  view;
     QLineEdit*      targetLineEdit;
@@ -36,17 +77,32 @@ private:
     QPushButton*    removeSpecifiedButton;
     QPushButton*    clearButton;
 
-    std::vector<NodeItem*> nodes;  // 存储链表节点的容器
-    std::vector<QGraphicsLineItem*> linesFwd, linesBwd; // 存储前向和后向连线的容器
-    std::vector<ArrowItem*> arrowsFwd, arrowsBwd;    // 存储前向和后向箭头的容器
-    int nextNodeId;
+    LinkedListModel model;  // 链表数据，与图元解耦
+    OpLogBar* opBar;        // 录制/回放操作日志
+    ImportBar* importBar;   // 从文件批量导入
+    ImportStaging* staged = nullptr;    // 正在换入的导入结果，只在 adopt 期间非空
+    std::list<Slot> nodes;  // 按链表顺序存储节点，支持 O(1) 插入/删除
+    std::unordered_map<int, std::list<Slot>::iterator> nodeIndex;  // 节点编号 -> 节点位置
+    ChunkedOrder<Slot> order;   // 按槽位顺序的节点，增删只改动所在的块，按槽位查找 O(log n)
+    std::vector<int> boundIds;  // 绑定了图元的节点编号
+    std::vector<int> freshIds;  // 尚未绑定过的新节点编号
+    std::unique_ptr<NodeItemPool> pool; // 节点图元池：离开视口或删除的图元回收复用
+    // 边图层：只含绑定范围内的连线，第 2k、2k+1 条分别是第 edgeFirst+k 个槽位与下一个槽位间的前向、后向指针
+    EdgeLayerItem* edges;
+    int edgeFirst = 0;
+    SceneBatcher* batcher;  // 合并同一帧内的布局和淡入/淡出动画
+    AggregateBlockItem* overview;  // 聚合色块，用于极度缩小时的概览
+    int overviewSlots = 0;  // 概览色块对应的槽位数；色块只由槽位决定，槽位数变化时只改末尾的色块
 
 
-    void updateScene(); // 重新绘制/更新整个场景
-    void drawConnection(NodeItem* a, NodeItem* b, bool forward);    // 绘制连接节点的前向/后向连线
-    void animatePointerTraversal(int targetIndex, std::function<void()> callback);  // 动画展示指针遍历过程
-    void animateNodeInsertion(NodeItem* node);  // 节点插入动画
-    void animateNodeDeletion(NodeItem* node, std::function<void()> callback);   // 节点删除动画，删除后执行回调函数
+    void onModelChanged(const ListEvent& e);    // 根据模型变更事件增删图元
+    ImportJob makeImportJob();  // 为一次导入准备暂存模型
+    void releaseAll();  // 回收所有图元和连线，清空槽位
+    void updateScene(); // 更新场景范围和概览色块，再重新绑定可见槽位
+    QPointF slotPos(int index) const;   // 第 index 个槽位的节点位置
+    QLineF connection(int index) const; // 第 index 个槽位指向下一个槽位的前向连线，后向连线为其反向
+    void syncEdges(int first, int count);   // 让边图层恰好包含从 first 开始的 count 对连线
+    void animatePointerTraversal(int targetId, std::function<void()> callback);  // 动画展示指针遍历过程
 };
 
 #endif
@@ -0,0 +1,216 @@
+#include "edgelayeritem.h"
+#include "loditems.h"
+#include <QPainter>
+#include <QPainterPath>
+#include <QStyleOptionGraphicsItem>
+#include <QVector>
+#include <algorithm>
+#include <cmath>
+
+EdgeLayerItem::EdgeLayerItem(QGraphicsItem* parent)
+    : QGraphicsItem(parent)
+{
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);  // 需要 exposedRect 裁剪不可见的连线
+}
+
+int EdgeLayerItem::addEdge(const QPointF& from, const QPointF& to, quint8 flags) {
+    Edge e{float(from.x()), float(from.y()), float(to.x()), float(to.y()), flags};
+    QRectF r = edgeRect(e);
+    growBounds(r);
+    edges.push_back(e);
+    if (!indexDirty) indexEdge(count() - 1);
+    update(r);
+    return count() - 1;
+}
+
+void EdgeLayerItem::setEdge(int index, const QPointF& from, const QPointF& to) {
+    Edge& e = edges[index];
+    QRectF old = edgeRect(e);
+    if (!indexDirty) unindexEdge(index);
+    e.x1 = float(from.x()); e.y1 = float(from.y());
+    e.x2 = float(to.x());   e.y2 = float(to.y());
+    if (!indexDirty) indexEdge(index);
+    QRectF r = edgeRect(e);
+    growBounds(r);
+    update(old);    // 只刷新新旧两处区域
+    update(r);
+}
+
+void EdgeLayerItem::moveEdge(int index, const QPointF& from, const QPointF& to) {
+    Edge& e = edges[index];
+    e.x1 = float(from.x()); e.y1 = float(from.y());
+    e.x2 = float(to.x());   e.y2 = float(to.y());
+    indexDirty = true;
+}
+
+// 包围盒延迟重新计算，网格索引整体重建，整个图层刷新一次
+void EdgeLayerItem::commitMoves() {
+    prepareGeometryChange();
+    boundsDirty = true;
+    rebuildIndex();
+    update();
+}
+
+void EdgeLayerItem::setEdgeFlags(int index, quint8 flags) {
+    if (edges[index].flags == flags) return;
+    edges[index].flags = flags;
+    update(edgeRect(edges[index]));
+}
+
+void EdgeLayerItem::removeLast(int n) {
+    n = std::min(n, count());
+    if (n <= 0) return;
+    for (int i = count() - n; i < count(); ++i) {
+        update(edgeRect(edges[i]));
+        if (!indexDirty) unindexEdge(i);
+    }
+    prepareGeometryChange();
+    edges.resize(edges.size() - n);
+    boundsDirty = true;
+}
+
+void EdgeLayerItem::clear() {
+    prepareGeometryChange();
+    edges.clear();
+    cells.clear();
+    wide.clear();
+    indexDirty = false;
+    bounds = QRectF();
+    boundsDirty = false;
+}
+
+// 包围盒只在需要扩大时通知场景；删除连线后延迟到下次查询时重新计算
+void EdgeLayerItem::growBounds(const QRectF& r) {
+    if (boundsDirty) {
+        prepareGeometryChange();
+    } else if (!bounds.contains(r)) {
+        prepareGeometryChange();
+        bounds |= r;
+    }
+}
+
+QRectF EdgeLayerItem::boundingRect() const {
+    if (boundsDirty) {
+        bounds = QRectF();
+        for (const Edge& e : edges) bounds |= edgeRect(e);
+        boundsDirty = false;
+    }
+    return bounds;
+}
+
+// 连线包围盒，外扩箭头和画笔的宽度
+QRectF EdgeLayerItem::edgeRect(const Edge& e) const {
+    return QRectF(QPointF(std::min(e.x1, e.x2), std::min(e.y1, e.y2)),
+                  QPointF(std::max(e.x1, e.x2), std::max(e.y1, e.y2))).adjusted(-8, -8, 8, 8);
+}
+
+// 包围盒所覆盖的格子，坐标夹在 ±2^30 之内
+EdgeLayerItem::CellRange EdgeLayerItem::cellsOf(const QRectF& r) {
+    auto cell = [](qreal v) { return int(qBound<qreal>(-(1 << 30), std::floor(v / CellSize), 1 << 30)); };
+    return CellRange{cell(r.left()), cell(r.top()), cell(r.right()), cell(r.bottom())};
+}
+
+void EdgeLayerItem::indexEdge(int index) {
+    CellRange c = cellsOf(edgeRect(edges[index]));
+    if (isWide(c)) { wide.push_back(index); return; }
+    for (int y = c.y0; y <= c.y1; ++y)
+        for (int x = c.x0; x <= c.x1; ++x) cells[cellKey(x, y)].push_back(index);
+}
+
+// 从所在格子中删除下标：用格子末尾的下标覆盖，格子删空时一并移除
+void EdgeLayerItem::unindexEdge(int index) {
+    auto erase = [index](std::vector<int>& list) {
+        auto it = std::find(list.begin(), list.end(), index);
+        if (it == list.end()) return;
+        *it = list.back();
+        list.pop_back();
+    };
+    CellRange c = cellsOf(edgeRect(edges[index]));
+    if (isWide(c)) { erase(wide); return; }
+    for (int y = c.y0; y <= c.y1; ++y)
+        for (int x = c.x0; x <= c.x1; ++x) {
+            auto found = cells.find(cellKey(x, y));
+            if (found == cells.end()) continue;
+            erase(found->second);
+            if (found->second.empty()) cells.erase(found);
+        }
+}
+
+// 每帧整体移动时格子大多不变：先清空各格保留其容量，重新登记后再删掉空格
+void EdgeLayerItem::rebuildIndex() {
+    for (auto& cell : cells) cell.second.clear();
+    wide.clear();
+    indexDirty = false;
+    for (int i = 0; i < count(); ++i) indexEdge(i);
+    for (auto it = cells.begin(); it != cells.end(); ) {
+        if (it->second.empty()) it = cells.erase(it);
+        else ++it;
+    }
+}
+
+void EdgeLayerItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget*) {
+    qreal lod = Lod::levelOf(option, painter);
+    if (edges.empty() || lod < Lod::Aggregate) return;  // 极度缩小时由聚合色块代替
+    bool detailed = lod >= Lod::Detail;
+    if (!detailed) painter->setRenderHint(QPainter::Antialiasing, false);
+    if (indexDirty) rebuildIndex();
+
+    // 一趟把可见连线分到常规和高亮两组：只访问与暴露区域相交的格子。
+    // 跨多个格子的连线只在它与暴露区域重叠部分的左上角格子中处理一次
+    const QRectF& exposed = option->exposedRect;
+    CellRange q = cellsOf(exposed);
+    QVector<QLineF> lines[2];
+    QPainterPath heads[2];
+    auto visit = [&](int i, const CellRange* owner) {
+        const Edge& e = edges[i];
+        QRectF r = edgeRect(e);
+        if (owner) {
+            CellRange c = cellsOf(r);
+            if (std::max(c.x0, q.x0) != owner->x0 || std::max(c.y0, q.y0) != owner->y0) return;
+        }
+        if (!r.intersects(exposed)) return;
+        int group = (e.flags & Highlight) ? 1 : 0;
+        lines[group].append(QLineF(e.x1, e.y1, e.x2, e.y2));
+        if (!detailed || !(e.flags & Arrow)) return;
+
+        // 箭头：尖端在终点，长 8、半宽 5，与原来的三角形一致
+        qreal dx = e.x2 - e.x1, dy = e.y2 - e.y1;
+        qreal len = std::hypot(dx, dy);
+        if (len <= 0) return;
+        QPointF dir(dx / len, dy / len), normal(-dir.y(), dir.x());
+        QPointF tip(e.x2, e.y2), base = tip - dir * 8;
+        QPainterPath& path = heads[group];
+        path.moveTo(tip);
+        path.lineTo(base + normal * 5);
+        path.lineTo(base - normal * 5);
+        path.closeSubpath();
+    };
+    auto visitCell = [&](int x, int y, const std::vector<int>& list) {
+        CellRange owner{x, y, x, y};
+        for (int i : list) visit(i, &owner);
+    };
+    // 暴露区域覆盖的格子比已登记的格子还多时（例如缩小后整屏刷新），改为遍历已登记的格子
+    if (qint64(q.x1 - q.x0 + 1) * (q.y1 - q.y0 + 1) <= qint64(cells.size())) {
+        for (int y = q.y0; y <= q.y1; ++y)
+            for (int x = q.x0; x <= q.x1; ++x) {
+                auto found = cells.find(cellKey(x, y));
+                if (found != cells.end()) visitCell(x, y, found->second);
+            }
+    } else {
+        for (const auto& [key, list] : cells) {
+            int x = int(quint32(key >> 32)), y = int(quint32(key));
+            if (x >= q.x0 && x <= q.x1 && y >= q.y0 && y <= q.y1) visitCell(x, y, list);
+        }
+    }
+    for (int i : wide) visit(i, nullptr);
+
+    for (int group = 0; group < 2; ++group) {
+        if (lines[group].isEmpty()) continue;
+        QPen pen = group ? highlightPen : normalPen;
+        if (!detailed) pen.setWidth(0);  // 缩小时用 1px 细线
+        painter->setPen(pen);
+        painter->drawLines(lines[group]);
+        heads[group].setFillRule(Qt::WindingFill);
+        if (!heads[group].isEmpty()) painter->fillPath(heads[group], pen.color());
+    }
+}
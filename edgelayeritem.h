@@ -0,0 +1,83 @@
+#ifndef EDGELAYERITEM_H
+#define EDGELAYERITEM_H
+
+#include <QGraphicsItem>
+#include <QPen>
+#include <QRectF>
+#include <unordered_map>
+#include <vector>
+
+// EdgeLayerItem 是一个控件内所有连线的“边图层”：
+// 连线几何存放在连续数组中（每条约 20 字节），绘制时一次 drawLines 画完所有可见连线，
+// 所有箭头合并成一条路径一次填充，不再为每条连线和箭头各建一个图元。
+// 连线按包围盒登记在粗网格中，绘制时只访问与暴露区域相交的格子里的连线，局部刷新的代价与连线总数无关。
+class EdgeLayerItem : public QGraphicsItem
+{
+public:
+    enum EdgeFlag : quint8 {
+        Arrow     = 0x1,    // 在终点画箭头
+        Highlight = 0x2,    // 使用高亮画笔
+    };
+
+    explicit EdgeLayerItem(QGraphicsItem* parent = nullptr);
+
+    int  addEdge(const QPointF& from, const QPointF& to, quint8 flags = Arrow);    // 追加连线，返回下标
+    void setEdge(int index, const QPointF& from, const QPointF& to);              // 修改一条连线，只刷新其所在区域
+    // 批量移动：只改几何不通知场景，全部改完后调用一次 commitMoves()，此时整体重建网格索引。
+    // 用于力导向布局等每帧移动大量连线的场合
+    void moveEdge(int index, const QPointF& from, const QPointF& to);
+    void commitMoves();
+    void setEdgeFlags(int index, quint8 flags);
+    quint8 edgeFlags(int index) const { return edges[index].flags; }
+    void removeLast(int count = 1);     // 删除末尾 count 条连线
+    void clear();
+    int  count() const { return static_cast<int>(edges.size()); }
+    int  capacity() const { return static_cast<int>(edges.capacity()); }    // 数组容量，多出 count() 的部分为余量
+    void reserve(int n) { edges.reserve(n); }
+
+    void setPen(const QPen& pen) { normalPen = pen; update(); }
+    void setHighlightPen(const QPen& pen) { highlightPen = pen; update(); }
+
+    QRectF boundingRect() const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override;
+
+private:
+    // 紧凑的连线记录：端点用 float 存储
+    struct Edge {
+        float x1, y1, x2, y2;
+        quint8 flags;
+    };
+
+public:
+    // 单条连线记录的大小，不含数组余量和图元本身；实际每条连线的堆占用见“性能测试 → 连线内存”
+    static constexpr int recordBytes = sizeof(Edge);
+
+private:
+    // 网格索引：场景按 CellSize 划成格子，每格记下包围盒与之相交的连线下标；
+    // 跨越超过 MaxCellsPerEdge 个格子的长连线放进 wide，每次绘制都单独检查
+    static constexpr qreal CellSize = 256;
+    static constexpr int   MaxCellsPerEdge = 64;
+    struct CellRange { int x0, y0, x1, y1; };
+
+    QRectF edgeRect(const Edge& e) const;   // 单条连线（含箭头）的包围盒
+    void   growBounds(const QRectF& r);
+    static CellRange cellsOf(const QRectF& r);
+    static quint64 cellKey(int x, int y) { return (quint64(quint32(x)) << 32) | quint32(y); }
+    static bool isWide(const CellRange& c) {
+        return qint64(c.x1 - c.x0 + 1) * (c.y1 - c.y0 + 1) > MaxCellsPerEdge;
+    }
+    void   indexEdge(int index);    // 按当前几何登记到网格
+    void   unindexEdge(int index);  // 按当前几何从网格中删除，须在改动几何之前调用
+    void   rebuildIndex();
+
+    std::vector<Edge> edges;
+    std::unordered_map<quint64, std::vector<int>> cells;
+    std::vector<int> wide;
+    bool indexDirty = false;    // moveEdge 之后网格已过期，commitMoves 或下次绘制时重建
+    QPen normalPen{Qt::black, 2};
+    QPen highlightPen{Qt::red, 2};
+    mutable QRectF bounds;
+    mutable bool boundsDirty = false;   // 删除连线后包围盒需要重新计算
+};
+
+#endif
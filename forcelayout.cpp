@@ -0,0 +1,172 @@
+#include "forcelayout.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr double MinHalf = 1e-3;    // 区域小于该值时不再细分，重合的顶点合并在同一个叶子中
+}
+
+ForceLayout::ForceLayout(std::vector<double> x, std::vector<double> y,
+                         std::vector<std::pair<int, int>> edgeList, const Params& p)
+    : params(p), px(std::move(x)), py(std::move(y)), edges(std::move(edgeList)),
+      temperature(p.initialStep)
+{
+    int n = vertexCount();
+    py.resize(n);
+    dx.resize(n);
+    dy.resize(n);
+    edges.erase(std::remove_if(edges.begin(), edges.end(), [n](const std::pair<int, int>& e) {
+        return e.first == e.second || e.first < 0 || e.second < 0 || e.first >= n || e.second >= n;
+    }), edges.end());
+}
+
+double ForceLayout::step() {
+    int n = vertexCount();
+    if (n == 0) {
+        temperature = 0;
+        return 0;
+    }
+    const double L = params.idealLength;
+    buildTree();
+
+    // 斥力（Barnes–Hut 近似）和指向重心的引力
+    const QuadNode& root = tree[0];
+    for (int v = 0; v < n; ++v) {
+        double fx = 0, fy = 0;
+        repulsion(v, fx, fy);
+        fx += (root.mx - px[v]) * params.gravity;
+        fy += (root.my - py[v]) * params.gravity;
+        dx[v] = fx;
+        dy[v] = fy;
+    }
+
+    // 弹簧引力：大小为 d^2 / L
+    for (const auto& [a, b] : edges) {
+        double ex = px[b] - px[a];
+        double ey = py[b] - py[a];
+        double d = std::sqrt(ex * ex + ey * ey);
+        if (d < 1e-9) continue;
+        double f = d / L;   // (d^2 / L) / d
+        dx[a] += ex * f; dy[a] += ey * f;
+        dx[b] -= ex * f; dy[b] -= ey * f;
+    }
+
+    // 按温度限制位移
+    double maxMove = 0;
+    for (int v = 0; v < n; ++v) {
+        double len = std::sqrt(dx[v] * dx[v] + dy[v] * dy[v]);
+        if (len < 1e-12) continue;
+        double move = std::min(len, temperature);
+        px[v] += dx[v] / len * move;
+        py[v] += dy[v] / len * move;
+        maxMove = std::max(maxMove, move);
+    }
+    temperature *= params.cooling;
+    ++m_iterations;
+    return maxMove;
+}
+
+// 按当前坐标重建四叉树，节点池复用上一次迭代的内存
+void ForceLayout::buildTree() {
+    int n = vertexCount();
+    double x0 = px[0], x1 = px[0], y0 = py[0], y1 = py[0];
+    for (int v = 1; v < n; ++v) {
+        x0 = std::min(x0, px[v]); x1 = std::max(x1, px[v]);
+        y0 = std::min(y0, py[v]); y1 = std::max(y1, py[v]);
+    }
+    tree.clear();
+    tree.reserve(2 * n + 1);
+    QuadNode root;
+    root.cx = (x0 + x1) / 2;
+    root.cy = (y0 + y1) / 2;
+    root.half = std::max({x1 - x0, y1 - y0, 1.0}) / 2 + 1;
+    tree.push_back(root);
+    for (int v = 0; v < n; ++v) insert(v);
+}
+
+// 自顶向下插入顶点，沿途累加质量和质心；遇到已有顶点的叶子时把它细分成四个孩子
+void ForceLayout::insert(int v) {
+    const double x = px[v], y = py[v];
+    int node = 0;
+    for (;;) {
+        QuadNode& q = tree[node];
+        if (q.child < 0) {
+            if (q.mass == 0) {  // 空叶子
+                q.body = v;
+                q.mass = 1;
+                q.mx = x;
+                q.my = y;
+                return;
+            }
+            if (q.half < MinHalf) {     // 重合的顶点合并在同一个叶子中
+                q.mx = (q.mx * q.mass + x) / (q.mass + 1);
+                q.my = (q.my * q.mass + y) / (q.mass + 1);
+                q.mass += 1;
+                return;
+            }
+            // 细分：原有顶点移入对应的孩子
+            int first = static_cast<int>(tree.size());
+            double h = q.half / 2, cx = q.cx, cy = q.cy;
+            int old = q.body;
+            double ox = q.mx, oy = q.my;
+            for (int k = 0; k < 4; ++k) {
+                QuadNode c;
+                c.cx = cx + ((k & 1) ? h : -h);
+                c.cy = cy + ((k & 2) ? h : -h);
+                c.half = h;
+                tree.push_back(c);
+            }
+            QuadNode& parent = tree[node];  // push_back 之后重新取引用
+            parent.child = first;
+            parent.body = -1;
+            QuadNode& moved = tree[first + (ox >= cx ? 1 : 0) + (oy >= cy ? 2 : 0)];
+            moved.body = old;
+            moved.mass = 1;
+            moved.mx = ox;
+            moved.my = oy;
+        }
+        QuadNode& q2 = tree[node];
+        q2.mx = (q2.mx * q2.mass + x) / (q2.mass + 1);
+        q2.my = (q2.my * q2.mass + y) / (q2.mass + 1);
+        q2.mass += 1;
+        node = q2.child + (x >= q2.cx ? 1 : 0) + (y >= q2.cy ? 2 : 0);
+    }
+}
+
+// 计算顶点 v 受到的斥力，大小为 L^2 * mass / d。
+// 区域边长与距离之比小于 theta 时把整个区域当作位于质心的一个质点
+void ForceLayout::repulsion(int v, double& fx, double& fy) const {
+    const double k2 = params.idealLength * params.idealLength;
+    const double theta2 = params.theta * params.theta;
+    const double x = px[v], y = py[v];
+    constexpr int Capacity = 256;
+    int stack[Capacity];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const QuadNode& q = tree[stack[--top]];
+        if (q.mass == 0) continue;
+        double ex = x - q.mx;
+        double ey = y - q.my;
+        double d2 = ex * ex + ey * ey;
+        bool leaf = q.child < 0;
+        double size = 2 * q.half;
+        // 包含 v 自身的区域总是展开；栈满时（极深的退化区域）也按质点近似
+        bool inside = std::abs(x - q.cx) <= q.half && std::abs(y - q.cy) <= q.half;
+        if (leaf || (!inside && size * size < theta2 * d2) || top + 4 > Capacity) {
+            double mass = q.mass - (leaf && q.body == v ? 1 : 0);   // 不计自身
+            if (mass <= 0) continue;
+            if (d2 < 1e-6) {
+                // 与其他顶点重合：按编号错开一个小位移，避免除零
+                ex = std::cos(v * 2.399963);
+                ey = std::sin(v * 2.399963);
+                d2 = 1;
+            }
+            double f = k2 * mass / d2;  // (L^2 * mass / d) / d
+            fx += ex * f;
+            fy += ey * f;
+        } else {
+            for (int k = 0; k < 4; ++k) stack[top++] = q.child + k;
+        }
+    }
+}
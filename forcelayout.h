@@ -0,0 +1,62 @@
+#ifndef FORCELAYOUT_H
+#define FORCELAYOUT_H
+
+#include <utility>
+#include <vector>
+
+// 力导向布局的参数
+struct ForceLayoutParams {
+    double idealLength = 100;   // 弹簧的理想长度
+    double theta = 0.8;         // Barnes–Hut 开角，越小越精确
+    double gravity = 0.02;      // 指向重心的引力系数
+    double initialStep = 60;    // 初始最大位移（温度）
+    double cooling = 0.97;      // 每次迭代温度的衰减
+    double minStep = 0.5;       // 温度低于该值视为收敛
+};
+
+// ForceLayout 是不依赖 Qt 的力导向布局引擎（Fruchterman–Reingold 模型）：
+// 相连的顶点之间有弹簧引力，所有顶点之间有斥力，另加指向重心的弱引力让不连通的部分不会飘散。
+// 斥力用 Barnes–Hut 四叉树近似：距离足够远的一团顶点按其质心和总质量计算，
+// 每次迭代 O(n log n)，五万个顶点、十五万条边的一次迭代约一百毫秒。
+// 引擎只负责计算，可以放在工作线程中运行。
+class ForceLayout
+{
+public:
+    using Params = ForceLayoutParams;
+
+    ForceLayout() = default;
+    // x/y 为初始坐标，edges 为顶点编号对（自环会被忽略）
+    ForceLayout(std::vector<double> x, std::vector<double> y,
+                std::vector<std::pair<int, int>> edges, const Params& params = Params());
+
+    double step();              // 迭代一次，返回本次最大位移
+    bool   converged() const { return temperature < params.minStep; }
+    int    iterations() const { return m_iterations; }
+    int    vertexCount() const { return static_cast<int>(px.size()); }
+    const std::vector<double>& x() const { return px; }
+    const std::vector<double>& y() const { return py; }
+
+private:
+    // 四叉树节点：叶子保存一个顶点，内部节点的四个孩子在节点数组中连续存放
+    struct QuadNode {
+        double cx, cy, half;    // 正方形区域的中心和半边长
+        double mx = 0, my = 0;  // 质心
+        double mass = 0;        // 包含的顶点数
+        int    child = -1;      // 第一个孩子的下标，叶子为 -1
+        int    body = -1;       // 叶子中的顶点编号
+    };
+
+    void buildTree();
+    void insert(int v);
+    void repulsion(int v, double& fx, double& fy) const;
+
+    Params params;
+    std::vector<double> px, py;     // 顶点坐标
+    std::vector<double> dx, dy;     // 本次迭代的合力
+    std::vector<std::pair<int, int>> edges;
+    std::vector<QuadNode> tree;     // 四叉树节点池，每次迭代重建
+    double temperature = 0;
+    int    m_iterations = 0;
+};
+
+#endif
@@ -0,0 +1,30 @@
+#include "forcelayoutthread.h"
+#include <QElapsedTimer>
+
+ForceLayoutThread::ForceLayoutThread(ForceLayout layout, int generation, QObject* parent)
+    : QThread(parent), layout(std::move(layout)), generation(generation)
+{
+    qRegisterMetaType<QVector<QPointF>>("QVector<QPointF>");
+}
+
+void ForceLayoutThread::run() {
+    QElapsedTimer clock;
+    clock.start();
+    while (!isInterruptionRequested() && !layout.converged()) {
+        layout.step();
+        if (clock.elapsed() >= snapshotIntervalMs && !snapshotPending) {
+            emitSnapshot(false);
+            clock.restart();
+        }
+    }
+    if (!isInterruptionRequested()) emitSnapshot(true);
+}
+
+void ForceLayoutThread::emitSnapshot(bool finished) {
+    const auto& x = layout.x();
+    const auto& y = layout.y();
+    QVector<QPointF> positions(layout.vertexCount());
+    for (int v = 0; v < positions.size(); ++v) positions[v] = QPointF(x[v], y[v]);
+    snapshotPending = true;
+    emit snapshotReady(generation, positions, finished);
+}
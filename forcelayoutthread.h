@@ -0,0 +1,38 @@
+#ifndef FORCELAYOUTTHREAD_H
+#define FORCELAYOUTTHREAD_H
+
+#include <QThread>
+#include <QVector>
+#include <QPointF>
+#include <atomic>
+#include "forcelayout.h"
+
+// 在工作线程中迭代力导向布局，并把坐标快照流式地发回界面线程。
+// 界面处理完一份快照（ackSnapshot）之前不会发出下一份，界面较慢时中间结果被跳过而不是堆积；
+// 收敛后发出最后一份快照（finished 为 true）并结束；被 requestInterruption() 打断时直接结束，不再发出快照。
+class ForceLayoutThread : public QThread
+{
+    Q_OBJECT
+public:
+    static constexpr int snapshotIntervalMs = 16;   // 约一帧发一次快照
+
+    ForceLayoutThread(ForceLayout layout, int generation, QObject* parent = nullptr);
+
+    void ackSnapshot() { snapshotPending = false; }   // 界面线程处理完快照后调用
+
+signals:
+    // generation 用来识别过期的快照：重新布局后，旧线程留在事件队列中的快照会被丢弃
+    void snapshotReady(int generation, const QVector<QPointF>& positions, bool finished);
+
+protected:
+    void run() override;
+
+private:
+    void emitSnapshot(bool finished);
+
+    ForceLayout layout;
+    int generation;
+    std::atomic<bool> snapshotPending{false};
+};
+
+#endif
@@ -0,0 +1,109 @@
+#include "graphalgorithms.h"
+#include "indexedheap.h"
+
+namespace {
+
+GraphSearch makeResult(const GraphModel& graph) {
+    int n = graph.vertexCount();
+    GraphSearch r;
+    r.parent.assign(n, -1);
+    r.parentEdge.assign(n, -1);
+    r.dist.assign(n, GraphSearch::unreachable);
+    return r;
+}
+
+// DFS 显式栈中的一帧：顶点及下一个要检查的出弧位置
+struct DfsFrame {
+    int vertex;
+    int slot;
+};
+
+} // namespace
+
+GraphSearch breadthFirstSearch(const GraphModel& graph, int source, const GraphStepSink& sink) {
+    GraphSearch r = makeResult(graph);
+    if (!graph.isValid(source)) return r;
+    r.order.reserve(graph.vertexCount());
+
+    // 访问顺序本身就是队列：order[head..] 为尚未出队的顶点
+    r.dist[source] = 0;
+    r.order.push_back(source);
+    if (sink) sink(GraphStep{GraphStep::Discover, source});
+    for (size_t head = 0; head < r.order.size(); ++head) {
+        int v = r.order[head];
+        if (sink) sink(GraphStep{GraphStep::Visit, v, r.parent[v], r.parentEdge[v], r.dist[v]});
+        graph.forEachArc(v, [&](const GraphEdge& a) {
+            if (r.dist[a.to] != GraphSearch::unreachable) return;
+            r.dist[a.to] = r.dist[v] + 1;
+            r.parent[a.to] = v;
+            r.parentEdge[a.to] = a.id;
+            r.order.push_back(a.to);
+            if (sink) sink(GraphStep{GraphStep::Discover, a.to, v, a.id, r.dist[a.to]});
+        });
+    }
+    return r;
+}
+
+// 显式栈模拟递归：每帧记住下一个出弧位置，访问顺序与递归 DFS 一致，深度不受调用栈限制
+GraphSearch depthFirstSearch(const GraphModel& graph, int source, const GraphStepSink& sink) {
+    GraphSearch r = makeResult(graph);
+    if (!graph.isValid(source)) return r;
+
+    std::vector<DfsFrame> stack;
+    auto enter = [&](int v, int from, int edge) {
+        r.dist[v] = from < 0 ? 0 : r.dist[from] + 1;
+        r.parent[v] = from;
+        r.parentEdge[v] = edge;
+        r.order.push_back(v);
+        stack.push_back(DfsFrame{v, 0});
+        if (sink) sink(GraphStep{GraphStep::Discover, v, from, edge, r.dist[v]});
+    };
+
+    enter(source, -1, -1);
+    while (!stack.empty()) {
+        DfsFrame& f = stack.back();
+        int v = f.vertex;
+        int slots = graph.arcSlots(v);
+        const GraphEdge* next = nullptr;
+        while (f.slot < slots && !next) {
+            const GraphEdge* a = graph.arcAt(v, f.slot++);
+            if (a && r.dist[a->to] == GraphSearch::unreachable) next = a;
+        }
+        if (next) {
+            enter(next->to, v, next->id);   // 之后 f 可能失效
+        } else {
+            stack.pop_back();
+            if (sink) sink(GraphStep{GraphStep::Finish, v, r.parent[v], r.parentEdge[v], r.dist[v]});
+        }
+    }
+    return r;
+}
+
+GraphSearch dijkstra(const GraphModel& graph, int source, const GraphStepSink& sink) {
+    GraphSearch r = makeResult(graph);
+    if (!graph.isValid(source)) return r;
+
+    IndexedMinHeap<double> heap(graph.vertexCount());
+    std::vector<char> settled(graph.vertexCount(), 0);
+    r.dist[source] = 0;
+    heap.push(source, 0);
+    if (sink) sink(GraphStep{GraphStep::Discover, source});
+    while (!heap.empty()) {
+        int v = heap.pop();
+        settled[v] = 1;
+        r.order.push_back(v);
+        if (sink) sink(GraphStep{GraphStep::Visit, v, r.parent[v], r.parentEdge[v], r.dist[v]});
+        graph.forEachArc(v, [&](const GraphEdge& a) {
+            if (a.weight < 0 || settled[a.to]) return;
+            double d = r.dist[v] + a.weight;
+            if (!(d < r.dist[a.to])) return;
+            bool first = r.dist[a.to] == GraphSearch::unreachable;
+            r.dist[a.to] = d;
+            r.parent[a.to] = v;
+            r.parentEdge[a.to] = a.id;
+            heap.push(a.to, d);
+            if (sink) sink(GraphStep{first ? GraphStep::Discover : GraphStep::Relax, a.to, v, a.id, d});
+        });
+    }
+    return r;
+}
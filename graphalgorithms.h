@@ -0,0 +1,46 @@
+#ifndef GRAPHALGORITHMS_H
+#define GRAPHALGORITHMS_H
+
+#include "graphmodel.h"
+#include <functional>
+#include <limits>
+#include <vector>
+
+// 算法执行过程中的一步，视图据此播放动画
+struct GraphStep {
+    enum Type {
+        Discover,   // 顶点首次被发现（BFS 入队、DFS 进入、Dijkstra 首次得到距离），from/edge 为发现它的弧
+        Visit,      // 顶点被处理（BFS 出队、Dijkstra 出堆确定最短距离）
+        Relax,      // Dijkstra 通过 from/edge 把 vertex 的距离降低为 dist
+        Finish,     // DFS 中顶点的所有邻居都已处理完
+        Phase,      // 并行算法进入新的阶段（BFS 的一层、delta-stepping 的一个桶），vertex 为阶段编号
+    };
+    Type   type;
+    int    vertex;
+    int    from = -1;
+    int    edge = -1;
+    double dist = 0;        // BFS 为层数，Dijkstra 为当前距离
+    int    frontier = 0;    // Phase：本阶段边界中的顶点数
+    bool   bottomUp = false;    // Phase：BFS 本层是否按自底向上方向扩展
+};
+
+using GraphStepSink = std::function<void(const GraphStep&)>;
+
+// 搜索结果：访问顺序和搜索树（最短路径树）
+struct GraphSearch {
+    static constexpr double unreachable = std::numeric_limits<double>::infinity();
+
+    std::vector<int>    order;      // 顶点被访问的顺序
+    std::vector<int>    parent;     // 搜索树中的父顶点，起点和不可达顶点为 -1
+    std::vector<int>    parentEdge; // 连向父顶点的边编号
+    std::vector<double> dist;       // BFS 为层数，Dijkstra 为最短距离，不可达为 unreachable
+};
+
+// 以下算法都不使用递归，sink 为空时不产生步骤事件，可以在百万条边的图上全速运行。
+// 起点无效时返回空的访问顺序
+GraphSearch breadthFirstSearch(const GraphModel& graph, int source, const GraphStepSink& sink = nullptr);
+GraphSearch depthFirstSearch(const GraphModel& graph, int source, const GraphStepSink& sink = nullptr);
+// Dijkstra 最短路径，使用带位置索引的二叉堆做 decrease-key；权值为负的弧被忽略
+GraphSearch dijkstra(const GraphModel& graph, int source, const GraphStepSink& sink = nullptr);
+
+#endif
@@ -0,0 +1,150 @@
+#include "graphmodel.h"
+#include <algorithm>
+
+void GraphModel::setDirected(bool directed) {
+    if (directed == m_directed) return;
+    m_directed = directed;
+    clear();
+}
+
+// 新顶点没有出弧，CSR 只需追加一个行偏移
+int GraphModel::addVertex() {
+    offsets.push_back(offsets.back());
+    int v = vertexCount() - 1;
+    m_changes.notify(GraphEvent{GraphEvent::VertexAdded, v});
+    return v;
+}
+
+int GraphModel::addEdge(int from, int to, double weight) {
+    if (!isValid(from) || !isValid(to)) return npos;
+    int id = m_nextEdge++;
+    overlay[from].push_back(GraphEdge{to, id, weight});
+    ++overlayArcs;
+    if (!m_directed && from != to) {
+        overlay[to].push_back(GraphEdge{from, id, weight});
+        ++overlayArcs;
+    }
+    ++m_edgeCount;
+    m_changes.notify(GraphEvent{GraphEvent::EdgeAdded, from, to, weight, id});
+    compactIfNeeded();
+    return id;
+}
+
+bool GraphModel::removeEdge(int from, int to) {
+    if (!isValid(from) || !isValid(to)) return false;
+    int id = eraseArc(from, to, npos);
+    if (id == npos) return false;
+    if (!m_directed && from != to) eraseArc(to, from, id);
+    --m_edgeCount;
+    m_changes.notify(GraphEvent{GraphEvent::EdgeRemoved, from, to, 1.0, id});
+    compactIfNeeded();
+    return true;
+}
+
+void GraphModel::clear() {
+    offsets.assign(1, 0);
+    arcs.clear();
+    overlay.clear();
+    overlayArcs = deadArcs = 0;
+    m_edgeCount = m_nextEdge = 0;
+    m_changes.notify(GraphEvent{GraphEvent::Cleared});
+}
+
+void GraphModel::build(int vertexCount, const std::vector<GraphArc>& edges) {
+    vertexCount = std::max(0, vertexCount);
+    auto valid = [vertexCount](const GraphArc& e) {
+        return e.from >= 0 && e.from < vertexCount && e.to >= 0 && e.to < vertexCount;
+    };
+
+    // 第一遍统计每个顶点的出弧数，前缀和得到行偏移
+    offsets.assign(vertexCount + 1, 0);
+    m_edgeCount = 0;
+    for (const GraphArc& e : edges) {
+        if (!valid(e)) continue;
+        ++offsets[e.from + 1];
+        if (!m_directed && e.from != e.to) ++offsets[e.to + 1];
+        ++m_edgeCount;
+    }
+    for (int v = 0; v < vertexCount; ++v) offsets[v + 1] += offsets[v];
+
+    // 第二遍把弧写到各自的行中
+    arcs.assign(offsets.back(), GraphEdge{npos, npos, 0});
+    std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+    for (int id = 0; id < static_cast<int>(edges.size()); ++id) {
+        const GraphArc& e = edges[id];
+        if (!valid(e)) continue;
+        arcs[fill[e.from]++] = GraphEdge{e.to, id, e.weight};
+        if (!m_directed && e.from != e.to) arcs[fill[e.to]++] = GraphEdge{e.from, id, e.weight};
+    }
+
+    overlay.clear();
+    overlayArcs = deadArcs = 0;
+    m_nextEdge = static_cast<int>(edges.size());
+    m_changes.notify(GraphEvent{GraphEvent::Rebuilt});
+}
+
+// 合并覆盖层：每个顶点的行由 CSR 中存活的弧和覆盖层中的弧依次拼接，边编号不变
+void GraphModel::compact() {
+    if (overlayArcs == 0 && deadArcs == 0) return;
+    int n = vertexCount();
+    std::vector<int> newOffsets(n + 1, 0);
+    std::vector<GraphEdge> newArcs;
+    newArcs.reserve(arcs.size() - deadArcs + overlayArcs);
+    for (int v = 0; v < n; ++v) {
+        forEachArc(v, [&newArcs](const GraphEdge& a) { newArcs.push_back(a); });
+        newOffsets[v + 1] = static_cast<int>(newArcs.size());
+    }
+    offsets.swap(newOffsets);
+    arcs.swap(newArcs);
+    overlay.clear();
+    overlayArcs = deadArcs = 0;
+}
+
+// 覆盖层和墓碑之和超过 CSR 的八分之一时合并，保证遍历仍以顺序访存为主
+void GraphModel::compactIfNeeded() {
+    if (overlayArcs + deadArcs > std::max<int>(1024, static_cast<int>(arcs.size()) / 8)) compact();
+}
+
+int GraphModel::arcSlots(int v) const {
+    int n = offsets[v + 1] - offsets[v];
+    if (overlayArcs != 0) {
+        auto it = overlay.find(v);
+        if (it != overlay.end()) n += static_cast<int>(it->second.size());
+    }
+    return n;
+}
+
+const GraphEdge* GraphModel::arcAt(int v, int slot) const {
+    int csr = offsets[v + 1] - offsets[v];
+    if (slot < csr) {
+        const GraphEdge& a = arcs[offsets[v] + slot];
+        return a.to == npos ? nullptr : &a;
+    }
+    return &overlay.at(v)[slot - csr];
+}
+
+// 删除 from 出发指向 to 的一条弧（id 不为 npos 时要求边编号一致），返回其边编号。
+// 覆盖层中的弧直接删除，CSR 中的弧标记为墓碑
+int GraphModel::eraseArc(int from, int to, int id) {
+    auto matches = [to, id](const GraphEdge& a) { return a.to == to && (id == npos || a.id == id); };
+    auto it = overlay.find(from);
+    if (it != overlay.end()) {
+        auto& out = it->second;
+        auto a = std::find_if(out.begin(), out.end(), matches);
+        if (a != out.end()) {
+            int erased = a->id;
+            out.erase(a);
+            --overlayArcs;
+            if (out.empty()) overlay.erase(it);
+            return erased;
+        }
+    }
+    for (int i = offsets[from]; i < offsets[from + 1]; ++i) {
+        if (matches(arcs[i])) {
+            arcs[i].to = npos;
+            ++deadArcs;
+            return arcs[i].id;
+        }
+    }
+    return npos;
+}
@@ -0,0 +1,97 @@
+#ifndef GRAPHMODEL_H
+#define GRAPHMODEL_H
+
+#include "modelsignal.h"
+#include <unordered_map>
+#include <vector>
+
+// 邻接表中的一条弧；无向边在两端各有一条弧，二者的 id 相同
+struct GraphEdge {
+    int    to;
+    int    id;          // 边编号，在图清空或重建前保持不变
+    double weight;
+};
+
+// 批量建图时输入的一条边
+struct GraphArc {
+    int    from;
+    int    to;
+    double weight = 1.0;
+};
+
+// 图变更事件
+struct GraphEvent {
+    enum Type { VertexAdded, EdgeAdded, EdgeRemoved, Cleared, Rebuilt };
+    Type   type;
+    int    from = -1;       // 顶点编号，或边的起点
+    int    to = -1;         // 边的终点
+    double weight = 1.0;
+    int    edge = -1;       // 边编号
+};
+
+// GraphModel 是不依赖 Qt 的图模型，支持有向图和无向图，顶点编号为 0..n-1。
+// 弧以压缩稀疏行（CSR）存放：所有弧在一个连续数组中，offsets[v]..offsets[v+1] 是 v 的出弧，
+// 遍历邻居是顺序访存，百万条边只占两块连续内存。
+// 建图后的增删记在可变覆盖层上：新增的弧按顶点挂在 overlay 中，删除的弧原地标记为墓碑；
+// 覆盖层超过 CSR 的一定比例时合并回 CSR。
+class GraphModel
+{
+public:
+    static constexpr int npos = -1;
+
+    explicit GraphModel(bool directed = false) : m_directed(directed) {}
+
+    bool directed() const { return m_directed; }
+    void setDirected(bool directed);    // 切换有向/无向会清空图
+
+    int  addVertex();                                   // 添加顶点，返回编号
+    int  addEdge(int from, int to, double weight = 1.0);    // 添加边，返回边编号，端点无效时返回 npos
+    bool removeEdge(int from, int to);                  // 删除 from 到 to 的一条边
+    void clear();
+
+    // 一次性重建整个图：直接按计数排序写入 CSR，只广播一个 Rebuilt 事件。
+    // 第 i 条输入边的编号为 i，端点无效的边被忽略
+    void build(int vertexCount, const std::vector<GraphArc>& edges);
+    void compact();     // 把覆盖层合并回 CSR
+
+    int  vertexCount() const { return static_cast<int>(offsets.size()) - 1; }
+    int  edgeCount() const { return m_edgeCount; }      // 无向边只计一次
+    int  edgeIdBound() const { return m_nextEdge; }     // 所有边编号都小于该值
+    bool isValid(int v) const { return v >= 0 && v < vertexCount(); }
+
+    // 依次对 v 的每条出弧调用 f(const GraphEdge&)
+    template <typename F>
+    void forEachArc(int v, F&& f) const {
+        for (int i = offsets[v], end = offsets[v + 1]; i < end; ++i) {
+            if (arcs[i].to != npos) f(arcs[i]);
+        }
+        if (overlayArcs == 0) return;
+        auto it = overlay.find(v);
+        if (it != overlay.end()) {
+            for (const GraphEdge& a : it->second) f(a);
+        }
+    }
+
+    // 按位置访问 v 的出弧，供需要在邻居之间暂停的迭代算法使用（如显式栈 DFS）。
+    // 位置 0..arcSlots(v)-1 中包含已删除的弧，此时 arcAt 返回 nullptr
+    int  arcSlots(int v) const;
+    const GraphEdge* arcAt(int v, int slot) const;
+
+    ModelSignal<GraphEvent>& changes() { return m_changes; }
+
+private:
+    int  eraseArc(int from, int to, int id);    // 删除一条弧，返回其边编号
+    void compactIfNeeded();
+
+    bool m_directed;
+    std::vector<int> offsets{0};                // CSR 行偏移，大小为顶点数 + 1
+    std::vector<GraphEdge> arcs;                // CSR 弧数组，墓碑的 to 为 npos
+    std::unordered_map<int, std::vector<GraphEdge>> overlay;   // 建图后新增的弧
+    int overlayArcs = 0;                        // 覆盖层中的弧数
+    int deadArcs = 0;                           // CSR 中的墓碑数
+    int m_edgeCount = 0;
+    int m_nextEdge = 0;
+    ModelSignal<GraphEvent> m_changes;
+};
+
+#endif
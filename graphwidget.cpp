@@ -1,11 +1,454 @@
 #include "GraphWidget.h"
-#include <QLabel>
+#include "animationscheduler.h"
+#include "NodeItem.h"
+#include "nodeitempool.h"
+#include "forcelayoutthread.h"
 #include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGraphicsSimpleTextItem>
+#include <QMessageBox>
+#include <QPen>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QLineF>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+constexpr qreal R = 20;         // 顶点半径
+constexpr qreal Spacing = 100;  // 网格间距
+}
 
 // 构造函数，初始化图形控件
-GraphWidget::GraphWidget(QWidget* parent) : QWidget(parent) {
-    // 创建垂直布局
-    QVBoxLayout* layout = new QVBoxLayout(this);
-    QLabel* label = new QLabel("图模块待开发", this);
-    layout->addWidget(label);
+GraphWidget::GraphWidget(QWidget* parent)
+    : QWidget(parent), animationChannel(AnimationScheduler::instance().newChannel())
+{
+    auto *vlay = new QVBoxLayout(this);
+
+    scene = new QGraphicsScene(this);
+    pool = std::make_unique<NodeItemPool>(scene);
+    scene->setItemIndexMethod(QGraphicsScene::NoIndex);    // 布局期间所有顶点每帧移动，不维护空间索引
+    view = new QGraphicsView(scene, this);
+    view->setRenderHint(QPainter::Antialiasing);
+    view->setDragMode(QGraphicsView::ScrollHandDrag);
+    view->setResizeAnchor(QGraphicsView::AnchorUnderMouse);
+    view->setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+    vlay->addWidget(view);
+
+    // 控制面板
+    directedBox = new QCheckBox("有向图", this);
+    vertexSpin = new QSpinBox(this);
+    vertexSpin->setRange(1, 50000);
+    vertexSpin->setValue(12);
+    vertexSpin->setPrefix("顶点数 ");
+    edgeSpin = new QSpinBox(this);
+    edgeSpin->setRange(0, 1000000);
+    edgeSpin->setValue(18);
+    edgeSpin->setPrefix("边数 ");
+    btnGenerate = new QPushButton("生成", this);
+    sourceSpin = new QSpinBox(this);
+    sourceSpin->setRange(0, 0);
+    sourceSpin->setPrefix("起点 ");
+    btnBfs = new QPushButton("BFS", this);
+    btnDfs = new QPushButton("DFS", this);
+    btnDijkstra = new QPushButton("Dijkstra", this);
+    btnParallelBfs = new QPushButton("并行BFS", this);
+    btnParallelSssp = new QPushButton("并行最短路", this);
+    btnLayout = new QPushButton("力导向布局", this);
+
+    auto *hlay = new QHBoxLayout;
+    hlay->addWidget(directedBox);
+    hlay->addWidget(vertexSpin);
+    hlay->addWidget(edgeSpin);
+    hlay->addWidget(btnGenerate);
+    hlay->addWidget(sourceSpin);
+    hlay->addWidget(btnBfs);
+    hlay->addWidget(btnDfs);
+    hlay->addWidget(btnDijkstra);
+    hlay->addWidget(btnParallelBfs);
+    hlay->addWidget(btnParallelSssp);
+    hlay->addWidget(btnLayout);
+    vlay->addLayout(hlay);
+
+    statusLabel = new QLabel(this);
+    vlay->addWidget(statusLabel);
+
+    connect(btnGenerate, &QPushButton::clicked, this, &GraphWidget::onGenerate);
+    connect(btnBfs,      &QPushButton::clicked, this, &GraphWidget::onBfs);
+    connect(btnDfs,      &QPushButton::clicked, this, &GraphWidget::onDfs);
+    connect(btnDijkstra, &QPushButton::clicked, this, &GraphWidget::onDijkstra);
+    connect(btnParallelBfs,  &QPushButton::clicked, this, &GraphWidget::onParallelBfs);
+    connect(btnParallelSssp, &QPushButton::clicked, this, &GraphWidget::onParallelSssp);
+    connect(btnLayout,   &QPushButton::clicked, this, &GraphWidget::startLayout);
+
+    edges = new EdgeLayerItem;  // 所有边由一个图元批量绘制
+    edges->setZValue(-1);
+    scene->addItem(edges);
+
+    // 订阅模型变更，所有图元都由模型事件驱动
+    model.changes().subscribe([this](const GraphEvent& e) { onModelChanged(e); });
+
+    onGenerate();
+}
+
+GraphWidget::~GraphWidget() {
+    stopLayout();
+    AnimationScheduler::instance().cancel(animationChannel);
+}
+
+// 生成随机图：前 n-1 条边连成一棵随机生成树保证连通，其余边随机连接，权值为 1..9
+void GraphWidget::onGenerate() {
+    int n = vertexSpin->value();
+    int m = edgeSpin->value();
+    std::mt19937 rng(std::random_device{}());
+    std::vector<GraphArc> list;
+    list.reserve(m);
+    for (int i = 0; i < m; ++i) {
+        int from, to;
+        if (i + 1 < n) {
+            to = i + 1;
+            from = std::uniform_int_distribution<int>(0, i)(rng);
+        } else if (n > 1) {
+            from = std::uniform_int_distribution<int>(0, n - 1)(rng);
+            to = std::uniform_int_distribution<int>(0, n - 2)(rng);
+            if (to >= from) ++to;   // 不生成自环
+        } else {
+            break;
+        }
+        list.push_back(GraphArc{from, to, double(std::uniform_int_distribution<int>(1, 9)(rng))});
+    }
+    model.setDirected(directedBox->isChecked());
+    model.build(n, list);   // 只产生一个 Rebuilt 事件，控件一次性重建
+}
+
+void GraphWidget::onBfs() {
+    int source = sourceSpin->value();
+    run([this, source](const GraphStepSink& sink) { return breadthFirstSearch(model, source, sink); }, "BFS");
+}
+
+void GraphWidget::onDfs() {
+    int source = sourceSpin->value();
+    run([this, source](const GraphStepSink& sink) { return depthFirstSearch(model, source, sink); }, "DFS");
+}
+
+void GraphWidget::onDijkstra() {
+    int source = sourceSpin->value();
+    run([this, source](const GraphStepSink& sink) { return dijkstra(model, source, sink); }, "Dijkstra");
+}
+
+void GraphWidget::onParallelBfs() {
+    int source = sourceSpin->value();
+    runParallel([this, source](const GraphStepSink& sink) { return breadthFirstSearch(model, source, sink); },
+                [this, source](const GraphStepSink& sink) {
+                    return parallelBreadthFirstSearch(model, source, WorkStealingPool::instance(), sink);
+                }, "并行 BFS", false);
+}
+
+void GraphWidget::onParallelSssp() {
+    int source = sourceSpin->value();
+    runParallel([this, source](const GraphStepSink& sink) { return dijkstra(model, source, sink); },
+                [this, source](const GraphStepSink& sink) {
+                    return deltaStepping(model, source, WorkStealingPool::instance(), 0, sink);
+                }, "并行最短路（delta-stepping）", true);
+}
+
+// 根据模型事件增删图元
+void GraphWidget::onModelChanged(const GraphEvent& e) {
+    switch (e.type) {
+    case GraphEvent::VertexAdded:
+        addVertexItem(e.from);
+        sourceSpin->setMaximum(model.vertexCount() - 1);
+        updateSceneRect();
+        scheduleLayout();
+        break;
+    case GraphEvent::EdgeAdded:
+        addEdgeItem(e.edge, e.from, e.to, e.weight);
+        scheduleLayout();
+        break;
+    case GraphEvent::EdgeRemoved:
+        removeEdgeItem(e.edge);
+        scheduleLayout();
+        break;
+    case GraphEvent::Cleared:
+        clearScene();
+        break;
+    case GraphEvent::Rebuilt:
+        rebuildScene();
+        break;
+    }
+}
+
+// 按模型重新创建所有图元。边图层先移出场景再批量追加，避免百万条边逐条通知场景刷新
+void GraphWidget::rebuildScene() {
+    clearScene();
+    int n = model.vertexCount();
+    gridColumns = std::max(4, int(std::ceil(std::sqrt(double(n)))));
+    vertices.reserve(n);
+    for (int v = 0; v < n; ++v) addVertexItem(v);
+
+    scene->removeItem(edges);
+    edges->reserve(model.edgeCount());
+    edgeLayer.assign(model.edgeIdBound(), -1);
+    bool labels = model.edgeCount() <= maxWeightLabels;
+    for (int v = 0; v < n; ++v) {
+        model.forEachArc(v, [&](const GraphEdge& a) {
+            if (!model.directed() && a.to < v) return;  // 无向边只画一次
+            addEdgeItem(a.id, v, a.to, labels ? a.weight : -1);
+        });
+    }
+    scene->addItem(edges);
+
+    sourceSpin->setMaximum(std::max(0, n - 1));
+    updateSceneRect();
+    statusLabel->setText(QString("%1个顶点，%2条边").arg(n).arg(model.edgeCount()));
+    startLayout();
+}
+
+// 删除所有图元；先取消回放，避免调度器访问已删除的顶点
+void GraphWidget::clearScene() {
+    stopLayout();
+    AnimationScheduler::instance().cancel(animationChannel);
+    steps.clear();
+    shownEdge.clear();
+    for (NodeItem* item : vertices) pool->release(item);
+    vertices.clear();
+    positions.clear();
+    for (auto& [id, label] : weightLabels) {
+        scene->removeItem(label);
+        delete label;
+    }
+    weightLabels.clear();
+    edges->clear();
+    edgeLayer.clear();
+    layerEdges.clear();
+}
+
+void GraphWidget::addVertexItem(int v) {
+    auto* item = pool->acquire(v);
+    positions.push_back(gridPos(v));
+    item->setPos(positions[v]);
+    vertices.push_back(item);
+    shownEdge.push_back(-1);
+}
+
+// 追加一条边：从起点圆周指向终点圆周。weight 为负时不显示权值标签
+void GraphWidget::addEdgeItem(int id, int from, int to, double weight) {
+    if (id >= static_cast<int>(edgeLayer.size())) edgeLayer.resize(id + 1, -1);
+    if (from == to) return;     // 自环不绘制
+    QLineF line = edgeLine(from, to);
+    edgeLayer[id] = edges->addEdge(line.p1(), line.p2(), model.directed() ? EdgeLayerItem::Arrow : 0);
+    layerEdges.push_back(LayerEntry{id, from, to});
+
+    if (weight >= 0 && static_cast<int>(weightLabels.size()) < maxWeightLabels) {
+        auto* label = new QGraphicsSimpleTextItem(QString::number(weight));
+        label->setPos(line.center() + QPointF(4, -16));
+        scene->addItem(label);
+        weightLabels[id] = label;
+    }
+}
+
+// 删除一条边：边图层末尾的边移到被删除的位置，再删除末尾
+void GraphWidget::removeEdgeItem(int id) {
+    auto found = weightLabels.find(id);
+    if (found != weightLabels.end()) {
+        scene->removeItem(found->second);
+        delete found->second;
+        weightLabels.erase(found);
+    }
+    if (id >= static_cast<int>(edgeLayer.size()) || edgeLayer[id] < 0) return;
+    int index = edgeLayer[id];
+    int last = edges->count() - 1;
+    if (index != last) {
+        const LayerEntry moved = layerEdges[last];
+        QLineF line = edgeLine(moved.from, moved.to);
+        edges->setEdge(index, line.p1(), line.p2());
+        edges->setEdgeFlags(index, edges->edgeFlags(last));
+        edgeLayer[moved.id] = index;
+        layerEdges[index] = moved;
+    }
+    edges->removeLast();
+    layerEdges.pop_back();
+    edgeLayer[id] = -1;
+}
+
+// 初始时顶点按网格排列，随后由力导向布局移动
+QPointF GraphWidget::gridPos(int v) const {
+    return QPointF(50 + (v % gridColumns) * Spacing, 50 + (v / gridColumns) * Spacing);
+}
+
+QLineF GraphWidget::edgeLine(int from, int to) const {
+    QPointF a = slotPos(from) + QPointF(R, R);
+    QPointF b = slotPos(to) + QPointF(R, R);
+    qreal ang = std::atan2(b.y() - a.y(), b.x() - a.x());
+    QPointF d(std::cos(ang) * R, std::sin(ang) * R);
+    return QLineF(a + d, b - d);
+}
+
+// 场景范围为所有顶点的包围盒外扩一圈边距
+void GraphWidget::updateSceneRect() {
+    if (positions.empty()) {
+        scene->setSceneRect(0, 0, 800, 600);
+        return;
+    }
+    qreal x0 = positions[0].x(), x1 = x0, y0 = positions[0].y(), y1 = y0;
+    for (const QPointF& p : positions) {
+        x0 = std::min(x0, p.x()); x1 = std::max(x1, p.x());
+        y0 = std::min(y0, p.y()); y1 = std::max(y1, p.y());
+    }
+    scene->setSceneRect(QRectF(QPointF(x0, y0), QPointF(x1 + 2 * R, y1 + 2 * R)).adjusted(-50, -50, 50, 50));
+}
+
+// 以当前位置为初值启动布局线程，先结束上一次布局
+void GraphWidget::startLayout() {
+    stopLayout();
+    layoutScheduled = false;
+    int n = model.vertexCount();
+    if (n < 2) return;
+    std::vector<double> x(n), y(n);
+    for (int v = 0; v < n; ++v) {
+        x[v] = positions[v].x() + R;
+        y[v] = positions[v].y() + R;
+    }
+    std::vector<std::pair<int, int>> pairs;
+    pairs.reserve(layerEdges.size());
+    for (const LayerEntry& e : layerEdges) pairs.emplace_back(e.from, e.to);
+
+    ForceLayoutParams params;
+    params.idealLength = Spacing;
+    layoutThread = new ForceLayoutThread(ForceLayout(std::move(x), std::move(y), std::move(pairs), params),
+                                         ++layoutGeneration, this);
+    connect(layoutThread, &ForceLayoutThread::snapshotReady, this, &GraphWidget::onLayoutSnapshot);
+    layoutThread->start(QThread::LowPriority);
+}
+
+// 打断布局线程并等待当前迭代结束；线程留在事件队列中的快照因代数不符而被丢弃
+void GraphWidget::stopLayout() {
+    if (!layoutThread) return;
+    layoutThread->requestInterruption();
+    layoutThread->wait();
+    delete layoutThread;
+    layoutThread = nullptr;
+    ++layoutGeneration;
+}
+
+void GraphWidget::scheduleLayout() {
+    if (layoutScheduled) return;
+    layoutScheduled = true;
+    QTimer::singleShot(0, this, [this]() {
+        if (layoutScheduled) startLayout();
+    });
+}
+
+// 应用一份布局快照：移动顶点、批量移动边和权值标签，场景范围只扩大不缩小，避免拖动视图时跳动
+void GraphWidget::onLayoutSnapshot(int generation, const QVector<QPointF>& centers, bool finished) {
+    if (generation != layoutGeneration || centers.size() != static_cast<int>(vertices.size())) return;
+    QRectF bounds;
+    for (int v = 0; v < centers.size(); ++v) {
+        positions[v] = centers[v] - QPointF(R, R);
+        vertices[v]->setPos(positions[v]);
+        bounds |= QRectF(positions[v], QSizeF(2 * R, 2 * R));
+    }
+    for (int i = 0; i < static_cast<int>(layerEdges.size()); ++i) {
+        QLineF line = edgeLine(layerEdges[i].from, layerEdges[i].to);
+        edges->moveEdge(i, line.p1(), line.p2());
+    }
+    edges->commitMoves();
+    for (auto& [id, label] : weightLabels) {
+        const LayerEntry& e = layerEdges[edgeLayer[id]];
+        label->setPos(edgeLine(e.from, e.to).center() + QPointF(4, -16));
+    }
+    scene->setSceneRect(scene->sceneRect().united(bounds.adjusted(-50, -50, 50, 50)));
+
+    if (finished) {
+        statusLabel->setText(QString("布局完成：%1个顶点，%2条边").arg(vertices.size()).arg(model.edgeCount()));
+        layoutThread->wait();
+        delete layoutThread;
+        layoutThread = nullptr;
+    } else {
+        layoutThread->ackSnapshot();
+    }
+}
+
+// 在模型上全速运行算法并记录步骤，再由调度器每隔 stepDelayMs 回放；
+// 步骤很多时每帧回放多步，总帧数不超过 maxAnimationTicks
+void GraphWidget::run(const Algorithm& algorithm, const QString& name, const QString& summary) {
+    auto& scheduler = AnimationScheduler::instance();
+    scheduler.cancel(animationChannel);
+    resetColors();
+    steps.clear();
+    GraphSearch result = algorithm([this](const GraphStep& s) { steps.push_back(s); });
+    QString text = summary.isEmpty() ? QString("%1 结束：共访问 %2 个顶点").arg(name).arg(result.order.size()) : summary;
+
+    size_t perTick = std::max<size_t>(1, steps.size() / maxAnimationTicks);
+    size_t next = 0;
+    scheduler.every(animationChannel, stepDelayMs, [this, perTick, next, name, text]() mutable {
+        for (size_t k = 0; k < perTick && next < steps.size(); ++k) applyStep(steps[next++]);
+        if (next < steps.size()) return true;
+        steps.clear();
+        statusLabel->setText(text);
+        // 在事件循环中弹出提示，避免在调度器的帧回调里运行模态对话框
+        QMetaObject::invokeMethod(this, [this, name]() {
+            QMessageBox::information(this, "提示", name + " 结束");
+        }, Qt::QueuedConnection);
+        return false;
+    });
+}
+
+void GraphWidget::runParallel(const Algorithm& sequential, const Algorithm& parallel, const QString& name, bool weighted) {
+    QElapsedTimer clock;
+    clock.start();
+    GraphSearch expected = sequential(nullptr);
+    qint64 sequentialMs = clock.restart();
+    GraphSearch actual = parallel(nullptr);
+    qint64 parallelMs = clock.elapsed();
+    int mismatches = countMismatches(model, actual, expected, weighted);
+
+    QString summary = QString("%1：访问 %2 个顶点，并行 %3 ms（%4 线程），顺序 %5 ms，")
+                          .arg(name).arg(actual.order.size()).arg(parallelMs)
+                          .arg(WorkStealingPool::instance().concurrency()).arg(sequentialMs);
+    summary += mismatches == 0 ? QString("与顺序结果一致") : QString("%1 个顶点与顺序结果不一致").arg(mismatches);
+    run(parallel, name, summary);
+}
+
+// 回放一步：发现的顶点为橙色，访问过的顶点为黄色，DFS 回溯完成的顶点为绿色，
+// 当前的搜索树边（Dijkstra 为最短路径树边）为红色；并行算法的阶段显示在状态栏中
+void GraphWidget::applyStep(const GraphStep& s) {
+    NodeItem* item = s.type == GraphStep::Phase ? nullptr : vertices[s.vertex];    // Phase 的 vertex 是阶段编号
+    switch (s.type) {
+    case GraphStep::Discover:
+        item->setColors(QColor(255, 140, 0), Qt::white);
+        highlightTreeEdge(s.vertex, s.edge);
+        break;
+    case GraphStep::Relax:
+        highlightTreeEdge(s.vertex, s.edge);
+        statusLabel->setText(QString("松弛 %1 -> %2，距离 %3").arg(s.from).arg(s.vertex).arg(s.dist));
+        break;
+    case GraphStep::Visit:
+        item->setColors(Qt::yellow, Qt::black);
+        statusLabel->setText(QString("访问顶点 %1，距离 %2").arg(s.vertex).arg(s.dist));
+        break;
+    case GraphStep::Finish:
+        item->setColors(QColor(0, 160, 0), Qt::white);
+        break;
+    case GraphStep::Phase:
+        statusLabel->setText(QString("第 %1 阶段：边界 %2 个顶点%3")
+                                 .arg(s.vertex).arg(s.frontier).arg(s.bottomUp ? "，自底向上" : ""));
+        break;
+    }
+}
+
+void GraphWidget::highlightTreeEdge(int v, int edge) {
+    int old = shownEdge[v];
+    if (old >= 0 && edgeLayer[old] >= 0)
+        edges->setEdgeFlags(edgeLayer[old], quint8(edges->edgeFlags(edgeLayer[old]) & ~EdgeLayerItem::Highlight));
+    shownEdge[v] = edge;
+    if (edge >= 0 && edgeLayer[edge] >= 0)
+        edges->setEdgeFlags(edgeLayer[edge], quint8(edges->edgeFlags(edgeLayer[edge]) | EdgeLayerItem::Highlight));
+}
+
+// 恢复顶点为蓝色、边为黑色
+void GraphWidget::resetColors() {
+    for (NodeItem* item : vertices) item->setColors(Qt::blue, Qt::white);
+    for (int v = 0; v < static_cast<int>(shownEdge.size()); ++v) highlightTreeEdge(v, -1);
 }
@@ -2,13 +2,113 @@
 #define GRAPHWIDGET_H
 
 #include <QWidget>
+#include <QGraphicsScene>
+#include <QGraphicsView>
+#include <QPushButton>
+#include <QCheckBox>
+#include <QSpinBox>
+#include <QLabel>
+#include <unordered_map>
+#include <vector>
+#include "edgelayeritem.h"
+#include "graphalgorithms.h"
+#include "graphmodel.h"
+#include "parallelgraphalgorithms.h"
+#include <functional>
+#include <memory>
 
-// 图的可视化控件类，用于显示图的相关内容
+class NodeItem;
+class NodeItemPool;
+class QGraphicsSimpleTextItem;
+class ForceLayoutThread;
+
+// 图的可视化控件：图数据存放在 GraphModel（CSR + 覆盖层）中，控件订阅模型事件绘制顶点，
+// 所有边由一个边图层批量绘制。BFS/DFS/Dijkstra 在模型上全速运行并记录步骤，
+// 再由动画调度器逐步回放。顶点位置由工作线程中的力导向布局（Barnes–Hut）计算，
+// 布局以快照的形式流式更新到场景，收敛过程中界面仍可平移、缩放和运行算法。
 class GraphWidget : public QWidget {
     Q_OBJECT
 
 public:
     explicit GraphWidget(QWidget* parent = nullptr);
+    ~GraphWidget() override;
+
+    // 图模型，可脱离界面直接驱动；控件订阅其变更事件并据此绘制
+    GraphModel& graphModel() { return model; }
+
+private slots:
+    void onGenerate();  // 按输入的顶点数和边数生成随机图
+    void onBfs();       // 广度优先搜索
+    void onDfs();       // 深度优先搜索
+    void onDijkstra();  // Dijkstra 最短路径
+    void onParallelBfs();   // 方向优化的并行 BFS，与顺序 BFS 对照
+    void onParallelSssp();  // delta-stepping 并行最短路径，与 Dijkstra 对照
+    void startLayout(); // 从当前位置开始力导向布局
+    void onLayoutSnapshot(int generation, const QVector<QPointF>& centers, bool finished);
+
+private:
+    QGraphicsScene* scene;
+    QGraphicsView* view;
+    QCheckBox* directedBox;
+    QSpinBox* vertexSpin;
+    QSpinBox* edgeSpin;
+    QSpinBox* sourceSpin;
+    QPushButton* btnGenerate;
+    QPushButton* btnBfs;
+    QPushButton* btnDfs;
+    QPushButton* btnDijkstra;
+    QPushButton* btnParallelBfs;
+    QPushButton* btnParallelSssp;
+    QPushButton* btnLayout;
+    QLabel* statusLabel;
+
+    GraphModel model;
+    std::unique_ptr<NodeItemPool> pool; // 顶点图元池：重新生成图时复用上一张图的图元
+    std::vector<NodeItem*> vertices;    // 按顶点编号存放图元
+    EdgeLayerItem* edges;               // 所有边的图层
+    std::vector<int> edgeLayer;         // 边编号 -> 边图层下标，未绘制（自环）为 -1
+    // 边图层中一条边对应的模型边
+    struct LayerEntry {
+        int id;
+        int from;
+        int to;
+    };
+    std::vector<LayerEntry> layerEdges; // 边图层下标 -> 模型边，删除边时用来移动末尾的边
+    std::unordered_map<int, QGraphicsSimpleTextItem*> weightLabels;    // 边编号 -> 权值标签，只在小图中显示
+    std::vector<QPointF> positions;     // 按顶点编号存放图元的左上角坐标
+    int gridColumns = 4;                // 初始网格排列的列数
+    ForceLayoutThread* layoutThread = nullptr;  // 正在运行的布局线程
+    int layoutGeneration = 0;           // 每次开始布局加一，用来丢弃过期的快照
+    bool layoutScheduled = false;       // 图结构变化后已安排重新布局
+
+    std::vector<GraphStep> steps;       // 待回放的算法步骤
+    std::vector<int> shownEdge;         // 按顶点编号记录当前高亮的搜索树边
+    int stepDelayMs = 500;              // 每一步动画的间隔，单位：毫秒
+    int animationChannel;               // 回放在调度器中的通道，开始新的回放时整体取消
+
+    static constexpr int maxAnimationTicks = 400;   // 步骤很多时每帧合并多步，回放总帧数不超过该值
+    static constexpr int maxWeightLabels = 200;     // 边数超过该值时不显示权值
+
+    void onModelChanged(const GraphEvent& e);   // 根据模型变更事件增删图元
+    void rebuildScene();        // 按模型重新创建所有图元
+    void clearScene();          // 删除所有图元
+    void addVertexItem(int v);
+    void addEdgeItem(int id, int from, int to, double weight);
+    void removeEdgeItem(int id);
+    QPointF slotPos(int v) const { return positions[v]; }  // 第 v 个顶点的左上角坐标
+    QPointF gridPos(int v) const;   // 初始网格排列中第 v 个顶点的左上角坐标
+    QLineF  edgeLine(int from, int to) const;   // 从起点圆周到终点圆周的连线
+    void updateSceneRect();
+    void stopLayout();          // 打断并等待布局线程结束
+    void scheduleLayout();      // 在事件循环中重新布局，合并连续的结构变化
+
+    using Algorithm = std::function<GraphSearch(const GraphStepSink&)>;
+    void run(const Algorithm& algorithm, const QString& name, const QString& summary = QString());
+    // 分别计时顺序和并行版本（不记录步骤），对照结果后回放并行版本
+    void runParallel(const Algorithm& sequential, const Algorithm& parallel, const QString& name, bool weighted);
+    void applyStep(const GraphStep& s);
+    void highlightTreeEdge(int v, int edge);    // 把 v 的高亮搜索树边换成 edge
+    void resetColors();
 };
 
 #endif
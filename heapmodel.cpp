@@ -0,0 +1,160 @@
+#include "heapmodel.h"
+#include <algorithm>
+#include <climits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HEAP_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+#ifdef HEAP_USE_SSE2
+// SSE2 没有 32 位整数的 min 指令，用比较结果选择
+inline __m128i minEpi32(__m128i a, __m128i b) {
+    __m128i lt = _mm_cmplt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(lt, a), _mm_andnot_si128(lt, b));
+}
+
+// 4 个通道的最小值广播到所有通道
+inline __m128i horizontalMin(__m128i v) {
+    v = minEpi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return minEpi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+// 4 位掩码中最低的置位位置
+constexpr int LowestBit4[16] = {0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0};
+#endif
+
+// 一组 D 个孩子中最小值的下标（组内偏移）。孩子组在数组中从 D 的整数倍开始，
+// 4 叉堆的一组恰好是一次 16 字节对齐加载，8 叉堆是两次
+template <int D>
+inline int minChildOf(const int* c) {
+#ifdef HEAP_USE_SSE2
+    if constexpr (D == 4) {
+        __m128i v = _mm_load_si128(reinterpret_cast<const __m128i*>(c));
+        return LowestBit4[_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, horizontalMin(v))))];
+    } else if constexpr (D == 8) {
+        __m128i lo = _mm_load_si128(reinterpret_cast<const __m128i*>(c));
+        __m128i hi = _mm_load_si128(reinterpret_cast<const __m128i*>(c + 4));
+        __m128i m = horizontalMin(minEpi32(lo, hi));
+        int low = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(lo, m)));
+        return low ? LowestBit4[low] : 4 + LowestBit4[_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(hi, m)))];
+    }
+#endif
+    int best = 0;
+    for (int k = 1; k < D; ++k)
+        if (c[k] < c[best]) best = k;
+    return best;
+}
+
+// 下滤：最小的孩子比当前值小就上移填补空穴。signal 为空时不报告交换。
+// 堆尾之后是 INT_MAX，不满的一组也能整组比较。二叉堆特意写成分支：处理器可以推测下一层的地址并提前取数，
+// 堆远大于缓存时比编译成条件传送的写法快一倍
+template <int D>
+void siftDownImpl(int* a, int n, int i, const ModelSignal<HeapEvent>* signal) {
+    int v = a[i];
+    for (;;) {
+        int c = D * i + 1;
+        if (c >= n) break;
+        int best = c;
+        if constexpr (D == 2) {
+            if (a[c + 1] < a[c]) best = c + 1;
+        } else {
+            best += minChildOf<D>(a + c);
+        }
+        if (!(a[best] < v)) break;
+        a[i] = a[best];
+        if (signal) signal->notify(HeapEvent{HeapEvent::Swapped, i, best});
+        i = best;
+    }
+    a[i] = v;
+}
+
+} // namespace
+
+HeapModel::HeapModel(int arity) {
+    setArity(arity);
+}
+
+void HeapModel::setArity(int arity) {
+    d = arity == 4 || arity == 8 ? arity : 2;
+    offset = d - 1;
+    clear();
+}
+
+void HeapModel::clear() {
+    m_lines.clear();
+    m_size = 0;
+    m_changes.notify(HeapEvent{HeapEvent::Cleared});
+}
+
+// 按两倍扩容，新位置填充 INT_MAX
+void HeapModel::reserveSlots(int count) {
+    size_t needed = size_t(offset) + count + 2 * d;
+    size_t have = m_lines.size() * 16;
+    if (needed <= have) return;
+    size_t lines = std::max((needed + 15) / 16, m_lines.size() * 2);
+    m_lines.resize(lines);
+    std::fill(data() + have, data() + lines * 16, INT_MAX);
+}
+
+void HeapModel::push(int value) {
+    reserveSlots(m_size + 1);
+    int i = m_size++;
+    data()[offset + i] = value;
+    m_changes.notify(HeapEvent{HeapEvent::Pushed, i, -1, value});
+    siftUp(i);
+}
+
+// 根与末尾交换后移出末尾，再从根下滤
+int HeapModel::pop() {
+    int* a = data() + offset;
+    int top = a[0];
+    int last = --m_size;
+    int moved = a[last];
+    a[last] = INT_MAX;
+    if (last > 0) {
+        a[0] = moved;
+        m_changes.notify(HeapEvent{HeapEvent::Swapped, 0, last});
+    }
+    m_changes.notify(HeapEvent{HeapEvent::Popped, last, -1, top});
+    if (m_size > 1) siftDown(0);
+    return top;
+}
+
+void HeapModel::build(const std::vector<int>& values) {
+    m_lines.clear();
+    m_size = 0;
+    reserveSlots(static_cast<int>(values.size()));
+    std::copy(values.begin(), values.end(), data() + offset);
+    m_size = static_cast<int>(values.size());
+    m_changes.notify(HeapEvent{HeapEvent::Rebuilt});
+    for (int i = m_size > 1 ? parent(m_size - 1) : -1; i >= 0; --i) siftDown(i);
+}
+
+// 上滤：父节点依次下移填补空穴，最后把新值放进空穴
+void HeapModel::siftUp(int i) {
+    int* a = data() + offset;
+    int v = a[i];
+    bool report = m_changes.hasListeners();
+    while (i > 0) {
+        int p = parent(i);
+        if (!(v < a[p])) break;
+        a[i] = a[p];
+        if (report) m_changes.notify(HeapEvent{HeapEvent::Swapped, i, p});
+        i = p;
+    }
+    a[i] = v;
+}
+
+// 按叉数分派到展开的实现，内层循环里没有运行时的叉数
+void HeapModel::siftDown(int i) {
+    int* a = data() + offset;
+    const ModelSignal<HeapEvent>* signal = m_changes.hasListeners() ? &m_changes : nullptr;
+    switch (d) {
+    case 4:  siftDownImpl<4>(a, m_size, i, signal); break;
+    case 8:  siftDownImpl<8>(a, m_size, i, signal); break;
+    default: siftDownImpl<2>(a, m_size, i, signal); break;
+    }
+}
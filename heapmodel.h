@@ -0,0 +1,69 @@
+#ifndef HEAPMODEL_H
+#define HEAPMODEL_H
+
+#include "modelsignal.h"
+#include <vector>
+
+// 堆变更事件。上滤、下滤以相邻两个位置的交换报告，视图据此逐步播放
+struct HeapEvent {
+    enum Type {
+        Pushed,     // 值 value 追加到末尾位置 index
+        Swapped,    // 位置 index 与 other 的值交换
+        Popped,     // 末尾位置 index 的值 value 被移出（出堆时根已先与末尾交换）
+        Cleared,
+        Rebuilt,    // build() 把新数组整体放入堆中，随后的 Swapped 为自底向上建堆的下滤
+    };
+    Type type;
+    int  index = -1;
+    int  other = -1;
+    int  value = 0;
+};
+
+// HeapModel 是不依赖 Qt 的 d 叉最小堆（d 取 2、4、8），按隐式完全 d 叉树存放在数组中：
+// 位置 i 的孩子为 d·i+1 .. d·i+d，父节点为 (i-1)/d。
+// 数组整体偏移 d-1 个位置存放，使每个节点的 d 个孩子从 d 的整数倍开始、落在同一条 64 字节缓存行内，
+// 下滤时 4 叉、8 叉堆用 SSE2 一次比较一组孩子求最小值（不支持时退回标量循环）。
+// 堆尾之后的位置填充 INT_MAX，最后一组不满的孩子也能整组比较。
+// 只有在有监听器时才报告交换事件，批处理时上滤、下滤按“空穴”方式移动，不做多余的写入。
+class HeapModel
+{
+public:
+    explicit HeapModel(int arity = 2);
+
+    void setArity(int arity);   // 切换叉数（2、4、8）并清空
+    int  arity() const { return d; }
+
+    int  size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    int  value(int i) const { return data()[offset + i]; }
+    int  top() const { return value(0); }
+    int  parent(int i) const { return (i - 1) / d; }
+    int  firstChild(int i) const { return d * i + 1; }
+
+    void push(int value);
+    int  pop();     // 弹出最小值，堆不能为空
+    // 用 Floyd 算法自底向上建堆：从最后一个内部节点到根依次下滤，O(n)
+    void build(const std::vector<int>& values);
+    void clear();
+
+    ModelSignal<HeapEvent>& changes() { return m_changes; }
+
+private:
+    struct alignas(64) KeyLine {
+        int k[16];
+    };
+
+    int*       data() { return reinterpret_cast<int*>(m_lines.data()); }
+    const int* data() const { return reinterpret_cast<const int*>(m_lines.data()); }
+    void reserveSlots(int count);       // 保证能容纳 count 个元素及最后一组孩子的填充位
+    void siftUp(int i);
+    void siftDown(int i);
+
+    int d = 2;
+    int offset = 1;     // 逻辑位置 i 存放在 data()[offset + i]，offset = d-1
+    int m_size = 0;
+    std::vector<KeyLine> m_lines;
+    ModelSignal<HeapEvent> m_changes;
+};
+
+#endif
@@ -0,0 +1,387 @@
+#include "heapwidget.h"
+#include "NodeItem.h"
+#include "nodeitempool.h"
+#include "animationscheduler.h"
+
+#include <QApplication>
+#include <QGraphicsScene>
+#include <QGraphicsView>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QPushButton>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QSpinBox>
+#include <QLabel>
+#include <QMessageBox>
+#include <QElapsedTimer>
+#include <QPainter>
+#include <QLineF>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <random>
+
+HeapWidget::HeapWidget(QWidget* parent)
+    : QWidget(parent), model(2),
+      stepChannel(AnimationScheduler::instance().newChannel()),
+      tweenChannel(AnimationScheduler::instance().newChannel())
+{
+    auto *mainLayout = new QVBoxLayout(this);
+
+    scene = new QGraphicsScene(this);
+    pool = std::make_unique<NodeItemPool>(scene);
+    view  = new QGraphicsView(scene, this);
+    view->setRenderHint(QPainter::Antialiasing);
+    view->setDragMode(QGraphicsView::ScrollHandDrag);
+    view->setResizeAnchor(QGraphicsView::AnchorUnderMouse);
+    view->setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+    mainLayout->addWidget(view);
+
+    // 背后的数组单独放在一个可横向滚动的视图中
+    arrayScene = new QGraphicsScene(this);
+    arrayView = new QGraphicsView(arrayScene, this);
+    arrayView->setFixedHeight(int(ArrayStripItem::CellHeight + ArrayStripItem::LabelHeight) + 30);
+    arrayView->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
+    arrayView->setDragMode(QGraphicsView::ScrollHandDrag);
+    mainLayout->addWidget(arrayView);
+
+    // 控制面板
+    arityBox = new QComboBox(this);
+    arityBox->addItems({"二叉堆", "四叉堆", "八叉堆"});
+    valueEdit = new QLineEdit(this);
+    valueEdit->setPlaceholderText("值");
+    pushButton   = new QPushButton("入堆", this);
+    popButton    = new QPushButton("出堆", this);
+    randomButton = new QPushButton("随机入堆10个", this);
+    buildSpin = new QSpinBox(this);
+    buildSpin->setRange(1, 1000);
+    buildSpin->setValue(30);
+    buildSpin->setPrefix("元素数 ");
+    buildButton  = new QPushButton("批量建堆", this);
+    clearButton  = new QPushButton("清空", this);
+    benchButton  = new QPushButton("性能测试", this);
+
+    auto *hlay = new QHBoxLayout;
+    hlay->addWidget(arityBox);
+    hlay->addWidget(valueEdit);
+    hlay->addWidget(pushButton);
+    hlay->addWidget(popButton);
+    hlay->addWidget(randomButton);
+    hlay->addWidget(buildSpin);
+    hlay->addWidget(buildButton);
+    hlay->addWidget(clearButton);
+    hlay->addWidget(benchButton);
+    mainLayout->addLayout(hlay);
+
+    statusLabel = new QLabel(this);
+    mainLayout->addWidget(statusLabel);
+
+    connect(arityBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &HeapWidget::onArityChanged);
+    connect(pushButton,   &QPushButton::clicked, this, &HeapWidget::onPush);
+    connect(popButton,    &QPushButton::clicked, this, &HeapWidget::onPop);
+    connect(randomButton, &QPushButton::clicked, this, &HeapWidget::onRandomPush);
+    connect(buildButton,  &QPushButton::clicked, this, &HeapWidget::onBuild);
+    connect(clearButton,  &QPushButton::clicked, this, &HeapWidget::onClear);
+    connect(benchButton,  &QPushButton::clicked, this, &HeapWidget::onBenchmark);
+    connect(valueEdit, &QLineEdit::returnPressed, this, &HeapWidget::onPush);
+
+    edges = new EdgeLayerItem;  // 所有父子连线由一个图元批量绘制
+    edges->setZValue(-1);
+    scene->addItem(edges);
+    strip = new ArrayStripItem;
+    arrayScene->addItem(strip);
+
+    // 订阅模型变更，所有图元都由模型事件驱动
+    model.changes().subscribe([this](const HeapEvent& e) { onModelChanged(e); });
+    resetScene(false);
+}
+
+// 补间引用的图元随场景一起删除，控件销毁前先丢弃本控件的动画
+HeapWidget::~HeapWidget() {
+    AnimationScheduler::instance().cancel(stepChannel);
+    AnimationScheduler::instance().cancel(tweenChannel);
+}
+
+// 下拉框的第 index 项对应 2^(index+1) 叉
+void HeapWidget::onArityChanged(int index) {
+    model.setArity(2 << index);
+}
+
+void HeapWidget::onPush() {
+    bool ok;
+    int value = valueEdit->text().toInt(&ok);
+    if (!ok) {
+        QMessageBox::warning(this, "输入错误", "请输入整数值！");
+        return;
+    }
+    model.push(value);
+}
+
+void HeapWidget::onPop() {
+    if (model.empty()) {
+        QMessageBox::information(this, "提示", "堆为空！");
+        return;
+    }
+    model.pop();
+}
+
+void HeapWidget::onRandomPush() {
+    static std::mt19937 rng(std::random_device{}());
+    std::uniform_int_distribution<int> dist(1, 99);
+    for (int i = 0; i < 10; ++i) model.push(dist(rng));
+}
+
+void HeapWidget::onBuild() {
+    static std::mt19937 rng(std::random_device{}());
+    std::uniform_int_distribution<int> dist(1, 999);
+    std::vector<int> values(buildSpin->value());
+    for (int& v : values) v = dist(rng);
+    model.build(values);
+}
+
+void HeapWidget::onClear() {
+    model.clear();
+}
+
+// 在不挂监听器的模型上测量，出堆序列同时校验是否非降
+void HeapWidget::onBenchmark() {
+    const int n = 10000000;
+    std::vector<int> values(n);
+    std::mt19937 rng(42);
+    for (int& v : values) v = static_cast<int>(rng());
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+
+    QString report = QString("%1 个随机整数，单位为毫秒\n\n\t入堆\t出堆\t建堆\n").arg(n);
+    QElapsedTimer clock;
+    bool sorted = true;
+    for (int d : {2, 4, 8}) {
+        HeapModel bench(d);
+        clock.start();
+        for (int v : values) bench.push(v);
+        qint64 pushMs = clock.elapsed();
+        clock.start();
+        int previous = INT_MIN;
+        while (!bench.empty()) {
+            int v = bench.pop();
+            sorted = sorted && previous <= v;
+            previous = v;
+        }
+        qint64 popMs = clock.elapsed();
+        clock.start();
+        bench.build(values);
+        qint64 buildMs = clock.elapsed();
+        report += QString("%1 叉堆\t%2\t%3\t%4\n").arg(d).arg(pushMs).arg(popMs).arg(buildMs);
+    }
+
+    std::priority_queue<int, std::vector<int>, std::greater<int>> reference;
+    clock.start();
+    for (int v : values) reference.push(v);
+    qint64 pushMs = clock.elapsed();
+    clock.start();
+    while (!reference.empty()) reference.pop();
+    qint64 popMs = clock.elapsed();
+    clock.start();
+    std::priority_queue<int, std::vector<int>, std::greater<int>> built(std::greater<int>(), values);
+    qint64 buildMs = clock.elapsed();
+    report += QString("std::priority_queue\t%1\t%2\t%3\n").arg(pushMs).arg(popMs).arg(buildMs);
+    if (!sorted) report += "\n校验失败：出堆序列不是非降的";
+
+    QApplication::restoreOverrideCursor();
+    QMessageBox::information(this, "性能测试", report);
+}
+
+// 清空和批量建堆直接重置显示；其余事件排队逐步播放
+void HeapWidget::onModelChanged(const HeapEvent& e) {
+    switch (e.type) {
+    case HeapEvent::Cleared:
+        resetScene(false);
+        break;
+    case HeapEvent::Rebuilt:
+        resetScene(true);   // 此时模型中是尚未调整的原始数组，随后的交换逐步把它变成堆
+        break;
+    default:
+        pending.push_back(e);
+        if (!playing) {
+            playing = true;
+            AnimationScheduler::instance().every(stepChannel, StepMs, [this]() { return playSteps(); });
+        }
+        break;
+    }
+}
+
+void HeapWidget::resetScene(bool fromModel) {
+    auto& scheduler = AnimationScheduler::instance();
+    pending.clear();
+    scheduler.cancel(stepChannel);
+    playing = false;
+    scheduler.finish(tweenChannel);     // 淡出中的节点随之回收
+    lit.clear();
+    for (NodeItem* item : items) pool->release(item);
+    items.clear();
+
+    std::vector<int> values;
+    if (fromModel) {
+        for (int i = 0; i < model.size(); ++i) values.push_back(model.value(i));
+    }
+    for (int v : values) items.push_back(pool->acquire(v));
+    strip->setGroupSize(model.arity());
+    strip->setValues(std::move(values));
+    shownLevels = levelsFor(static_cast<int>(items.size()));
+    relayout(false);
+    statusLabel->setText(QString("%1 叉最小堆，%2 个元素").arg(model.arity()).arg(model.size()));
+}
+
+// 队列较短时每次播放一步并带动画；较长时每次快进多余部分的一半，最后一段仍逐步播放
+bool HeapWidget::playSteps() {
+    AnimationScheduler::instance().finish(tweenChannel);   // 上一步的补间直接到位
+    unlight();
+    if (pending.empty()) {
+        playing = false;
+        return false;
+    }
+    bool animate = pending.size() <= size_t(MaxAnimatedSteps);
+    size_t count = animate ? 1 : (pending.size() - MaxAnimatedSteps + 1) / 2 + 1;
+    for (size_t k = 0; k < count; ++k) {
+        HeapEvent e = pending.front();
+        pending.pop_front();
+        applyStep(e, animate);
+    }
+    return true;
+}
+
+void HeapWidget::applyStep(const HeapEvent& e, bool animate) {
+    auto& scheduler = AnimationScheduler::instance();
+    switch (e.type) {
+    case HeapEvent::Pushed: {
+        auto* item = pool->acquire(e.value);
+        items.push_back(item);
+        strip->push(e.value);
+        int levels = levelsFor(static_cast<int>(items.size()));
+        if (levels != shownLevels) {
+            // 新开一层，整棵树按新的宽度重新排布
+            shownLevels = levels;
+            item->setPos(slotPos(e.index));
+            relayout(animate);
+        } else {
+            item->setPos(slotPos(e.index));
+            addEdge(e.index);
+        }
+        if (animate) {
+            item->setOpacity(0.0);
+            scheduler.animateOpacity(item, 0.0, 1.0, StepMs * 4 / 5, tweenChannel);
+        }
+        light(e.index);
+        updateSceneRect();
+        break;
+    }
+    case HeapEvent::Swapped:
+        // 树中两个节点互换位置，数组中两个格子互换值
+        std::swap(items[e.index], items[e.other]);
+        moveItem(items[e.index], slotPos(e.index), animate);
+        moveItem(items[e.other], slotPos(e.other), animate);
+        strip->swap(e.index, e.other);
+        light(e.index);
+        light(e.other);
+        break;
+    case HeapEvent::Popped: {
+        // 此时末尾是原来的根，它向上移出并淡出
+        NodeItem* item = items.back();
+        items.pop_back();
+        strip->pop();
+        if (e.index > 0) edges->removeLast();
+        if (animate) {
+            int group = scheduler.createGroup(tweenChannel, [this, item]() { pool->release(item); });
+            scheduler.animatePos(item, item->pos(), item->pos() - QPointF(0, LevelGap / 2), StepMs * 4 / 5, tweenChannel, group);
+            scheduler.animateOpacity(item, 1.0, 0.0, StepMs * 4 / 5, tweenChannel, group);
+        } else {
+            pool->release(item);
+        }
+        int levels = levelsFor(static_cast<int>(items.size()));
+        if (levels != shownLevels) {
+            shownLevels = levels;
+            relayout(animate);
+        }
+        updateSceneRect();
+        statusLabel->setText(QString("出堆：%1，剩余 %2 个元素").arg(e.value).arg(items.size()));
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void HeapWidget::light(int i) {
+    items[i]->setColors(QColor(255, 140, 0), Qt::white);
+    strip->setMark(i, ArrayStripItem::Active);
+    arrayView->ensureVisible(strip->cellRect(i));
+    lit.push_back(i);
+}
+
+void HeapWidget::unlight() {
+    for (int i : lit) {
+        if (i < static_cast<int>(items.size())) items[i]->setColors(Qt::blue, Qt::white);
+    }
+    lit.clear();
+    strip->clearMarks();
+}
+
+int HeapWidget::levelsFor(int n) const {
+    int levels = 0;
+    long long count = 0, width = 1;
+    while (count < n) {
+        count += width;
+        width *= model.arity();
+        ++levels;
+    }
+    return levels;
+}
+
+// 按完整的 shownLevels 层 d 叉树划分横向位置：第 L 层每个位置占最底层 d^(shownLevels-1-L) 个间距
+QPointF HeapWidget::slotPos(int i) const {
+    const int d = model.arity();
+    int level = 0;
+    long long first = 0, width = 1;
+    while (i >= first + width) {
+        first += width;
+        width *= d;
+        ++level;
+    }
+    qreal leaves = std::pow(qreal(d), std::max(0, shownLevels - 1));
+    qreal slotWidth = Spacing * leaves / width;
+    return QPointF((i - first + 0.5) * slotWidth - Spacing * leaves / 2 - R, level * LevelGap);
+}
+
+void HeapWidget::relayout(bool animate) {
+    for (int i = 0; i < static_cast<int>(items.size()); ++i) moveItem(items[i], slotPos(i), animate);
+    edges->clear();
+    edges->reserve(static_cast<int>(items.size()));
+    for (int i = 1; i < static_cast<int>(items.size()); ++i) addEdge(i);
+    updateSceneRect();
+}
+
+// 连线按位置的目标坐标计算，两端各缩进一个半径
+void HeapWidget::addEdge(int i) {
+    QPointF pc = slotPos((i - 1) / model.arity()) + QPointF(R, R);
+    QPointF cc = slotPos(i) + QPointF(R, R);
+    qreal len = QLineF(pc, cc).length();     // 相邻位置的间距都大于直径
+    QPointF step = (cc - pc) * (R / len);
+    edges->addEdge(pc + step, cc - step, 0);
+}
+
+void HeapWidget::moveItem(NodeItem* item, const QPointF& to, bool animate) {
+    if (item->pos() == to) return;
+    if (animate) AnimationScheduler::instance().animatePos(item, item->pos(), to, StepMs * 4 / 5, tweenChannel);
+    else item->setPos(to);
+}
+
+// 场景范围跟随最底层的宽度，至少保留 800×500 的初始区域
+void HeapWidget::updateSceneRect() {
+    const qreal margin = 40;
+    qreal width = Spacing * std::pow(qreal(model.arity()), std::max(0, shownLevels - 1));
+    QRectF bounds(-width / 2 - margin, -margin, width + 2 * margin, shownLevels * LevelGap + margin);
+    scene->setSceneRect(bounds.united(QRectF(-400, -margin, 800, 500)));
+    arrayScene->setSceneRect(strip->boundingRect().adjusted(-10, -10, 10, 10));
+}
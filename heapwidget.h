@@ -0,0 +1,95 @@
+#ifndef HEAPWIDGET_H
+#define HEAPWIDGET_H
+
+#include <QWidget>
+#include <QPointF>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "heapmodel.h"
+#include "edgelayeritem.h"
+#include "arraystripitem.h"
+
+class QGraphicsScene;
+class QGraphicsView;
+class QPushButton;
+class QComboBox;
+class QLineEdit;
+class QSpinBox;
+class QLabel;
+class NodeItem;
+class NodeItemPool;
+
+// HeapWidget 是优先队列（d 叉最小堆）的可视化控件：上方按隐式完全 d 叉树画出节点，
+// 下方画出背后的数组，同一个节点的孩子在数组中连续、交替底色。
+// 模型一次操作产生的交换事件排队逐步播放，树中两个节点互换位置，数组中对应的格子同时点亮；
+// 排队的步骤很多时（例如批量建堆）每帧合并执行多步。“性能测试”比较各叉数在一千万个元素上的吞吐量
+class HeapWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit HeapWidget(QWidget* parent = nullptr);
+    ~HeapWidget() override;
+
+    // 堆模型，可脱离界面直接驱动；控件订阅其变更事件并据此绘制
+    HeapModel& heapModel() { return model; }
+
+private slots:
+    void onArityChanged(int index);     // 切换叉数，清空堆
+    void onPush();
+    void onPop();
+    void onRandomPush();    // 随机入堆 10 个
+    void onBuild();         // 随机生成一批值，用 Floyd 算法自底向上建堆
+    void onClear();
+    void onBenchmark();     // 比较各叉数的入堆、出堆、建堆吞吐量
+
+private:
+    static constexpr qreal R = 20;              // 节点半径
+    static constexpr qreal Spacing = 50;        // 最底层相邻位置的间距
+    static constexpr qreal LevelGap = 90;
+    static constexpr int   StepMs = 350;        // 逐步播放时每一步的间隔
+    static constexpr int   MaxAnimatedSteps = 60;   // 排队的步骤超过这么多时每帧合并执行
+
+    QGraphicsScene* scene;
+    QGraphicsView* view;
+    QGraphicsScene* arrayScene;
+    QGraphicsView* arrayView;
+    QComboBox* arityBox;
+    QLineEdit* valueEdit;
+    QPushButton* pushButton;
+    QPushButton* popButton;
+    QPushButton* randomButton;
+    QSpinBox*    buildSpin;
+    QPushButton* buildButton;
+    QPushButton* clearButton;
+    QPushButton* benchButton;
+    QLabel* statusLabel;
+    HeapModel model;
+    EdgeLayerItem* edges;       // 边 i-1 连接位置 i 与其父节点
+    ArrayStripItem* strip;
+
+    // 显示状态落后于模型：事件先排队，播放到哪一步，图元和数组就反映到哪一步
+    std::deque<HeapEvent> pending;
+    std::unique_ptr<NodeItemPool> pool; // 节点图元池：出堆淡出的图元回收后供入堆复用
+    std::vector<NodeItem*> items;       // 按堆中位置存放的图元
+    std::vector<int> lit;               // 上一步点亮的位置
+    int shownLevels = 0;                // 当前图元布局按多少层计算
+    bool playing = false;
+    int stepChannel;        // 逐步播放的定时步骤
+    int tweenChannel;       // 节点移动、淡入淡出的补间
+
+    void onModelChanged(const HeapEvent& e);
+    void resetScene(bool fromModel);    // 删除所有图元；fromModel 时按模型当前数组重建
+    bool playSteps();       // 播放一帧，队列空时返回 false
+    void applyStep(const HeapEvent& e, bool animate);
+    void unlight();
+    void light(int i);
+    int  levelsFor(int n) const;        // n 个元素的完全 d 叉树的层数
+    QPointF slotPos(int i) const;       // 位置 i 的节点左上角（按 shownLevels 层布局）
+    void relayout(bool animate);        // 层数变化后所有节点移到新位置，连线重建
+    void addEdge(int i);
+    void moveItem(NodeItem* item, const QPointF& to, bool animate);
+    void updateSceneRect();
+};
+
+#endif
@@ -0,0 +1,106 @@
+#include "importbar.h"
+
+#include <QHBoxLayout>
+#include <QPushButton>
+#include <QProgressBar>
+#include <QLabel>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <utility>
+
+ImportBar::ImportBar(QWidget* parent)
+    : QWidget(parent)
+{
+    auto* lay = new QHBoxLayout(this);
+    lay->setContentsMargins(0, 0, 0, 0);
+    importButton = new QPushButton("导入数据", this);
+    progressBar  = new QProgressBar(this);
+    progressBar->setRange(0, 100);
+    progressBar->setVisible(false);
+    statusLabel  = new QLabel(this);
+    lay->addWidget(importButton);
+    lay->addWidget(progressBar);
+    lay->addWidget(statusLabel, 1);
+
+    connect(importButton, &QPushButton::clicked, this, &ImportBar::onImport);
+}
+
+ImportBar::~ImportBar() {
+    stop();
+}
+
+void ImportBar::stop() {
+    if (!thread) return;
+    ++generation;
+    finishThread();
+    setRunning(false);
+    job = ImportJob();  // 丢弃暂存的模型
+}
+
+void ImportBar::setBlocked(const QString& reason) {
+    bool blocked = !reason.isEmpty();
+    if (blocked && thread) {
+        stop();
+        statusLabel->setText("已取消导入：" + reason);
+    } else {
+        statusLabel->setText(reason);
+    }
+    importButton->setEnabled(!blocked);
+    importButton->setToolTip(reason);
+}
+
+void ImportBar::onImport() {
+    if (thread) {
+        stop();
+        statusLabel->setText("已取消导入");
+        return;
+    }
+    if (!makeJob) return;
+    QString path = QFileDialog::getOpenFileName(this, "导入整数数据", QString(),
+        "整数数据 (*.csv *.txt *.bin *.i32);;所有文件 (*)");
+    if (path.isEmpty()) return;
+
+    job = makeJob();
+    thread = new ImportThread(path, job, ++generation, this);
+    connect(thread, &ImportThread::progress, this, &ImportBar::onProgress);
+    connect(thread, &ImportThread::importDone, this, &ImportBar::onImportDone);
+    clock.start();
+    setRunning(true);
+    statusLabel->setText("正在导入");
+    thread->start(QThread::LowPriority);
+}
+
+void ImportBar::onProgress(int generation, int percent) {
+    if (generation != this->generation) return;
+    progressBar->setValue(percent);
+    if (percent >= ImportThread::ParseShare) statusLabel->setText("正在准备视图");
+}
+
+// 工作线程发出结果后即退出，这里的等待很短；换入暂存模型只交换容器，不随数据量增长
+void ImportBar::onImportDone(int generation, bool ok, const QString& message, qint64 count) {
+    if (generation != this->generation) return;
+    finishThread();
+    setRunning(false);
+    ImportJob done = std::move(job);
+    job = ImportJob();
+    if (!ok) {
+        statusLabel->setText("导入失败");
+        QMessageBox::warning(this, "导入失败", message);
+        return;
+    }
+    done.commit();
+    statusLabel->setText(QString("已导入 %1 个整数，用时 %2 ms").arg(count).arg(clock.elapsed()));
+}
+
+void ImportBar::finishThread() {
+    thread->requestInterruption();
+    thread->wait();
+    delete thread;
+    thread = nullptr;
+}
+
+void ImportBar::setRunning(bool running) {
+    importButton->setText(running ? "取消导入" : "导入数据");
+    progressBar->setValue(0);
+    progressBar->setVisible(running);
+}
@@ -0,0 +1,49 @@
+#ifndef IMPORTBAR_H
+#define IMPORTBAR_H
+
+#include <QWidget>
+#include <QElapsedTimer>
+#include <functional>
+#include "importthread.h"
+
+class QPushButton;
+class QProgressBar;
+class QLabel;
+
+// ImportBar 是从文件批量导入整数的一排控件，链表和二叉树控件共用。
+// 文件在工作线程中映射、逐块解析并填充暂存的模型，界面只显示进度；完成后由控件一次性换入，
+// 导入过程中可以取消，控件照常响应其他操作（导入完成时被整体替换）
+class ImportBar : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit ImportBar(QWidget* parent = nullptr);
+    ~ImportBar() override;
+
+    // 每次开始导入时调用，为这次导入准备暂存模型并返回任务
+    void setJobFactory(std::function<ImportJob()> factory) { makeJob = std::move(factory); }
+    void stop();    // 取消进行中的导入并等待工作线程退出
+    // 暂时禁止导入并在按钮旁说明原因，进行中的导入随之取消；reason 为空时恢复
+    void setBlocked(const QString& reason);
+
+private slots:
+    void onImport();    // 选择文件并开始导入；导入中再次点击则取消
+    void onProgress(int generation, int percent);
+    void onImportDone(int generation, bool ok, const QString& message, qint64 count);
+
+private:
+    void finishThread();
+    void setRunning(bool running);
+
+    std::function<ImportJob()> makeJob;
+    ImportJob job;          // 进行中的导入，commit 在界面线程中调用
+    ImportThread* thread = nullptr;
+    int generation = 0;     // 每次开始或取消导入加一，用来丢弃过期的消息
+    QElapsedTimer clock;
+
+    QPushButton*  importButton;
+    QProgressBar* progressBar;
+    QLabel*       statusLabel;
+};
+
+#endif
@@ -0,0 +1,49 @@
+#include "importthread.h"
+#include "intimporter.h"
+#include <QFile>
+#include <algorithm>
+
+ImportThread::ImportThread(const QString& path, ImportJob job, int generation, QObject* parent)
+    : QThread(parent), path(path), job(std::move(job)), generation(generation)
+{
+}
+
+void ImportThread::run() {
+    std::string local = QFile::encodeName(path).toStdString();
+    IntImporter importer;
+    if (!importer.open(local, IntImporter::formatFor(local))) {
+        emit importDone(generation, false, QString::fromStdString(importer.error()), 0);
+        return;
+    }
+
+    std::size_t total = std::max<std::size_t>(1, importer.size());
+    qint64 count = 0;
+    int shown = -1;
+    std::string error;
+    bool ok = importer.parse([&](const int* values, std::size_t n, std::size_t done) {
+        if (isInterruptionRequested()) return false;
+        if (!job.consume(values, n, error)) return false;
+        count += static_cast<qint64>(n);
+        int percent = static_cast<int>(double(done) / total * ParseShare);
+        if (percent != shown) {
+            shown = percent;
+            emit progress(generation, percent);
+        }
+        return true;
+    });
+    if (isInterruptionRequested()) return;
+    if (!ok) {
+        emit importDone(generation, false, QString::fromStdString(error.empty() ? importer.error() : error), count);
+        return;
+    }
+    if (count == 0) {
+        emit importDone(generation, false, "文件中没有整数", 0);
+        return;
+    }
+    importer.close();   // 数据已全部进入暂存模型，尽早解除映射
+
+    if (job.prepare) job.prepare();
+    if (isInterruptionRequested()) return;
+    emit progress(generation, 100);
+    emit importDone(generation, true, QString(), count);
+}
@@ -0,0 +1,43 @@
+#ifndef IMPORTTHREAD_H
+#define IMPORTTHREAD_H
+
+#include <QThread>
+#include <QString>
+#include <cstddef>
+#include <functional>
+#include <string>
+
+// 一次导入要做的事，由目标控件提供。consume 和 prepare 在工作线程中执行，
+// 只能访问控件为这次导入单独准备的暂存模型；commit 在界面线程中把暂存的结果换入控件
+struct ImportJob {
+    // 追加一块数据；返回 false 时中止导入，原因写入 error
+    std::function<bool(const int* values, std::size_t count, std::string& error)> consume;
+    std::function<void()> prepare;  // 数据全部到齐后准备视图（槽位、布局），可为空
+    std::function<void()> commit;
+};
+
+// 在工作线程中映射并逐块解析数据文件，把每块交给 job.consume，最后调用 job.prepare。
+// 解析进度按百分比发出，被 requestInterruption() 打断时不再发出结果
+class ImportThread : public QThread
+{
+    Q_OBJECT
+public:
+    static constexpr int ParseShare = 90;   // 解析和填充模型占进度的前 90%，其余留给 prepare
+
+    ImportThread(const QString& path, ImportJob job, int generation, QObject* parent = nullptr);
+
+signals:
+    // generation 用来识别过期的消息：取消后重新导入时，旧线程留在事件队列中的消息会被丢弃
+    void progress(int generation, int percent);
+    void importDone(int generation, bool ok, const QString& message, qint64 count);
+
+protected:
+    void run() override;
+
+private:
+    QString path;
+    ImportJob job;
+    int generation;
+};
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef INDEXEDHEAP_H
+#define INDEXEDHEAP_H
+
+#include <utility>
+#include <vector>
+
+// IndexedMinHeap 是带位置索引的二叉最小堆，元素为 0..n-1 的整数编号。
+// pos[id] 记录编号在堆数组中的位置，因此可以 O(log n) 降低某个编号的键（decrease-key），
+// Dijkstra 中每个顶点至多在堆中出现一次，不需要“懒删除”重复入堆。
+template <typename Key>
+class IndexedMinHeap
+{
+public:
+    static constexpr int absent = -1;
+
+    explicit IndexedMinHeap(int capacity = 0) { reset(capacity); }
+
+    // 清空并容纳编号 0..capacity-1
+    void reset(int capacity) {
+        heap.clear();
+        keys.assign(capacity, Key());
+        pos.assign(capacity, absent);
+    }
+
+    bool empty() const { return heap.empty(); }
+    int  size() const { return static_cast<int>(heap.size()); }
+    bool contains(int id) const { return pos[id] != absent; }
+    int  top() const { return heap.front(); }
+    const Key& key(int id) const { return keys[id]; }
+
+    // 插入编号；已在堆中时等同于 decrease
+    void push(int id, const Key& k) {
+        if (contains(id)) { decrease(id, k); return; }
+        keys[id] = k;
+        pos[id] = size();
+        heap.push_back(id);
+        siftUp(pos[id]);
+    }
+
+    // 把编号的键降低到 k；k 不小于当前键时不做任何事
+    void decrease(int id, const Key& k) {
+        if (!(k < keys[id])) return;
+        keys[id] = k;
+        siftUp(pos[id]);
+    }
+
+    // 弹出键最小的编号
+    int pop() {
+        int id = heap.front();
+        int last = heap.back();
+        heap.pop_back();
+        pos[id] = absent;
+        if (!heap.empty()) {
+            heap[0] = last;
+            pos[last] = 0;
+            siftDown(0);
+        }
+        return id;
+    }
+
+private:
+    void place(int i, int id) {
+        heap[i] = id;
+        pos[id] = i;
+    }
+
+    void siftUp(int i) {
+        int id = heap[i];
+        while (i > 0) {
+            int p = (i - 1) / 2;
+            if (!(keys[id] < keys[heap[p]])) break;
+            place(i, heap[p]);
+            i = p;
+        }
+        place(i, id);
+    }
+
+    void siftDown(int i) {
+        int id = heap[i];
+        int n = size();
+        for (;;) {
+            int c = 2 * i + 1;
+            if (c >= n) break;
+            if (c + 1 < n && keys[heap[c + 1]] < keys[heap[c]]) ++c;
+            if (!(keys[heap[c]] < keys[id])) break;
+            place(i, heap[c]);
+            i = c;
+        }
+        place(i, id);
+    }
+
+    std::vector<int> heap;  // 堆数组，存放编号
+    std::vector<Key> keys;  // 按编号存放键
+    std::vector<int> pos;   // 按编号存放在堆数组中的位置，不在堆中为 absent
+};
+
+#endif
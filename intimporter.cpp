@@ -0,0 +1,159 @@
+#include "intimporter.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define INTIMPORTER_SSE2 1
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace {
+
+inline bool isDigit(std::uint8_t c) {
+    return static_cast<unsigned>(c - '0') < 10;
+}
+
+#ifdef INTIMPORTER_SSE2
+// 16 个字节中哪些是数字：减去 '0' 后按无符号比较是否小于 10（翻转符号位后用有符号比较代替）
+inline unsigned digitMask(const std::uint8_t* p) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i t = _mm_xor_si128(_mm_sub_epi8(x, _mm_set1_epi8('0')), _mm_set1_epi8(char(0x80)));
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmplt_epi8(t, _mm_set1_epi8(char(0x80 + 10)))));
+}
+
+inline unsigned lowestBit(unsigned m) {
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward(&i, m);
+    return i;
+#else
+    return static_cast<unsigned>(__builtin_ctz(m));
+#endif
+}
+
+// 把 p 开始的 len（1～8）位数字组合成整数。8 个字节按小端读入后左移，数字靠到高位、低位补 0，
+// 相当于前面补零的 8 位数；再依次把相邻的 1、2、4 位合并，共三次乘法
+inline std::uint32_t parseDigits8(const std::uint8_t* p, unsigned len) {
+    std::uint64_t v;
+    std::memcpy(&v, p, 8);
+    if (len < 8) v <<= 8 * (8 - len);
+    v = ((v & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+    v = ((v & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+    return static_cast<std::uint32_t>(((v & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32);
+}
+#endif
+
+}
+
+IntImporter::Format IntImporter::formatFor(const std::string& path) {
+    std::string ext = path.substr(std::min(path.size(), path.find_last_of('.')));
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return char(std::tolower(c)); });
+    return ext == ".bin" || ext == ".i32" ? Binary32 : Text;
+}
+
+bool IntImporter::open(const std::string& path, Format fmt) {
+    message.clear();
+    format = fmt;
+    if (!file.open(path)) {
+        message = "无法打开文件";
+        return false;
+    }
+    return true;
+}
+
+bool IntImporter::parse(const Sink& sink) {
+    message.clear();
+    return format == Binary32 ? parseBinary(sink) : parseText(sink);
+}
+
+bool IntImporter::fail(const std::string& what, std::size_t offset) {
+    if (format == Text) {
+        const std::uint8_t* base = file.data();
+        long long line = 1 + std::count(base, base + offset, '\n');
+        message = "第 " + std::to_string(line) + " 行：" + what;
+    } else {
+        message = "偏移 " + std::to_string(offset) + "：" + what;
+    }
+    return false;
+}
+
+// 按块解析文本：块的末尾推到数字串之后，数字不会被块边界截断。
+// 剩余不足 16 字节时（只在文件末尾）逐字节处理
+bool IntImporter::parseText(const Sink& sink) {
+    const std::uint8_t* const begin = file.data();
+    const std::uint8_t* const end = begin + file.size();
+    const std::uint8_t* p = begin;
+    values.reserve(ChunkBytes / 4);
+
+    while (p < end) {
+        const std::uint8_t* stop = static_cast<std::size_t>(end - p) > ChunkBytes ? p + ChunkBytes : end;
+        while (stop < end && (isDigit(*stop) || *stop == '-')) ++stop;
+        values.clear();
+
+        while (p < stop) {
+            // 跳过分隔符，p 停在下一个数字串的开头
+#ifdef INTIMPORTER_SSE2
+            if (end - p >= 16) {
+                unsigned m = digitMask(p);
+                if (m == 0) { p += 16; continue; }
+                p += lowestBit(m);
+            } else
+#endif
+            if (!isDigit(*p)) { ++p; continue; }
+            if (p >= stop) break;   // 属于下一块
+
+            bool negative = p > begin && p[-1] == '-';
+            std::uint64_t magnitude = 0;
+            const std::uint8_t* q = p;
+#ifdef INTIMPORTER_SSE2
+            unsigned len = end - p >= 16 ? lowestBit(~digitMask(p)) : 16;
+            if (len <= 8) {
+                magnitude = parseDigits8(p, len);
+                q = p + len;
+            } else if (len <= 10) {
+                magnitude = parseDigits8(p, 8);
+                for (q = p + 8; q < p + len; ++q) magnitude = magnitude * 10 + (*q - '0');
+            } else
+#endif
+            {
+                // 文件末尾、超长或带前导零的数字串：逐位累加，超过 32 位后不再增长，只用于判断越界
+                for (; q < end && isDigit(*q); ++q) {
+                    if (magnitude <= 0xFFFFFFFFULL) magnitude = magnitude * 10 + (*q - '0');
+                }
+            }
+
+            if (q + 1 < end && *q == '.' && isDigit(q[1]))
+                return fail("不支持小数", static_cast<std::size_t>(p - begin));
+            if (magnitude > (negative ? 0x80000000ULL : 0x7FFFFFFFULL))
+                return fail("数值超出 int 范围", static_cast<std::size_t>(p - begin));
+            values.push_back(negative ? static_cast<int>(-static_cast<long long>(magnitude))
+                                      : static_cast<int>(magnitude));
+            p = q;
+        }
+
+        if (!sink(values.data(), values.size(), static_cast<std::size_t>(std::min(p, end) - begin))) return false;
+    }
+    return true;
+}
+
+bool IntImporter::parseBinary(const Sink& sink) {
+    std::size_t total = file.size();
+    if (total % 4 != 0) return fail("文件长度不是 4 的倍数", total - total % 4);
+    const std::uint8_t* base = file.data();
+    for (std::size_t done = 0; done < total;) {
+        std::size_t bytes = std::min(ChunkBytes, total - done);
+        values.resize(bytes / 4);
+        std::memcpy(values.data(), base + done, bytes);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        for (int& v : values) v = static_cast<int>(__builtin_bswap32(static_cast<std::uint32_t>(v)));
+#endif
+        done += bytes;
+        if (!sink(values.data(), values.size(), done)) return false;
+    }
+    return true;
+}
@@ -0,0 +1,49 @@
+#ifndef INTIMPORTER_H
+#define INTIMPORTER_H
+
+#include "mappedfile.h"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// IntImporter 从文件中流式读取整数数据集，用于把大量键一次性导入链表或二叉树。
+// 文件映射到内存后按块解析，每块解析出的整数交给回调，整个文件的数值不会同时驻留在内存中。
+//
+// 支持两种格式：
+//  - 文本（CSV、每行一个数等）：整数是可选的 '-' 加一串十进制数字，其余字符都当作分隔符，
+//    因此表头等不含数字的内容被跳过；数字后紧跟小数点或超出 int 范围时报错。
+//    SSE2 下每次比较 16 个字节跳过分隔符、求出数字串长度，最多 8 位的数字串用一次 64 位乘法组合
+//  - 二进制：连续的 32 位小端有符号整数，文件长度必须是 4 的倍数
+class IntImporter
+{
+public:
+    enum Format { Text, Binary32 };
+
+    // 每块的回调：本块解析出的整数，以及已解析的字节数；返回 false 时停止解析
+    using Sink = std::function<bool(const int* values, std::size_t count, std::size_t bytesDone)>;
+
+    static constexpr std::size_t ChunkBytes = 1 << 20;     // 每块约 1 MiB 输入
+
+    static Format formatFor(const std::string& path);   // 按扩展名判断：.bin/.i32 为二进制，其余为文本
+
+    bool open(const std::string& path, Format format);
+    void close() { file.close(); }
+    std::size_t size() const { return file.size(); }
+
+    // 从头到尾解析一遍。格式错误或回调要求停止时返回 false，前者由 error() 给出原因
+    bool parse(const Sink& sink);
+    const std::string& error() const { return message; }
+
+private:
+    bool parseText(const Sink& sink);
+    bool parseBinary(const Sink& sink);
+    bool fail(const std::string& what, std::size_t offset);
+
+    MappedFile file;
+    Format format = Text;
+    std::vector<int> values;    // 一块的解析结果，跨块复用
+    std::string message;
+};
+
+#endif
@@ -0,0 +1,105 @@
+#include "linkedlistmodel.h"
+#include <iterator>
+#include <utility>
+
+int LinkedListModel::append() {
+    return insertBefore(nodes.end(), nextId);
+}
+
+int LinkedListModel::append(int value) {
+    return insertBefore(nodes.end(), value);
+}
+
+int LinkedListModel::insertAfter(int targetId) {
+    auto found = index.find(targetId);
+    if (found == index.end()) return -1;
+    return insertBefore(std::next(found->second), nextId);
+}
+
+int LinkedListModel::insertAfter(int targetId, int value) {
+    if (targetId < 0) return insertBefore(nodes.begin(), value);
+    auto found = index.find(targetId);
+    if (found == index.end()) return -1;
+    return insertBefore(std::next(found->second), value);
+}
+
+int LinkedListModel::removeLast() {
+    if (nodes.empty()) return -1;
+    int id = nodes.back().id;
+    remove(id);
+    return id;
+}
+
+bool LinkedListModel::remove(int id) {
+    auto found = index.find(id);
+    if (found == index.end()) return false;
+    ListEvent e{ListEvent::Removed, id, found->second->value};
+    nodes.erase(found->second);
+    index.erase(found);
+    m_changes.notify(e);
+    return true;
+}
+
+void LinkedListModel::clear() {
+    nodes.clear();
+    index.clear();
+    nextId = 1;
+    m_changes.notify(ListEvent{ListEvent::Cleared});
+}
+
+void LinkedListModel::restore(const std::vector<ListNode>& sequence, int nextNodeId) {
+    clear();
+    index.reserve(sequence.size());
+    for (const ListNode& n : sequence) insertNode(nodes.end(), n.id, n.value);
+    nextId = nextNodeId;
+}
+
+void LinkedListModel::appendMany(const std::vector<int>& values) {
+    appendMany(values.data(), values.size());
+}
+
+void LinkedListModel::appendMany(const int* values, std::size_t count) {
+    index.reserve(index.size() + count);
+    for (std::size_t i = 0; i < count; ++i) insertBefore(nodes.end(), values[i]);
+}
+
+// 交换后 std::list 的迭代器仍然有效，指向各自新的所属，索引无需重建
+void LinkedListModel::adopt(LinkedListModel& staged) {
+    nodes.swap(staged.nodes);
+    index.swap(staged.index);
+    std::swap(nextId, staged.nextId);
+    m_changes.notify(ListEvent{ListEvent::Reset});
+}
+
+int LinkedListModel::apply(const std::vector<ListOperation>& ops) {
+    int applied = 0;
+    for (const ListOperation& op : ops) {
+        switch (op.type) {
+        case ListOperation::Append:      append(op.arg); ++applied; break;
+        case ListOperation::InsertAfter: applied += insertAfter(op.arg) >= 0; break;
+        case ListOperation::Remove:      applied += remove(op.arg); break;
+        case ListOperation::RemoveLast:  applied += removeLast() >= 0; break;
+        case ListOperation::Clear:       clear(); ++applied; break;
+        }
+    }
+    return applied;
+}
+
+int LinkedListModel::linkCount() const {
+    int edges = nodes.empty() ? 0 : size() - 1;
+    return m_kind == Doubly ? edges * 2 : edges;
+}
+
+// 以下一个编号在 pos 之前插入节点
+int LinkedListModel::insertBefore(std::list<ListNode>::iterator pos, int value) {
+    int id = nextId++;
+    insertNode(pos, id, value);
+    return id;
+}
+
+// 在 pos 之前插入节点，并登记索引、广播事件
+void LinkedListModel::insertNode(std::list<ListNode>::iterator pos, int id, int value) {
+    int prevId = pos == nodes.begin() ? -1 : std::prev(pos)->id;
+    index[id] = nodes.insert(pos, ListNode{id, value});
+    m_changes.notify(ListEvent{ListEvent::Inserted, id, value, prevId});
+}
@@ -0,0 +1,89 @@
+#ifndef LINKEDLISTMODEL_H
+#define LINKEDLISTMODEL_H
+
+#include "modelsignal.h"
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// 链表中的一个节点：id 是稳定的节点编号，value 是显示的值
+struct ListNode {
+    int id;
+    int value;
+};
+
+// 链表变更事件，视图据此增删图元
+struct ListEvent {
+    enum Type { Inserted, Removed, Cleared, Reset };   // Reset：节点序列被整体替换，订阅者按模型重建
+    Type type;
+    int  id = -1;       // 被插入/删除的节点编号
+    int  value = 0;     // 节点的值
+    int  prevId = -1;   // 插入时的前驱节点编号，-1 表示插在表头
+};
+
+// 批量操作中的一条操作，arg 为目标节点编号（InsertAfter/Remove）或节点的值（Append）
+struct ListOperation {
+    enum Type { Append, InsertAfter, Remove, RemoveLast, Clear };
+    Type type;
+    int  arg = 0;
+};
+
+// LinkedListModel 是不依赖 Qt 的链表模型，单链表和双向链表控件共用。
+// 节点按链表顺序存放在 std::list 中，并用编号索引定位，查找、插入、删除都是 O(1)。
+// 单/双向的区别只体现在指针（连线）的数量上。
+class LinkedListModel
+{
+public:
+    enum Kind { Singly, Doubly };
+    using const_iterator = std::list<ListNode>::const_iterator;
+
+    explicit LinkedListModel(Kind kind = Singly) : m_kind(kind) {}
+
+    Kind kind() const { return m_kind; }
+
+    int  append();                      // 以新编号为值在末尾添加节点，返回节点编号
+    int  append(int value);             // 在末尾添加指定值的节点，返回节点编号
+    int  insertAfter(int targetId);     // 在指定节点后插入新节点，目标不存在时返回 -1
+    int  insertAfter(int targetId, int value);  // 同上，指定节点的值；targetId 为 -1 时插在表头
+    int  removeLast();                  // 删除末尾节点，返回其编号，链表为空时返回 -1
+    bool remove(int id);                // 删除指定节点
+    void clear();                       // 清空链表并重置编号
+    // 整体恢复为给定的节点序列和下一个编号（回放时从检查点恢复）：先广播 Cleared，再逐个广播 Inserted
+    void restore(const std::vector<ListNode>& sequence, int nextNodeId);
+
+    // 批量接口：先把所有修改作用到模型上，视图在下一帧只做一次布局
+    void appendMany(const std::vector<int>& values);        // 依次在末尾添加这些值
+    void appendMany(const int* values, std::size_t count);  // 同上，用于导入时逐块追加
+
+    // 与 staged 交换全部节点和编号，只广播一次 Reset，O(1)。staged 是在工作线程中构建好的同种链表（不能有订阅者），
+    // 换出的原有节点留在 staged 中
+    void adopt(LinkedListModel& staged);
+    int  apply(const std::vector<ListOperation>& ops);      // 依次执行操作列表，返回成功执行的条数
+
+    bool contains(int id) const { return index.count(id) != 0; }
+    int  valueOf(int id) const { return index.at(id)->value; }
+    int  size() const { return static_cast<int>(nodes.size()); }
+    bool empty() const { return nodes.empty(); }
+    int  linkCount() const;             // 指针数量：单链表 n-1，双向链表 2(n-1)
+    int  nextNodeId() const { return nextId; }  // 下一个插入的节点将得到的编号
+
+    const_iterator begin() const { return nodes.begin(); }
+    const_iterator end() const { return nodes.end(); }
+    const ListNode& front() const { return nodes.front(); }
+    const ListNode& back() const { return nodes.back(); }
+
+    ModelSignal<ListEvent>& changes() { return m_changes; }
+
+private:
+    int insertBefore(std::list<ListNode>::iterator pos, int value);
+    void insertNode(std::list<ListNode>::iterator pos, int id, int value);
+
+    Kind m_kind;
+    std::list<ListNode> nodes;  // 按链表顺序存储节点
+    std::unordered_map<int, std::list<ListNode>::iterator> index;  // 节点编号 -> 链表位置
+    int nextId = 1;
+    ModelSignal<ListEvent> m_changes;
+};
+
+#endif
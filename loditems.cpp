@@ -0,0 +1,49 @@
+#include "loditems.h"
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+qreal Lod::levelOf(const QStyleOptionGraphicsItem* option, const QPainter* painter) {
+    return option->levelOfDetailFromTransform(painter->worldTransform());
+}
+
+AggregateBlockItem::AggregateBlockItem(QGraphicsItem* parent)
+    : QGraphicsItem(parent)
+{
+    setZValue(-1);  // 位于节点和连线之下
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);  // 需要 exposedRect 只画可见的色块
+}
+
+void AggregateBlockItem::setBlocks(QVector<QRectF> newBlocks) {
+    prepareGeometryChange();
+    blocks = std::move(newBlocks);
+    bounds = QRectF();
+    for (const QRectF& r : blocks) bounds |= r;
+}
+
+void AggregateBlockItem::resizeBlocks(int count) {
+    for (int i = count; i < blocks.size(); ++i) update(blocks[i]);
+    blocks.resize(count);
+}
+
+void AggregateBlockItem::setBlock(int index, const QRectF& rect) {
+    if (blocks[index] == rect) return;
+    update(blocks[index]);
+    blocks[index] = rect;
+    update(rect);
+}
+
+void AggregateBlockItem::setBounds(const QRectF& rect) {
+    if (rect == bounds) return;
+    prepareGeometryChange();
+    bounds = rect;
+}
+
+void AggregateBlockItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget*) {
+    if (Lod::levelOf(option, painter) >= Lod::Aggregate) return;  // 正常缩放下由单个图元绘制
+    painter->setRenderHint(QPainter::Antialiasing, false);
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(Qt::blue);
+    for (const QRectF& r : blocks) {
+        if (r.intersects(option->exposedRect)) painter->drawRect(r);
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef LODITEMS_H
+#define LODITEMS_H
+
+#include <QGraphicsItem>
+#include <QVector>
+#include <QRectF>
+
+class QPainter;
+class QStyleOptionGraphicsItem;
+
+// 细节层次（LOD）阈值：levelOfDetailFromTransform 低于这些值时逐步省略细节
+namespace Lod {
+constexpr qreal Label     = 0.5;    // 低于此值不画节点文字
+constexpr qreal Detail    = 0.25;   // 低于此值不画边框、箭头，连线不抗锯齿
+constexpr qreal Aggregate = 0.08;   // 低于此值单个图元不再绘制，由 AggregateBlockItem 画成色块
+
+// 当前绘制的缩放倍数
+qreal levelOf(const QStyleOptionGraphicsItem* option, const QPainter* painter);
+}
+
+// 聚合色块：极度缩小时代替一整段链表或一整层树节点，用少量矩形概括结构的轮廓
+class AggregateBlockItem : public QGraphicsItem
+{
+public:
+    explicit AggregateBlockItem(QGraphicsItem* parent = nullptr);
+
+    void setBlocks(QVector<QRectF> blocks);    // 整体替换色块（场景坐标），包围盒取所有色块的并集
+    // 增量更新：只改变化的色块，不必每次重建全部。包围盒由控件按布局范围给出
+    void resizeBlocks(int count);               // 截断或在末尾补上空色块
+    void setBlock(int index, const QRectF& rect);
+    void setBounds(const QRectF& rect);
+    int  blockCount() const { return blocks.size(); }
+
+    QRectF boundingRect() const override { return bounds; }
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override;
+
+private:
+    QVector<QRectF> blocks;
+    QRectF bounds;
+};
+
+#endif
@@ -2,11 +2,50 @@
 #include <QStackedWidget>
 #include <QMenuBar>
 #include <QMenu>
+#include <QStatusBar>
+#include <QLabel>
+#include <QTimer>
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QGraphicsScene>
+#include <QImage>
+#include <QMessageBox>
+#include <QPainter>
 #include "SinglyLinkedListWidget.h"
 #include "DoublyLinkedListWidget.h"
 #include "BinaryTreeWidget.h"
 #include "TreeTraversalWidget.h"
 #include "GraphWidget.h"
+#include "btreewidget.h"
+#include "heapwidget.h"
+#include "nodeitempool.h"
+#include "NodeItem.h"
+#include "nodespritecache.h"
+#include "edgelayeritem.h"
+#include "arrowitem.h"
+#include <functional>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace {
+// 堆上已分配的字节数（含 mmap 分配的大块），不支持的平台返回 -1
+long long heapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return static_cast<long long>(info.uordblks + info.hblkhd);
+#else
+    return -1;
+#endif
+}
+
+// 改为普通图元之前的箭头：同时继承 QObject，每个实例多一份 QObject 的私有数据
+class QObjectArrowItem : public QObject, public ArrowItem
+{
+public:
+    using ArrowItem::ArrowItem;
+};
+}
 
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent)
@@ -21,6 +60,8 @@ MainWindow::MainWindow(QWidget* parent)
     BinaryTreeWidget* binaryTree = new BinaryTreeWidget;              // 二叉树模块
     TreeTraversalWidget* treeTraversal = new TreeTraversalWidget;     // 树的遍历模块
     GraphWidget* graphWidget = new GraphWidget;                        // 图模块
+    BTreeWidget* bTree = new BTreeWidget;                              // B 树 / B+ 树模块
+    HeapWidget* heap = new HeapWidget;                                 // 堆（优先队列）模块
 
     // 将各模块添加到 stack 中
     stack->addWidget(singlyList);
@@ -28,6 +69,8 @@ MainWindow::MainWindow(QWidget* parent)
     stack->addWidget(binaryTree);
     stack->addWidget(treeTraversal);  // 新增
     stack->addWidget(graphWidget);
+    stack->addWidget(bTree);
+    stack->addWidget(heap);
 
     // 创建菜单栏
     QMenuBar* menuBar = new QMenuBar(this);
@@ -42,6 +85,8 @@ MainWindow::MainWindow(QWidget* parent)
     QMenu* treeMenu = menuBar->addMenu("树");
     QAction* binaryTreeAction = treeMenu->addAction("二叉树");
     QAction* traversalAction  = treeMenu->addAction("二叉树的遍历");  // 新增
+    QAction* bTreeAction      = treeMenu->addAction("B树 / B+树");
+    QAction* heapAction       = treeMenu->addAction("堆（优先队列）");
 
     // “图”菜单
     QAction* graphAction = menuBar->addAction("图");
@@ -52,8 +97,129 @@ MainWindow::MainWindow(QWidget* parent)
     connect(binaryTreeAction, &QAction::triggered, this, [stack]() { stack->setCurrentIndex(2); });
     connect(traversalAction,  &QAction::triggered, this, [stack]() { stack->setCurrentIndex(3); });  // 新增
     connect(graphAction,     &QAction::triggered, this, [stack]() { stack->setCurrentIndex(4); });
+    connect(bTreeAction,     &QAction::triggered, this, [stack]() { stack->setCurrentIndex(5); });
+    connect(heapAction,      &QAction::triggered, this, [stack]() { stack->setCurrentIndex(6); });
+
+    // “性能测试”菜单：与具体模块无关的绘制和内存测量
+    QMenu* benchMenu = menuBar->addMenu("性能测试");
+    connect(benchMenu->addAction("节点绘制"), &QAction::triggered, this, &MainWindow::onPaintBenchmark);
+    connect(benchMenu->addAction("连线内存"), &QAction::triggered, this, &MainWindow::onEdgeMemoryBenchmark);
+
+    // 状态栏定时显示节点图元池的计数，观察频繁增删时图元是否被复用；
+    // 单链表每次操作增删的图元数只与视口有关，不随链表长度增长
+    QLabel* poolLabel = new QLabel(this);
+    QLabel* churnLabel = new QLabel(this);
+    statusBar()->addPermanentWidget(poolLabel);
+    statusBar()->addPermanentWidget(churnLabel);
+    QTimer* statsTimer = new QTimer(this);
+    connect(statsTimer, &QTimer::timeout, this, [poolLabel, churnLabel, singlyList]() {
+        NodeItemPool::Stats s = NodeItemPool::totals();
+        poolLabel->setText(QString("节点图元：显示 %1，备用 %2，已分配 %3").arg(s.live).arg(s.pooled).arg(s.allocated));
+        churnLabel->setText(QString("单链表上次操作新建/销毁图元 %1").arg(singlyList->lastSceneItemChurn()));
+    });
+    statsTimer->start(500);
 
     // 默认显示单链表模块
     stack->setCurrentIndex(0);
     setWindowTitle("数据结构可视化实验平台");
 }
+
+// 5000 个节点铺满一个独立的场景，按 1 倍缩放整体绘制到图像上，相当于视图的一次整屏重绘。
+// 精灵缓存关闭和开启时各绘制若干帧；每轮先清空缓存，首帧单独计时，其中包含渲染所有精灵的开销
+void MainWindow::onPaintBenchmark() {
+    const int count = 5000, columns = 100, frames = 20;
+    QGraphicsScene scene;
+    for (int i = 0; i < count; ++i) {
+        auto* node = new NodeItem(i);   // 每个值各不相同，缓存中有 5000 张精灵
+        node->setPos((i % columns) * 42, (i / columns) * 42);
+        scene.addItem(node);
+    }
+    QRectF source = scene.itemsBoundingRect();
+    QImage image(source.size().toSize(), QImage::Format_ARGB32_Premultiplied);
+    auto repaint = [&]() {
+        image.fill(Qt::white);
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::Antialiasing);   // 与各模块的视图一致
+        scene.render(&painter, QRectF(image.rect()), source);
+    };
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+
+    NodeSpriteCache& cache = NodeSpriteCache::instance();
+    bool wasEnabled = cache.enabled();
+    QString report = QString("%1 个节点，%2×%3 像素，每轮重绘 %4 帧\n\n\t首帧（毫秒）\t每帧（毫秒）\t帧率\n")
+                         .arg(count).arg(image.width()).arg(image.height()).arg(frames);
+    QElapsedTimer clock;
+    for (bool cached : {false, true}) {
+        cache.setEnabled(cached);
+        cache.clear();
+        clock.start();
+        repaint();
+        qint64 firstNs = clock.nsecsElapsed();
+        clock.start();
+        for (int f = 0; f < frames; ++f) repaint();
+        double frameMs = clock.nsecsElapsed() / 1e6 / frames;
+        report += QString("%1\t%2\t%3\t%4\n").arg(cached ? "精灵缓存" : "直接绘制")
+                      .arg(firstNs / 1e6, 0, 'f', 1).arg(frameMs, 0, 'f', 2).arg(1000.0 / frameMs, 0, 'f', 1);
+    }
+    report += QString("\n精灵缓存命中 %1 次，渲染 %2 次").arg(cache.hits()).arg(cache.misses());
+    cache.setEnabled(wasEnabled);
+
+    QApplication::restoreOverrideCursor();
+    QMessageBox::information(this, "性能测试", report);
+}
+
+// 在独立的场景中分别用三种方式建出 N 个箭头，比较建之前和建之后（含场景索引）的堆占用。
+// 得到的是每个箭头实际分摊的字节数：边图层含数组的余量和包围盒，独立图元含图元对象、多边形数据和场景索引
+void MainWindow::onEdgeMemoryBenchmark() {
+    const int count = 100000;
+    if (heapInUse() < 0) {
+        QMessageBox::information(this, "性能测试", "当前平台无法读取堆分配统计，不能测量内存占用");
+        return;
+    }
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+
+    auto measure = [count](const std::function<void(QGraphicsScene&)>& build) {
+        long long before = heapInUse();
+        double perArrow;
+        {
+            QGraphicsScene scene;
+            build(scene);
+            scene.items(scene.itemsBoundingRect());     // 查询一次，让场景建好索引
+            perArrow = double(heapInUse() - before) / count;
+        }
+        return perArrow;
+    };
+    int slack = 0;
+    double layer = measure([&](QGraphicsScene& scene) {
+        auto* edges = new EdgeLayerItem;
+        scene.addItem(edges);
+        for (int i = 0; i < count; ++i) edges->addEdge(QPointF(i * 10, 0), QPointF(i * 10 + 8, 40));  // 带箭头
+        edges->boundingRect();
+        slack = edges->capacity() - edges->count();
+    });
+    // 第 i 个箭头的尖端在 (i*10+8, 40)，与边图层中第 i 条连线的终点重合
+    auto arrows = [count](QGraphicsScene& scene, auto make) {
+        for (int i = 0; i < count; ++i) {
+            QPolygonF head;
+            head << QPointF(i * 10 + 8, 40) << QPointF(i * 10 + 1, 36) << QPointF(i * 10 + 6, 31);
+            scene.addItem(make(head));
+        }
+    };
+    double plain = measure([&](QGraphicsScene& scene) {
+        arrows(scene, [](const QPolygonF& p) { return new ArrowItem(p); });
+    });
+    double withObject = measure([&](QGraphicsScene& scene) {
+        arrows(scene, [](const QPolygonF& p) { return new QObjectArrowItem(p); });
+    });
+
+    QString report = QString("%1 个箭头，按建成后的堆占用分摊，单位为字节\n\n").arg(count);
+    report += QString("边图层条目（连线与箭头共用）\t%1\n").arg(layer, 0, 'f', 1);
+    report += QString("    其中记录 %1 字节，数组余量 %2 条（每条分摊 %3 字节）\n")
+                  .arg(EdgeLayerItem::recordBytes).arg(slack)
+                  .arg(double(slack) * EdgeLayerItem::recordBytes / count, 0, 'f', 1);
+    report += QString("ArrowItem 图元\t%1\n").arg(plain, 0, 'f', 1);
+    report += QString("ArrowItem + QObject（改动前）\t%1\n").arg(withObject, 0, 'f', 1);
+
+    QApplication::restoreOverrideCursor();
+    QMessageBox::information(this, "性能测试", report);
+}
@@ -11,6 +11,10 @@ class MainWindow : public QMainWindow {
 
 public:
     explicit MainWindow(QWidget* parent = nullptr);
+
+private slots:
+    void onPaintBenchmark();    // 比较节点精灵缓存开启和关闭时整屏重绘的帧率
+    void onEdgeMemoryBenchmark();   // 测量边图层条目与独立箭头图元每个箭头实际占用的堆内存
 };
 
 #endif
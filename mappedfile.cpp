@@ -0,0 +1,83 @@
+#include "mappedfile.h"
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool MappedFile::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (f != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(f, &size) && size.QuadPart > 0) {
+            HANDLE m = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (m) {
+                if (void* view = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0)) {
+                    base = static_cast<const std::uint8_t*>(view);
+                    length = static_cast<std::size_t>(size.QuadPart);
+                    mapped = true;
+                    fileHandle = f;
+                    mappingHandle = m;
+                } else {
+                    CloseHandle(m);
+                }
+            }
+        }
+        if (!mapped) CloseHandle(f);
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* view = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view != MAP_FAILED) {
+                base = static_cast<const std::uint8_t*>(view);
+                length = static_cast<std::size_t>(st.st_size);
+                mapped = true;
+                madvise(view, length, MADV_SEQUENTIAL);   // 两处用途都是从头到尾顺序读
+            }
+        }
+        ::close(fd);
+    }
+#endif
+    if (!mapped) {
+        std::FILE* f = std::fopen(path.c_str(), "rb");
+        if (!f) return false;
+        std::uint8_t chunk[64 * 1024];
+        std::size_t got;
+        while ((got = std::fread(chunk, 1, sizeof chunk, f)) > 0) fallback.insert(fallback.end(), chunk, chunk + got);
+        std::fclose(f);
+        base = fallback.data();
+        length = fallback.size();
+    }
+    opened = true;
+    return true;
+}
+
+void MappedFile::close() {
+    if (mapped) {
+#ifdef _WIN32
+        UnmapViewOfFile(base);
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        mappingHandle = fileHandle = nullptr;
+#else
+        munmap(const_cast<std::uint8_t*>(base), length);
+#endif
+    }
+    mapped = false;
+    opened = false;
+    base = nullptr;
+    length = 0;
+    fallback.clear();
+    fallback.shrink_to_fit();
+}
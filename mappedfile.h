@@ -0,0 +1,39 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// MappedFile 把整个文件只读映射到内存（Windows 用 MapViewOfFile，其余平台用 mmap），
+// 映射失败（例如空文件或不支持的文件系统）时整体读入。映射时提示系统按顺序预读。
+// 操作日志的读取和大数据集的导入共用
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    bool open(const std::string& path);     // 文件无法打开时返回 false
+    void close();
+    bool isOpen() const { return opened; }
+
+    const std::uint8_t* data() const { return base; }
+    std::size_t size() const { return length; }
+
+private:
+    const std::uint8_t* base = nullptr;
+    std::size_t length = 0;
+    bool opened = false;
+    bool mapped = false;
+    std::vector<std::uint8_t> fallback;     // 无法映射时读入的文件内容
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef MODELSIGNAL_H
+#define MODELSIGNAL_H
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+// ModelSignal 是不依赖 Qt 的轻量观察者列表，数据结构模型通过它向视图广播变更事件。
+// 注意：不要在回调中订阅或取消订阅同一个 ModelSignal。
+template <typename Event>
+class ModelSignal
+{
+public:
+    using Listener = std::function<void(const Event&)>;
+
+    // 复制模型时不复制监听器：副本（例如交给工作线程的快照）独立于原模型，没有订阅者
+    ModelSignal() = default;
+    ModelSignal(const ModelSignal&) {}
+    ModelSignal& operator=(const ModelSignal&) { return *this; }
+
+    // 注册监听器，返回用于取消订阅的令牌
+    int subscribe(Listener listener) {
+        listeners.emplace_back(nextToken, std::move(listener));
+        return nextToken++;
+    }
+
+    // 根据令牌取消订阅
+    void unsubscribe(int token) {
+        for (auto it = listeners.begin(); it != listeners.end(); ++it) {
+            if (it->first == token) { listeners.erase(it); return; }
+        }
+    }
+
+    // 向所有监听器广播事件；没有监听器时开销只是一次判空
+    void notify(const Event& event) const {
+        for (const auto& l : listeners) l.second(event);
+    }
+
+    bool hasListeners() const { return !listeners.empty(); }
+
+private:
+    std::vector<std::pair<int, Listener>> listeners;
+    int nextToken = 1;
+};
+
+#endif
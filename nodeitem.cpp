@@ -1,13 +1,40 @@
 #include "NodeItem.h"
 #include <QPainter>
 #include <QStyleOptionGraphicsItem>
+#include "nodespritecache.h"
+#include "loditems.h"
+#include <memory>
+#include <vector>
+
+// 样式表只在 GUI 线程使用，配色种类很少（默认、高亮、红黑树的红与黑等），线性查找即可
+const NodeStyle* NodeStyle::of(const QColor& fill, const QColor& text) {
+    static std::vector<std::unique_ptr<NodeStyle>> styles;
+    for (const auto& s : styles)
+        if (s->fill.rgba() == fill.rgba() && s->text.rgba() == text.rgba()) return s.get();
+    styles.push_back(std::make_unique<NodeStyle>(NodeStyle{fill, text}));
+    return styles.back().get();
+}
+
+const NodeStyle* NodeStyle::normal() {
+    static const NodeStyle* style = of(Qt::blue, Qt::white);
+    return style;
+}
+
+const QFont& NodeStyle::font() {
+    return NodeSpriteCache::instance().font();
+}
+
+int NodeItem::s_instances = 0;
 
 NodeItem::NodeItem(int value, QGraphicsItem* parent)
     : QGraphicsObject(parent), m_value(value)
 {
-    // 初始化字体：设置字号为 14，并加粗
-    m_font.setPointSize(14);
-    m_font.setBold(true);
+    ++s_instances;
+}
+
+NodeItem::~NodeItem()
+{
+    --s_instances;
 }
 
 // 定义节点的边界矩形（节点大小为 40×40）
@@ -16,21 +43,30 @@ QRectF NodeItem::boundingRect() const
     return QRectF(0, 0, 40, 40);
 }
 
-// 绘制节点的图形表示
+// 绘制节点：圆形和文字预先渲染成精灵并按值、配色共享，这里只做一次位图绘制。
+// 缩小到看不清文字时改画纯色圆/方块，极度缩小时交给聚合色块绘制
 void NodeItem::paint(QPainter* painter,
-                     const QStyleOptionGraphicsItem* ,
+                     const QStyleOptionGraphicsItem* option,
                      QWidget* )
 {
     QRectF rect = boundingRect();
-
-    // 设置蓝色背景并绘制圆形
-    painter->setBrush(Qt::blue);  // 设置填充色为蓝色
-    painter->setPen(QPen(Qt::black, 2));  // 设置边框为黑色，宽度为 2
-    painter->drawEllipse(rect);  // 绘制圆形
-
-    // 设置字体为之前初始化的加粗字体
-    painter->setFont(m_font);
-    painter->setPen(Qt::white);  // 设置文字颜色为白色
-    // 绘制节点值，居中显示
-    painter->drawText(rect, Qt::AlignCenter, QString::number(m_value));
+    qreal lod = Lod::levelOf(option, painter);
+    if (lod < Lod::Aggregate) return;
+    if (lod < Lod::Label) {
+        painter->setRenderHint(QPainter::Antialiasing, false);
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(m_style->fill);
+        if (lod < Lod::Detail) painter->drawRect(rect);
+        else painter->drawEllipse(rect);
+        return;
+    }
+    NodeSpriteCache& cache = NodeSpriteCache::instance();
+    if (!cache.enabled()) {     // 对比测量时逐次排版文字、绘制抗锯齿圆形
+        cache.paintNode(painter, rect, m_value, m_style->fill, m_style->text);
+        return;
+    }
+    qreal scale = lod * painter->device()->devicePixelRatioF();
+    const QPixmap& pm = cache.sprite(m_value, m_style->fill, m_style->text, rect.width(), scale);
+    painter->setRenderHint(QPainter::SmoothPixmapTransform);
+    painter->drawPixmap(rect, pm, QRectF(pm.rect()));
 }
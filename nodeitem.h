@@ -2,13 +2,25 @@
 #define NODEITEM_H
 
 #include <QGraphicsObject>
-#include <QFont>
+#include <QColor>
 #include <QRectF>
 #include <QPointF>
 
 class QPainter;
 class QStyleOptionGraphicsItem;
 class QWidget;
+class QFont;
+
+// 节点的配色。相同配色的节点共用同一个样式对象，图元只保存一个指针；
+// 标签字体也只有一份，由精灵缓存持有
+struct NodeStyle {
+    QColor fill;
+    QColor text;
+
+    static const NodeStyle* of(const QColor& fill, const QColor& text);    // 取得共享的样式，首次出现时登记
+    static const NodeStyle* normal();   // 默认的蓝底白字
+    static const QFont& font();         // 所有节点共用的标签字体
+};
 
 // NodeItem 类，用于在图形视图框架中表示节点对象
 class NodeItem : public QGraphicsObject
@@ -18,6 +30,9 @@ class NodeItem : public QGraphicsObject
     Q_PROPERTY(QPointF pos READ pos WRITE setPos)            // 支持位置属性
 public:
     explicit NodeItem(int value, QGraphicsItem* parent = nullptr);
+    ~NodeItem() override;
+
+    static int instanceCount() { return s_instances; }  // 当前存在的 NodeItem 总数（含回收备用的）
 
     // 获取节点的边界矩形（用于绘制时确定区域）
     QRectF boundingRect() const override;
@@ -36,9 +51,23 @@ public:
         update();
     }
 
+    // 设置填充色和文字颜色（例如遍历高亮），不同配色各有一份缓存的精灵
+    void setColors(const QColor& fill, const QColor& text) {
+        setStyle(NodeStyle::of(fill, text));
+    }
+
+    void setStyle(const NodeStyle* style) {
+        if (style == m_style) return;
+        m_style = style;
+        update();
+    }
+    const NodeStyle* style() const { return m_style; }
+
 private:
-    int   m_value;  // 节点值
-    QFont m_font;   // 字体，控制节点值文本的显示样式
+    int m_value;                                    // 节点值
+    const NodeStyle* m_style = NodeStyle::normal(); // 共享的配色
+
+    static int s_instances;
 };
 
 #endif
@@ -0,0 +1,65 @@
+#include "nodeitempool.h"
+#include "NodeItem.h"
+#include "animationscheduler.h"
+
+#include <QGraphicsScene>
+
+int NodeItemPool::s_live = 0;
+int NodeItemPool::s_pooled = 0;
+
+NodeItemPool::NodeItemPool(QGraphicsScene* scene)
+    : scene(scene)
+{
+}
+
+// 图元由场景删除，这里只把本池的数量从合计中扣除
+NodeItemPool::~NodeItemPool() {
+    s_live -= m_live;
+    s_pooled -= pooled();
+}
+
+NodeItem* NodeItemPool::acquire(int value) {
+    NodeItem* item;
+    if (!spare.empty()) {
+        item = spare.back();
+        spare.pop_back();
+        --s_pooled;
+        item->setValue(value);
+        item->setStyle(NodeStyle::normal());
+        item->setOpacity(1.0);
+        item->setVisible(true);
+    } else {
+        item = new NodeItem(value);
+        scene->addItem(item);
+        ++m_created;
+    }
+    ++m_live;
+    ++s_live;
+    return item;
+}
+
+// 隐藏的图元不参与绘制和命中测试，留在场景索引中，再次取用时不必重新插入。
+// 例如淡入中途离开视口的图元，若不取消淡入，被重新取用后透明度仍会被旧补间逐帧改写
+void NodeItemPool::release(NodeItem* item) {
+    AnimationScheduler::instance().cancel(item);
+    item->setVisible(false);
+    spare.push_back(item);
+    --m_live;
+    --s_live;
+    ++s_pooled;
+}
+
+void NodeItemPool::reserve(int count) {
+    while (pooled() < count) {
+        auto* item = new NodeItem(0);
+        item->setVisible(false);
+        scene->addItem(item);
+        spare.push_back(item);
+        ++m_created;
+        ++s_pooled;
+    }
+}
+
+NodeItemPool::Stats NodeItemPool::totals() {
+    return Stats{s_live, s_pooled, NodeItem::instanceCount()};
+}
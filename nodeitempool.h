@@ -0,0 +1,48 @@
+#ifndef NODEITEMPOOL_H
+#define NODEITEMPOOL_H
+
+#include <vector>
+
+class QGraphicsScene;
+class NodeItem;
+
+// NodeItemPool 为一个场景回收复用 NodeItem：归还的图元隐藏后留在场景中，取用时优先复用，
+// 频繁插入、删除时省去 QObject 的构造析构、堆分配和场景索引的增删。
+// 图元始终归场景所有，随场景一起删除；归还时取消作用在它上面的补间动画，复用后不会被旧动画改写
+class NodeItemPool
+{
+public:
+    // 所有池合计的图元数量，用于观察回收效果
+    struct Stats {
+        int live;       // 已取出、正在显示的图元
+        int pooled;     // 回收备用的图元
+        int allocated;  // 当前存在的 NodeItem 总数（含淡出中、不经过池的图元）
+    };
+
+    explicit NodeItemPool(QGraphicsScene* scene);
+    NodeItemPool(const NodeItemPool&) = delete;
+    NodeItemPool& operator=(const NodeItemPool&) = delete;
+    ~NodeItemPool();
+
+    // 取出一个可见、不透明、默认配色的图元，位置由调用者设置
+    NodeItem* acquire(int value);
+    void release(NodeItem* item);   // 归还图元，取消它的补间动画，隐藏后放入备用列表
+    void reserve(int count);        // 预先创建备用图元，使备用数至少为 count
+
+    int live() const { return m_live; }
+    int pooled() const { return static_cast<int>(spare.size()); }
+    int created() const { return m_created; }  // 本池累计创建的图元数
+
+    static Stats totals();
+
+private:
+    QGraphicsScene* scene;
+    std::vector<NodeItem*> spare;
+    int m_live = 0;
+    int m_created = 0;
+
+    static int s_live;
+    static int s_pooled;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#include "nodespritecache.h"
+#include <QPainter>
+#include <cmath>
+
+NodeSpriteCache& NodeSpriteCache::instance() {
+    static NodeSpriteCache cache;
+    return cache;
+}
+
+NodeSpriteCache::NodeSpriteCache()
+    : cache(64 * 1024 * 1024)   // 最多约 64M 像素
+{
+    // 初始化字体：设置字号为 14，并加粗
+    m_font.setPointSize(14);
+    m_font.setBold(true);
+}
+
+const QPixmap& NodeSpriteCache::sprite(int value, const QColor& fill, const QColor& text,
+                                       qreal diameter, qreal scale) {
+    // 缩放倍数按 1/4 分档，避免连续缩放时不断生成新位图
+    int bucket = qBound(1, int(std::ceil(scale * 4)), 32);
+    NodeSpriteKey key{value, fill.rgba(), text.rgba(), bucket};
+    if (QPixmap* hit = cache.object(key)) {
+        ++m_hits;
+        return *hit;
+    }
+    ++m_misses;
+    QPixmap pm = render(key, diameter);
+    int cost = pm.width() * pm.height();
+    auto *stored = new QPixmap(std::move(pm));
+    cache.insert(key, stored, cost);
+    return *stored;
+}
+
+// 按原来的绘制方式渲染一次：蓝色圆形、黑色 2px 边框、居中的白色加粗数字
+QPixmap NodeSpriteCache::render(const NodeSpriteKey& key, qreal diameter) const {
+    qreal scale = key.scaleBucket / 4.0;
+    int side = int(std::ceil(diameter * scale));
+    QPixmap pm(side, side);
+    pm.fill(Qt::transparent);
+
+    QPainter p(&pm);
+    p.scale(scale, scale);
+    // 让 2px 边框完整落在位图内
+    paintNode(&p, QRectF(1, 1, diameter - 2, diameter - 2), key.value,
+              QColor::fromRgba(key.fill), QColor::fromRgba(key.text));
+    return pm;
+}
+
+void NodeSpriteCache::paintNode(QPainter* painter, const QRectF& rect, int value,
+                                const QColor& fill, const QColor& text) const {
+    painter->setRenderHint(QPainter::Antialiasing);
+    painter->setRenderHint(QPainter::TextAntialiasing);
+    painter->setBrush(fill);
+    painter->setPen(QPen(Qt::black, 2));
+    painter->drawEllipse(rect);
+    painter->setFont(m_font);
+    painter->setPen(text);
+    painter->drawText(rect, Qt::AlignCenter, QString::number(value));
+}
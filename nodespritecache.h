@@ -0,0 +1,63 @@
+#ifndef NODESPRITECACHE_H
+#define NODESPRITECACHE_H
+
+#include <QCache>
+#include <QColor>
+#include <QFont>
+#include <QPixmap>
+#include <QHashFunctions>
+#include <QRectF>
+
+class QPainter;
+
+// 精灵的缓存键：同一个值、配色和缩放档位的节点共用一张位图
+struct NodeSpriteKey {
+    int   value;
+    QRgb  fill;
+    QRgb  text;
+    int   scaleBucket;  // 设备像素比 × 缩放倍数，按 1/4 取整
+
+    bool operator==(const NodeSpriteKey& o) const {
+        return value == o.value && fill == o.fill && text == o.text && scaleBucket == o.scaleBucket;
+    }
+};
+
+inline size_t qHash(const NodeSpriteKey& k, size_t seed = 0) {
+    return qHashMulti(seed, k.value, k.fill, k.text, k.scaleBucket);
+}
+
+// NodeSpriteCache 缓存预先渲染好的节点精灵（圆形 + 文字）。
+// NodeItem::paint 只需要一次 drawPixmap，文字排版和抗锯齿椭圆只在第一次出现时渲染。
+class NodeSpriteCache
+{
+public:
+    static NodeSpriteCache& instance();
+
+    // 取得精灵位图，diameter 为节点的逻辑直径，scale 为设备像素比与视图缩放的乘积
+    const QPixmap& sprite(int value, const QColor& fill, const QColor& text, qreal diameter, qreal scale);
+
+    int  hits() const { return m_hits; }        // 命中次数，用于观察缓存效果
+    int  misses() const { return m_misses; }    // 未命中（实际渲染）次数
+    void clear() { cache.clear(); m_hits = m_misses = 0; }
+
+    // 关闭后 NodeItem 每次绘制都直接画圆形和文字，用于与缓存对比绘制耗时
+    void setEnabled(bool on) { m_enabled = on; }
+    bool enabled() const { return m_enabled; }
+
+    // 直接绘制一个节点：圆形、黑色 2px 边框、居中的加粗数字。渲染精灵和关闭缓存时都用它
+    void paintNode(QPainter* painter, const QRectF& rect, int value, const QColor& fill, const QColor& text) const;
+
+    const QFont& font() const { return m_font; }   // 所有节点共用的标签字体
+
+private:
+    NodeSpriteCache();
+    QPixmap render(const NodeSpriteKey& key, qreal diameter) const;
+
+    QCache<NodeSpriteKey, QPixmap> cache;   // 按像素数计费的 LRU 缓存
+    QFont m_font;
+    int m_hits = 0;
+    int m_misses = 0;
+    bool m_enabled = true;
+};
+
+#endif
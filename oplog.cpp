@@ -0,0 +1,371 @@
+#include "oplog.h"
+#include "binarytreemodel.h"
+#include "treetraversal.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+std::uint64_t zigzag(long long v) {
+    return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+}
+
+long long unzigzag(std::uint64_t v) {
+    return static_cast<long long>(v >> 1) ^ -static_cast<long long>(v & 1);
+}
+
+void putVarint(std::vector<std::uint8_t>& out, std::uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(v));
+}
+
+// 从 p[off] 读一个 varint，越过 end 或超过 10 字节时返回 false
+bool getVarint(const std::uint8_t* p, std::size_t end, std::size_t& off, std::uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64 && off < end; shift += 7) {
+        std::uint8_t byte = p[off++];
+        v |= std::uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// 各操作码的参数个数，0xff 表示未知的操作码
+int argCount(std::uint64_t code) {
+    switch (code) {
+    case OpRecord::Append:      return 1;
+    case OpRecord::InsertAfter: return 2;
+    case OpRecord::Remove:      return 1;
+    case OpRecord::Clear:       return 0;
+    case OpRecord::LoadTree:    return 1;
+    case OpRecord::Traverse:    return 1;
+    case OpRecord::Checkpoint:  return 1;   // 载荷长度
+    default:                    return 0xff;
+    }
+}
+
+} // namespace
+
+// ---------------- OpLogWriter ----------------
+
+bool OpLogWriter::open(const std::string& path, int listKind) {
+    close();
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    buffer.assign(OpLogFormat::Magic, OpLogFormat::Magic + 4);
+    buffer.push_back(OpLogFormat::Version);
+    buffer.push_back(static_cast<std::uint8_t>(listKind));
+    ops = 0;
+    return true;
+}
+
+void OpLogWriter::close() {
+    if (!file) return;
+    flush();
+    std::fclose(file);
+    file = nullptr;
+}
+
+void OpLogWriter::flush() {
+    if (!buffer.empty()) std::fwrite(buffer.data(), 1, buffer.size(), file);
+    buffer.clear();
+}
+
+void OpLogWriter::write(const OpRecord& rec) {
+    putVarint(buffer, rec.code);
+    switch (rec.code) {
+    case OpRecord::Append:
+        putVarint(buffer, zigzag(rec.a));
+        break;
+    case OpRecord::InsertAfter:
+        putVarint(buffer, zigzag(rec.a));
+        putVarint(buffer, zigzag(rec.b));
+        break;
+    case OpRecord::Remove:
+    case OpRecord::LoadTree:
+    case OpRecord::Traverse:
+        putVarint(buffer, static_cast<std::uint32_t>(rec.a));
+        break;
+    default:
+        break;
+    }
+    ++ops;
+    if (buffer.size() >= 64 * 1024) flush();
+}
+
+void OpLogWriter::writeCheckpoint(const LinkedListModel* list, int treeSize) {
+    payload.clear();
+    putVarint(payload, list ? static_cast<std::uint32_t>(list->nextNodeId()) : 1);
+    putVarint(payload, static_cast<std::uint32_t>(treeSize + 1));
+    putVarint(payload, list ? static_cast<std::uint32_t>(list->size()) : 0);
+    if (list) {
+        long long prevId = 0;
+        for (const ListNode& n : *list) {
+            putVarint(payload, zigzag(n.id - prevId));
+            putVarint(payload, zigzag(static_cast<long long>(n.value) - n.id));
+            prevId = n.id;
+        }
+    }
+    putVarint(buffer, OpRecord::Checkpoint);
+    putVarint(buffer, payload.size());
+    buffer.insert(buffer.end(), payload.begin(), payload.end());
+    if (buffer.size() >= 64 * 1024) flush();
+}
+
+// ---------------- OpLogReader ----------------
+
+bool OpLogReader::open(const std::string& path) {
+    close();
+    if (!file.open(path)) return false;
+    base = file.data();
+    length = file.size();
+    if (!scan()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void OpLogReader::close() {
+    file.close();
+    base = nullptr;
+    length = validEnd = 0;
+    kind = 0;
+    ops = 0;
+    marks.clear();
+}
+
+// 检查文件头，数出操作数并记下每个检查点的位置；遇到不完整或无法识别的记录就停在那里
+bool OpLogReader::scan() {
+    if (length < OpLogFormat::HeaderSize || std::memcmp(base, OpLogFormat::Magic, 4) != 0
+        || base[4] != OpLogFormat::Version) {
+        return false;
+    }
+    kind = base[5];
+    std::size_t off = OpLogFormat::HeaderSize;
+    validEnd = off;
+    while (off < length) {
+        std::uint64_t code, arg;
+        if (!getVarint(base, length, off, code)) break;
+        int args = argCount(code);
+        if (args == 0xff) break;
+        bool complete = true;
+        for (int k = 0; k < args && complete; ++k) complete = getVarint(base, length, off, arg);
+        if (!complete) break;
+        if (code == OpRecord::Checkpoint) {
+            if (arg > length - off) break;
+            marks.push_back(Mark{ops, off, off + static_cast<std::size_t>(arg)});
+            off += static_cast<std::size_t>(arg);
+        } else {
+            ++ops;
+        }
+        validEnd = off;
+    }
+    return true;
+}
+
+std::size_t OpLogReader::decode(std::size_t offset, OpRecord& rec) const {
+    std::uint64_t code, a = 0, b = 0;
+    getVarint(base, validEnd, offset, code);
+    rec.code = static_cast<OpRecord::Code>(code);
+    switch (rec.code) {
+    case OpRecord::Append:
+        getVarint(base, validEnd, offset, a);
+        rec.a = static_cast<int>(unzigzag(a));
+        break;
+    case OpRecord::InsertAfter:
+        getVarint(base, validEnd, offset, a);
+        getVarint(base, validEnd, offset, b);
+        rec.a = static_cast<int>(unzigzag(a));
+        rec.b = static_cast<int>(unzigzag(b));
+        break;
+    case OpRecord::Checkpoint:
+        getVarint(base, validEnd, offset, a);
+        offset += static_cast<std::size_t>(a);  // 顺序回放时跳过快照
+        break;
+    case OpRecord::Clear:
+        break;
+    default:
+        getVarint(base, validEnd, offset, a);
+        rec.a = static_cast<int>(a);
+        break;
+    }
+    return offset;
+}
+
+OpLogReader::Snapshot OpLogReader::snapshot(const Mark& mark) const {
+    Snapshot s;
+    std::size_t off = mark.payload;
+    std::uint64_t nextId, treeSize, count, v;
+    getVarint(base, mark.next, off, nextId);
+    getVarint(base, mark.next, off, treeSize);
+    getVarint(base, mark.next, off, count);
+    s.nextId = static_cast<int>(nextId);
+    s.treeSize = static_cast<int>(treeSize) - 1;
+    s.nodes.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(count, mark.next - off)));
+    long long prevId = 0;
+    for (std::uint64_t k = 0; k < count && off < mark.next; ++k) {
+        ListNode n;
+        getVarint(base, mark.next, off, v);
+        n.id = static_cast<int>(prevId + unzigzag(v));
+        getVarint(base, mark.next, off, v);
+        n.value = static_cast<int>(n.id + unzigzag(v));
+        prevId = n.id;
+        s.nodes.push_back(n);
+    }
+    return s;
+}
+
+// ---------------- OpLogRecorder ----------------
+
+OpLogRecorder::OpLogRecorder(LinkedListModel* list)
+    : list(list)
+{
+}
+
+bool OpLogRecorder::start(const std::string& path, int treeSize) {
+    stop();
+    if (!writer.open(path, list ? list->kind() : 0)) return false;
+    this->treeSize = treeSize;
+    writer.writeCheckpoint(list, treeSize);
+    sinceCheckpoint = 0;
+    if (list) token = list->changes().subscribe([this](const ListEvent& e) { onListChanged(e); });
+    return true;
+}
+
+void OpLogRecorder::stop() {
+    if (token) list->changes().unsubscribe(token);
+    token = 0;
+    writer.close();
+}
+
+void OpLogRecorder::treeLoaded(int nodeCount) {
+    if (!recording()) return;
+    treeSize = nodeCount;
+    record(OpRecord{OpRecord::LoadTree, nodeCount});
+}
+
+void OpLogRecorder::traversalStarted(int order) {
+    if (recording()) record(OpRecord{OpRecord::Traverse, order});
+}
+
+// 插入在末尾时记为 Append，回放时由模型按同样的顺序分配同样的编号
+void OpLogRecorder::onListChanged(const ListEvent& e) {
+    switch (e.type) {
+    case ListEvent::Inserted:
+        if (list->back().id == e.id) record(OpRecord{OpRecord::Append, e.value});
+        else record(OpRecord{OpRecord::InsertAfter, e.prevId, e.value});
+        break;
+    case ListEvent::Removed:
+        record(OpRecord{OpRecord::Remove, e.id});
+        break;
+    case ListEvent::Cleared:
+        record(OpRecord{OpRecord::Clear});
+        break;
+    case ListEvent::Reset:
+        // 整体替换记为清空加逐个追加：导入的链表是从空表顺序追加出来的，回放时得到同样的编号。
+        // 代价与链表长度成正比，界面中录制期间禁止导入，不会在界面线程里走到这里
+        record(OpRecord{OpRecord::Clear});
+        for (const ListNode& n : *list) record(OpRecord{OpRecord::Append, n.value});
+        break;
+    }
+}
+
+void OpLogRecorder::record(const OpRecord& rec) {
+    writer.write(rec);
+    long long interval = std::max<long long>(MinCheckpointInterval, list ? list->size() : 0);
+    if (++sinceCheckpoint >= interval) {
+        writer.writeCheckpoint(list, treeSize);
+        sinceCheckpoint = 0;
+    }
+}
+
+// ---------------- OpLogReplayer ----------------
+
+OpLogReplayer::OpLogReplayer(const OpLogReader& log, LinkedListModel* list)
+    : log(log), list(list), offset(log.begin())
+{
+}
+
+bool OpLogReplayer::step() {
+    while (offset < log.end()) {
+        OpRecord rec;
+        offset = log.decode(offset, rec);
+        if (rec.code == OpRecord::Checkpoint) continue;
+        apply(rec);
+        ++pos;
+        return true;
+    }
+    return false;
+}
+
+void OpLogReplayer::seek(long long index) {
+    index = std::max(0LL, std::min(index, log.opCount()));
+    const auto& marks = log.checkpoints();
+    auto after = std::upper_bound(marks.begin(), marks.end(), index,
+                                  [](long long i, const OpLogReader::Mark& m) { return i < m.opIndex; });
+    if (after == marks.begin()) {
+        // 没有可用的检查点：从空状态开始
+        if (list) list->clear();
+        offset = log.begin();
+        pos = 0;
+    } else {
+        const OpLogReader::Mark& mark = *std::prev(after);
+        OpLogReader::Snapshot s = log.snapshot(mark);
+        if (list) list->restore(s.nodes, s.nextId);
+        if (s.treeSize >= 0 && loadTree) loadTree(s.treeSize);
+        offset = mark.next;
+        pos = mark.opIndex;
+    }
+    while (pos < index && step()) {}
+}
+
+void OpLogReplayer::apply(const OpRecord& rec) {
+    switch (rec.code) {
+    case OpRecord::Append:
+        if (list) list->append(rec.a);
+        break;
+    case OpRecord::InsertAfter:
+        if (list) list->insertAfter(rec.a, rec.b);
+        break;
+    case OpRecord::Remove:
+        if (list) list->remove(rec.a);
+        break;
+    case OpRecord::Clear:
+        if (list) list->clear();
+        break;
+    case OpRecord::LoadTree:
+        if (loadTree) loadTree(rec.a);
+        break;
+    case OpRecord::Traverse:
+        if (traverse) traverse(rec.a);
+        break;
+    case OpRecord::Checkpoint:
+        break;
+    }
+}
+
+ReplayStats replayHeadless(const OpLogReader& log) {
+    ReplayStats stats;
+    LinkedListModel list(log.listKind() == LinkedListModel::Doubly ? LinkedListModel::Doubly : LinkedListModel::Singly);
+    BinaryTreeModel tree;
+    OpLogReplayer replayer(log, &list);
+    replayer.loadTree = [&](int n) {
+        tree.clear();
+        tree.appendLevelOrder(n);
+    };
+    replayer.traverse = [&](int order) {
+        auto cursor = makeTraversal(tree, static_cast<TraversalOrder>(order));
+        int id;
+        while (cursor->next(id)) ++stats.visits;
+    };
+    replayer.seek(0);
+    while (replayer.step()) {}
+    stats.ops = replayer.position();
+    stats.listSize = list.size();
+    stats.treeSize = tree.size();
+    return stats;
+}
@@ -0,0 +1,184 @@
+#ifndef OPLOG_H
+#define OPLOG_H
+
+#include "linkedlistmodel.h"
+#include "mappedfile.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+// 操作日志中的一条记录。链表操作按模型变更事件记录，回放时在同样的初始状态上产生同样的节点编号
+struct OpRecord {
+    enum Code : std::uint8_t {
+        Append = 1,     // a = 值
+        InsertAfter,    // a = 前驱节点编号（-1 表示表头），b = 值
+        Remove,         // a = 节点编号
+        Clear,
+        LoadTree,       // a = 完全二叉树的节点数
+        Traverse,       // a = 遍历顺序（TraversalOrder）
+        Checkpoint,     // 状态快照，不计入操作序号，回放跳转时从这里恢复
+    };
+    Code code;
+    int  a = 0;
+    int  b = 0;
+};
+
+// 日志文件格式：6 字节文件头（"DSVL"、版本、链表种类），随后是连续的记录。
+// 每条记录是 varint 编码的操作码和参数，有符号数先做 zigzag 变换，通常一条操作只占 2～4 字节。
+// 检查点记录为 操作码、载荷长度、载荷（下一个编号、树的节点数、链表节点序列），
+// 节点编号按与前一个的差、值按与编号的差编码，顺序追加的链表每个节点约 2 字节
+namespace OpLogFormat {
+constexpr char Magic[4] = {'D', 'S', 'V', 'L'};
+constexpr std::uint8_t Version = 1;
+constexpr std::size_t HeaderSize = 6;
+}
+
+// OpLogWriter 把记录编码后缓冲写入文件
+class OpLogWriter
+{
+public:
+    OpLogWriter() = default;
+    OpLogWriter(const OpLogWriter&) = delete;
+    OpLogWriter& operator=(const OpLogWriter&) = delete;
+    ~OpLogWriter() { close(); }
+
+    bool open(const std::string& path, int listKind);   // 创建文件并写入文件头
+    void close();
+    bool isOpen() const { return file != nullptr; }
+
+    void write(const OpRecord& rec);
+    // 写入当前状态的快照：链表节点序列（list 可为空）和树的节点数（没有树时为 -1）
+    void writeCheckpoint(const LinkedListModel* list, int treeSize);
+    long long opCount() const { return ops; }
+
+private:
+    void flush();
+
+    std::FILE* file = nullptr;
+    std::vector<std::uint8_t> buffer;
+    std::vector<std::uint8_t> payload;  // 检查点载荷，先编码再写长度
+    long long ops = 0;
+};
+
+// OpLogReader 把日志文件映射到内存（不支持时整体读入），打开时扫描一遍得到操作数和检查点位置。
+// 文件末尾不完整的记录（例如录制中途崩溃）被忽略
+class OpLogReader
+{
+public:
+    // 检查点：恢复后从 next 开始执行第 opIndex 条操作
+    struct Mark {
+        long long   opIndex;
+        std::size_t payload;
+        std::size_t next;
+    };
+
+    // 检查点载荷解码后的状态
+    struct Snapshot {
+        std::vector<ListNode> nodes;
+        int nextId = 1;
+        int treeSize = -1;
+    };
+
+    OpLogReader() = default;
+    OpLogReader(const OpLogReader&) = delete;
+    OpLogReader& operator=(const OpLogReader&) = delete;
+    ~OpLogReader() { close(); }
+
+    bool open(const std::string& path);     // 格式不对时返回 false
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    int  listKind() const { return kind; }
+    long long opCount() const { return ops; }
+    const std::vector<Mark>& checkpoints() const { return marks; }
+
+    // 解码 offset 处的一条记录，返回下一条记录的偏移；检查点记录只返回操作码，载荷整体跳过
+    std::size_t decode(std::size_t offset, OpRecord& rec) const;
+    Snapshot snapshot(const Mark& mark) const;
+    std::size_t begin() const { return OpLogFormat::HeaderSize; }
+    std::size_t end() const { return validEnd; }
+
+private:
+    bool scan();
+
+    MappedFile file;
+    const std::uint8_t* base = nullptr;
+    std::size_t length = 0;
+    std::size_t validEnd = 0;
+    int kind = 0;
+    long long ops = 0;
+    std::vector<Mark> marks;
+};
+
+// OpLogRecorder 订阅链表模型的变更事件写入日志，树的载入和遍历由控件调用对应接口记录。
+// 开始录制时先写一个检查点保存已有状态；之后每隔 max(4096, 链表长度) 条操作再写一个，
+// 快照的总开销与操作数成正比，回放跳转时最多重放一个间隔
+class OpLogRecorder
+{
+public:
+    explicit OpLogRecorder(LinkedListModel* list);  // list 可为空（只记录树的操作）
+    ~OpLogRecorder() { stop(); }
+
+    bool start(const std::string& path, int treeSize = -1);
+    void stop();
+    bool recording() const { return writer.isOpen(); }
+    long long opCount() const { return writer.opCount(); }
+
+    void treeLoaded(int nodeCount);
+    void traversalStarted(int order);
+
+    static constexpr long long MinCheckpointInterval = 4096;
+
+private:
+    void onListChanged(const ListEvent& e);
+    void record(const OpRecord& rec);
+
+    LinkedListModel* list;
+    OpLogWriter writer;
+    int token = 0;
+    int treeSize = -1;
+    long long sinceCheckpoint = 0;
+};
+
+// OpLogReplayer 在模型上逐条执行日志中的操作。树的操作交给回调：
+// 界面中载入树并播放遍历动画，无界面回放时直接跑完遍历
+class OpLogReplayer
+{
+public:
+    OpLogReplayer(const OpLogReader& log, LinkedListModel* list);
+
+    std::function<void(int nodeCount)> loadTree;
+    std::function<void(int order)> traverse;
+
+    long long position() const { return pos; }     // 已执行的操作数
+    long long size() const { return log.opCount(); }
+    bool atEnd() const { return pos >= log.opCount(); }
+
+    bool step();    // 执行下一条操作，已到末尾时返回 false
+    // 跳到第 index 条操作之前的状态：从不晚于它的最近检查点恢复，再执行剩下的操作
+    void seek(long long index);
+
+private:
+    void apply(const OpRecord& rec);
+
+    const OpLogReader& log;
+    LinkedListModel* list;
+    std::size_t offset;
+    long long pos = 0;
+};
+
+// 无界面回放的统计
+struct ReplayStats {
+    long long ops = 0;
+    long long visits = 0;   // 遍历访问的节点总数
+    int listSize = 0;
+    int treeSize = 0;
+};
+
+// 在不带任何监听器的模型上全速回放整个日志，用于可重复的性能测量
+ReplayStats replayHeadless(const OpLogReader& log);
+
+#endif
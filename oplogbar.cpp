@@ -0,0 +1,179 @@
+#include "oplogbar.h"
+#include "animationscheduler.h"
+
+#include <QHBoxLayout>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QLabel>
+#include <QFile>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QApplication>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <climits>
+
+namespace {
+std::string localPath(const QString& path) {
+    return QFile::encodeName(path).toStdString();
+}
+}
+
+OpLogBar::OpLogBar(LinkedListModel* list, QWidget* parent)
+    : QWidget(parent), list(list), rec(list), channel(AnimationScheduler::instance().newChannel())
+{
+    auto* lay = new QHBoxLayout(this);
+    lay->setContentsMargins(0, 0, 0, 0);
+    recordButton   = new QPushButton("录制", this);
+    replayButton   = new QPushButton("回放日志", this);
+    pauseButton    = new QPushButton("暂停", this);
+    seekSpin       = new QSpinBox(this);
+    seekSpin->setPrefix("第 ");
+    seekSpin->setSuffix(" 步");
+    seekButton     = new QPushButton("跳转", this);
+    headlessButton = new QPushButton("无界面回放", this);
+    statusLabel    = new QLabel(this);
+    pauseButton->setEnabled(false);
+    seekSpin->setEnabled(false);
+    seekButton->setEnabled(false);
+    lay->addWidget(recordButton);
+    lay->addWidget(replayButton);
+    lay->addWidget(pauseButton);
+    lay->addWidget(seekSpin);
+    lay->addWidget(seekButton);
+    lay->addWidget(headlessButton);
+    lay->addWidget(statusLabel, 1);
+
+    connect(recordButton,   &QPushButton::clicked, this, &OpLogBar::onRecord);
+    connect(replayButton,   &QPushButton::clicked, this, &OpLogBar::onReplay);
+    connect(pauseButton,    &QPushButton::clicked, this, &OpLogBar::onPause);
+    connect(seekButton,     &QPushButton::clicked, this, &OpLogBar::onSeek);
+    connect(headlessButton, &QPushButton::clicked, this, &OpLogBar::onHeadless);
+}
+
+OpLogBar::~OpLogBar() {
+    AnimationScheduler::instance().cancel(channel);
+}
+
+void OpLogBar::stop() {
+    bool wasRecording = rec.recording();
+    rec.stop();
+    stopReplay();
+    if (wasRecording) emit recordingChanged(false);
+}
+
+void OpLogBar::onRecord() {
+    if (rec.recording()) {
+        rec.stop();
+        recordButton->setText("录制");
+        statusLabel->setText(QString("已录制 %1 步").arg(rec.opCount()));
+        emit recordingChanged(false);
+        return;
+    }
+    QString path = QFileDialog::getSaveFileName(this, "保存操作日志", QString(), "操作日志 (*.dsvlog)");
+    if (path.isEmpty()) return;
+    stopReplay();   // 回放产生的变更不能被录进新日志
+    int treeSize = tree.treeSize ? tree.treeSize() : -1;
+    if (!rec.start(localPath(path), treeSize)) {
+        QMessageBox::warning(this, "错误", "无法创建日志文件！");
+        return;
+    }
+    recordButton->setText("停止录制");
+    statusLabel->setText("录制中");
+    emit recordingChanged(true);
+}
+
+void OpLogBar::onReplay() {
+    QString path = QFileDialog::getOpenFileName(this, "回放操作日志", QString(), "操作日志 (*.dsvlog)");
+    if (path.isEmpty()) return;
+    if (rec.recording()) onRecord();
+    stopReplay();
+    if (!reader.open(localPath(path))) {
+        QMessageBox::warning(this, "错误", "无法读取操作日志！");
+        return;
+    }
+    replayer = std::make_unique<OpLogReplayer>(reader, list);
+    replayer->loadTree = tree.loadTree;
+    replayer->traverse = tree.traverse;
+    seekSpin->setRange(0, static_cast<int>(std::min<long long>(reader.opCount(), INT_MAX)));
+    seekSpin->setEnabled(true);
+    seekButton->setEnabled(true);
+    pauseButton->setEnabled(true);
+    replayer->seek(0);  // 恢复录制开始时的状态
+    play();
+}
+
+void OpLogBar::onPause() {
+    if (!replayer) return;
+    if (playing) pause();
+    else play();
+}
+
+// 跳转时先暂停：从最近的检查点恢复模型，再执行到目标步
+void OpLogBar::onSeek() {
+    if (!replayer) return;
+    pause();
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    replayer->seek(seekSpin->value());
+    QApplication::restoreOverrideCursor();
+    updateStatus();
+}
+
+void OpLogBar::onHeadless() {
+    QString path = QFileDialog::getOpenFileName(this, "无界面回放操作日志", QString(), "操作日志 (*.dsvlog)");
+    if (path.isEmpty()) return;
+    OpLogReader log;
+    if (!log.open(localPath(path))) {
+        QMessageBox::warning(this, "错误", "无法读取操作日志！");
+        return;
+    }
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    QElapsedTimer clock;
+    clock.start();
+    ReplayStats s = replayHeadless(log);
+    qint64 ms = std::max<qint64>(1, clock.elapsed());
+    QApplication::restoreOverrideCursor();
+    QMessageBox::information(this, "无界面回放",
+        QString("%1 步操作，用时 %2 ms（%3 万步/秒）\n遍历访问 %4 个节点\n结束时链表 %5 个节点，树 %6 个节点")
+            .arg(s.ops).arg(ms).arg(s.ops / 10.0 / ms, 0, 'f', 1)
+            .arg(s.visits).arg(s.listSize).arg(s.treeSize));
+}
+
+void OpLogBar::play() {
+    if (!replayer || replayer->atEnd()) return;
+    playing = true;
+    pauseButton->setText("暂停");
+    AnimationScheduler::instance().every(channel, StepMs, [this]() {
+        bool more = replayer->step();
+        updateStatus();
+        if (!more || replayer->atEnd()) {
+            playing = false;
+            pauseButton->setText("继续");
+            return false;
+        }
+        return true;
+    });
+    updateStatus();
+}
+
+void OpLogBar::pause() {
+    AnimationScheduler::instance().cancel(channel);
+    playing = false;
+    pauseButton->setText("继续");
+}
+
+void OpLogBar::stopReplay() {
+    AnimationScheduler::instance().cancel(channel);
+    playing = false;
+    replayer.reset();
+    reader.close();
+    pauseButton->setText("暂停");
+    pauseButton->setEnabled(false);
+    seekSpin->setEnabled(false);
+    seekButton->setEnabled(false);
+}
+
+void OpLogBar::updateStatus() {
+    if (!replayer) return;
+    statusLabel->setText(QString("回放 %1 / %2 步").arg(replayer->position()).arg(replayer->size()));
+}
@@ -0,0 +1,69 @@
+#ifndef OPLOGBAR_H
+#define OPLOGBAR_H
+
+#include <QWidget>
+#include <functional>
+#include <memory>
+#include "oplog.h"
+
+class QPushButton;
+class QSpinBox;
+class QLabel;
+
+// OpLogBar 是录制/回放操作日志的一排控件，链表和树的遍历控件共用。
+// 录制时模型的每次变更写入二进制日志；回放时按动画速度逐条执行，可以暂停、跳到任意一步；
+// “无界面回放”在独立的模型上全速执行整个日志并报告吞吐量
+class OpLogBar : public QWidget
+{
+    Q_OBJECT
+public:
+    // 树的操作由所在控件处理：载入树、开始遍历、查询当前树的节点数
+    struct TreeHandlers {
+        std::function<void(int nodeCount)> loadTree;
+        std::function<void(int order)> traverse;
+        std::function<int()> treeSize;
+    };
+
+    explicit OpLogBar(LinkedListModel* list, QWidget* parent = nullptr);  // list 可为空
+    ~OpLogBar() override;
+
+    void setTreeHandlers(TreeHandlers handlers) { tree = std::move(handlers); }
+    OpLogRecorder& recorder() { return rec; }   // 控件通过它记录树的操作
+    void stop();    // 停止录制和回放；模型销毁前调用
+
+signals:
+    void recordingChanged(bool recording);  // 开始或停止录制
+
+private slots:
+    void onRecord();
+    void onReplay();
+    void onPause();
+    void onSeek();
+    void onHeadless();
+
+private:
+    static constexpr int StepMs = 400;     // 回放时每条操作的间隔
+
+    LinkedListModel* list;
+    TreeHandlers tree;
+    OpLogRecorder rec;
+    OpLogReader reader;
+    std::unique_ptr<OpLogReplayer> replayer;
+    bool playing = false;
+    int channel;    // 回放步骤在调度器中的通道
+
+    QPushButton* recordButton;
+    QPushButton* replayButton;
+    QPushButton* pauseButton;
+    QSpinBox*    seekSpin;
+    QPushButton* seekButton;
+    QPushButton* headlessButton;
+    QLabel*      statusLabel;
+
+    void play();
+    void pause();
+    void stopReplay();
+    void updateStatus();
+};
+
+#endif
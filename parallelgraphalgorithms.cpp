@@ -0,0 +1,239 @@
+#include "parallelgraphalgorithms.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace {
+
+constexpr int TopDownGrain = 64;        // 自顶向下时每个任务处理的边界顶点数
+constexpr int BottomUpGrain = 2048;     // 自底向上时每个任务扫描的顶点数
+constexpr int RelaxGrain = 256;         // delta-stepping 每个任务松弛的顶点数
+constexpr double Alpha = 14;            // 切换到自底向上的阈值
+constexpr double Beta = 24;             // 切换回自顶向下的阈值
+
+GraphSearch makeResult(const GraphModel& graph) {
+    int n = graph.vertexCount();
+    GraphSearch r;
+    r.parent.assign(n, -1);
+    r.parentEdge.assign(n, -1);
+    r.dist.assign(n, GraphSearch::unreachable);
+    return r;
+}
+
+// delta-stepping 中的一次松弛请求
+struct Relaxation {
+    int    to;
+    int    from;
+    int    edge;
+    double dist;
+};
+
+} // namespace
+
+GraphSearch parallelBreadthFirstSearch(const GraphModel& graph, int source, WorkStealingPool& pool,
+                                       const GraphStepSink& sink) {
+    GraphSearch r = makeResult(graph);
+    if (!graph.isValid(source)) return r;
+    const int n = graph.vertexCount();
+
+    // parent 用原子变量抢占：自顶向下时多个边界顶点可能同时发现同一个顶点，只有一个能写入
+    std::vector<std::atomic<int>> parent(n);
+    for (auto& p : parent) p.store(-1, std::memory_order_relaxed);
+    parent[source].store(source, std::memory_order_relaxed);
+    std::vector<char> inFrontier(n, 0);
+    std::vector<std::vector<int>> found(pool.concurrency());
+
+    long long unexplored = 0;   // 尚未检查的弧数（按 arcSlots 估计）
+    for (int v = 0; v < n; ++v) unexplored += graph.arcSlots(v);
+
+    std::vector<int> frontier{source};
+    r.dist[source] = 0;
+    r.order.push_back(source);
+    if (sink) sink(GraphStep{GraphStep::Discover, source});
+    bool bottomUp = false;
+    for (int level = 0; !frontier.empty(); ++level) {
+        long long frontierArcs = 0;
+        for (int v : frontier) frontierArcs += graph.arcSlots(v);
+        if (!graph.directed()) {
+            if (!bottomUp && frontierArcs > unexplored / Alpha) bottomUp = true;
+            else if (bottomUp && frontier.size() < n / Beta) bottomUp = false;
+        }
+        unexplored -= frontierArcs;
+
+        if (sink) {
+            GraphStep phase{GraphStep::Phase, level};
+            phase.dist = level;
+            phase.frontier = static_cast<int>(frontier.size());
+            phase.bottomUp = bottomUp;
+            sink(phase);
+            for (int v : frontier) sink(GraphStep{GraphStep::Visit, v, r.parent[v], r.parentEdge[v], r.dist[v]});
+        }
+
+        for (auto& f : found) f.clear();
+        if (!bottomUp) {
+            pool.parallelFor(0, static_cast<int>(frontier.size()), TopDownGrain, [&](int begin, int end, int worker) {
+                for (int i = begin; i < end; ++i) {
+                    int v = frontier[i];
+                    graph.forEachArc(v, [&](const GraphEdge& a) {
+                        int expected = -1;
+                        if (parent[a.to].load(std::memory_order_relaxed) != -1) return;
+                        if (!parent[a.to].compare_exchange_strong(expected, v)) return;
+                        r.parentEdge[a.to] = a.id;
+                        found[worker].push_back(a.to);
+                    });
+                }
+            });
+        } else {
+            for (int v : frontier) inFrontier[v] = 1;
+            pool.parallelFor(0, n, BottomUpGrain, [&](int begin, int end, int worker) {
+                for (int u = begin; u < end; ++u) {
+                    if (parent[u].load(std::memory_order_relaxed) != -1) continue;
+                    int slots = graph.arcSlots(u);
+                    for (int s = 0; s < slots; ++s) {
+                        const GraphEdge* a = graph.arcAt(u, s);
+                        if (!a || !inFrontier[a->to]) continue;
+                        parent[u].store(a->to, std::memory_order_relaxed);  // 只有负责 u 的线程写 u
+                        r.parentEdge[u] = a->id;
+                        found[worker].push_back(u);
+                        break;
+                    }
+                }
+            });
+            for (int v : frontier) inFrontier[v] = 0;
+        }
+
+        // 合并各线程发现的顶点作为下一层边界
+        frontier.clear();
+        for (const auto& f : found) frontier.insert(frontier.end(), f.begin(), f.end());
+        for (int v : frontier) {
+            int p = parent[v].load(std::memory_order_relaxed);
+            r.parent[v] = p;
+            r.dist[v] = level + 1;
+            r.order.push_back(v);
+            if (sink) sink(GraphStep{GraphStep::Discover, v, p, r.parentEdge[v], r.dist[v]});
+        }
+    }
+    return r;
+}
+
+GraphSearch deltaStepping(const GraphModel& graph, int source, WorkStealingPool& pool,
+                          double delta, const GraphStepSink& sink) {
+    GraphSearch r = makeResult(graph);
+    if (!graph.isValid(source)) return r;
+    const int n = graph.vertexCount();
+
+    if (delta <= 0) {
+        double sum = 0;
+        long long count = 0;
+        for (int v = 0; v < n; ++v) {
+            graph.forEachArc(v, [&](const GraphEdge& a) {
+                if (a.weight > 0) { sum += a.weight; ++count; }
+            });
+        }
+        delta = count ? sum / count : 1.0;
+    }
+
+    std::vector<std::vector<int>> buckets;
+    std::vector<int> bucketOf(n, -1);   // 顶点当前所在的桶，桶中其他位置的旧记录视为过期
+    auto enqueue = [&](int v) {
+        int b = static_cast<int>(r.dist[v] / delta);
+        if (bucketOf[v] == b) return;
+        bucketOf[v] = b;
+        if (b >= static_cast<int>(buckets.size())) buckets.resize(b + 1);
+        buckets[b].push_back(v);
+    };
+
+    // 并行生成松弛请求，再在提交线程上合并
+    std::vector<std::vector<Relaxation>> requests(pool.concurrency());
+    auto relax = [&](const std::vector<int>& vertices, bool light) {
+        for (auto& q : requests) q.clear();
+        pool.parallelFor(0, static_cast<int>(vertices.size()), RelaxGrain, [&](int begin, int end, int worker) {
+            for (int i = begin; i < end; ++i) {
+                int v = vertices[i];
+                double d = r.dist[v];
+                graph.forEachArc(v, [&](const GraphEdge& a) {
+                    if (a.weight < 0 || (a.weight <= delta) != light) return;
+                    double nd = d + a.weight;
+                    if (nd < r.dist[a.to]) requests[worker].push_back(Relaxation{a.to, v, a.id, nd});
+                });
+            }
+        });
+        for (const auto& q : requests) {
+            for (const Relaxation& q1 : q) {
+                if (!(q1.dist < r.dist[q1.to])) continue;
+                bool first = r.dist[q1.to] == GraphSearch::unreachable;
+                r.dist[q1.to] = q1.dist;
+                r.parent[q1.to] = q1.from;
+                r.parentEdge[q1.to] = q1.edge;
+                enqueue(q1.to);
+                if (sink) sink(GraphStep{first ? GraphStep::Discover : GraphStep::Relax, q1.to, q1.from, q1.edge, q1.dist});
+            }
+        }
+    };
+
+    r.dist[source] = 0;
+    enqueue(source);
+    if (sink) sink(GraphStep{GraphStep::Discover, source});
+
+    std::vector<char> inSettled(n, 0);
+    std::vector<int> current, settled;
+    for (int i = 0; i < static_cast<int>(buckets.size()); ++i) {
+        if (buckets[i].empty()) continue;
+        if (sink) {
+            GraphStep phase{GraphStep::Phase, i};
+            phase.dist = i * delta;
+            phase.frontier = static_cast<int>(buckets[i].size());
+            sink(phase);
+        }
+        // 桶内反复松弛轻边；被改进的顶点可能重新落入本桶
+        settled.clear();
+        while (!buckets[i].empty()) {
+            current.clear();
+            current.swap(buckets[i]);
+            current.erase(std::remove_if(current.begin(), current.end(),
+                                         [&](int v) { return bucketOf[v] != i; }), current.end());
+            for (int v : current) {
+                bucketOf[v] = -1;
+                if (!inSettled[v]) {
+                    inSettled[v] = 1;
+                    settled.push_back(v);
+                }
+            }
+            relax(current, true);
+        }
+        // 本桶的距离已确定，松弛重边（结果只会落入更靠后的桶）
+        relax(settled, false);
+        for (int v : settled) {
+            r.order.push_back(v);
+            if (sink) sink(GraphStep{GraphStep::Visit, v, r.parent[v], r.parentEdge[v], r.dist[v]});
+        }
+    }
+    return r;
+}
+
+int countMismatches(const GraphModel& graph, const GraphSearch& parallel, const GraphSearch& sequential,
+                    bool weighted) {
+    int n = graph.vertexCount();
+    if (static_cast<int>(parallel.dist.size()) != n || static_cast<int>(sequential.dist.size()) != n) return n;
+    auto close = [](double a, double b) {
+        if (a == b) return true;    // 包括两者都不可达
+        return std::abs(a - b) <= 1e-9 * std::max(1.0, std::abs(b));
+    };
+    int mismatches = 0;
+    for (int v = 0; v < n; ++v) {
+        if (!close(parallel.dist[v], sequential.dist[v])) {
+            ++mismatches;
+            continue;
+        }
+        int p = parallel.parent[v];
+        if (p < 0) continue;
+        // 搜索树边必须存在，且父顶点距离加边权等于本顶点距离
+        bool ok = false;
+        graph.forEachArc(p, [&](const GraphEdge& a) {
+            if (a.to == v && a.id == parallel.parentEdge[v])
+                ok = ok || close(parallel.dist[p] + (weighted ? a.weight : 1.0), parallel.dist[v]);
+        });
+        if (!ok) ++mismatches;
+    }
+    return mismatches;
+}
@@ -0,0 +1,30 @@
+#ifndef PARALLELGRAPHALGORITHMS_H
+#define PARALLELGRAPHALGORITHMS_H
+
+#include "graphalgorithms.h"
+#include "workstealingpool.h"
+
+// 并行图算法，在工作窃取线程池上运行，结果与 GraphAlgorithms 中的顺序版本格式相同。
+// 步骤事件只在提交线程上、每个阶段结束后按顺序发出：先发 Phase（阶段编号和边界大小），
+// 再发本阶段的 Visit/Discover/Relax，视图可以和顺序算法用同一套动画回放。
+// 同一层（同一个桶）内顶点的先后顺序取决于线程调度，每次运行可能不同。
+
+// 方向优化的层同步 BFS：边界较小时自顶向下扩展（边界顶点检查出弧），
+// 边界的出弧数超过未探索弧数的 1/14 时改为自底向上（未访问顶点检查是否有邻居在边界中，找到一个即停止），
+// 边界缩小到顶点数的 1/24 以下时切回自顶向下。有向图没有入弧索引，始终自顶向下
+GraphSearch parallelBreadthFirstSearch(const GraphModel& graph, int source, WorkStealingPool& pool,
+                                       const GraphStepSink& sink = nullptr);
+
+// delta-stepping 单源最短路径：距离按宽度 delta 分桶，依次处理最小的非空桶，
+// 桶内反复并行松弛轻边（权值不超过 delta）直到桶空，再一次性松弛重边。
+// 松弛请求先在各线程的缓冲区中并行生成，再在提交线程上合并，距离数组在并行阶段只读。
+// delta <= 0 时取正权值的平均值；权值为负的弧被忽略
+GraphSearch deltaStepping(const GraphModel& graph, int source, WorkStealingPool& pool,
+                          double delta = 0, const GraphStepSink& sink = nullptr);
+
+// 把并行结果与顺序结果对照，返回不一致的顶点数：可达性或距离不同，
+// 或者搜索树边与距离不符（父顶点距离加边权不等于本顶点距离）。weighted 为 false 时边权按 1 计
+int countMismatches(const GraphModel& graph, const GraphSearch& parallel, const GraphSearch& sequential,
+                    bool weighted);
+
+#endif
@@ -0,0 +1,30 @@
+#include "pathlogmodel.h"
+
+PathLogModel::PathLogModel(Formatter formatter, QObject* parent)
+    : QAbstractListModel(parent), formatter(std::move(formatter))
+{
+}
+
+int PathLogModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(lines.size());
+}
+
+QVariant PathLogModel::data(const QModelIndex& index, int role) const {
+    if (role != Qt::DisplayRole || !index.isValid() || index.row() >= rowCount()) return QVariant();
+    return formatter(lines[index.row()]);
+}
+
+void PathLogModel::append(int id) {
+    int row = rowCount();
+    beginInsertRows(QModelIndex(), row, row);
+    lines.push_back(id);
+    endInsertRows();
+}
+
+void PathLogModel::clear() {
+    if (lines.empty()) return;
+    beginResetModel();
+    lines.clear();
+    lines.shrink_to_fit();
+    endResetModel();
+}
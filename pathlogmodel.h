@@ -0,0 +1,30 @@
+#ifndef PATHLOGMODEL_H
+#define PATHLOGMODEL_H
+
+#include <QAbstractListModel>
+#include <functional>
+#include <vector>
+
+// 遍历路径日志的数据模型：每行只保存被访问节点的编号（4 字节），
+// 行文本在视图绘制时才由 formatter 生成，只有可见的几十行会被格式化。
+// 配合 setUniformItemSizes(true) 的 QListView，百万行日志追加时不需要重新排版。
+class PathLogModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    using Formatter = std::function<QString(int id)>;
+
+    explicit PathLogModel(Formatter formatter, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    void append(int id);    // 追加一行
+    void clear();           // 清空日志
+
+private:
+    Formatter formatter;
+    std::vector<int> lines;
+};
+
+#endif
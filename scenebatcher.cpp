@@ -0,0 +1,81 @@
+#include "scenebatcher.h"
+#include "NodeItem.h"
+#include "animationscheduler.h"
+#include "nodeitempool.h"
+
+#include <QGraphicsScene>
+#include <memory>
+
+SceneBatcher::SceneBatcher(QGraphicsScene* scene, std::function<void()> layout, QObject* parent)
+    : QObject(parent), scene(scene), layout(std::move(layout)),
+      channel(AnimationScheduler::instance().newChannel())
+{
+}
+
+// 控件销毁时丢弃本通道尚未执行的动画和合并任务
+SceneBatcher::~SceneBatcher() {
+    AnimationScheduler::instance().cancel(channel);
+}
+
+void SceneBatcher::requestLayout() {
+    layoutRequested = true;
+    scheduleFlush();
+}
+
+void SceneBatcher::fadeIn(NodeItem* node) {
+    node->setOpacity(0.0);
+    pendingFadeIn.push_back(node);
+    requestLayout();
+}
+
+void SceneBatcher::fadeOut(NodeItem* node) {
+    pendingFadeOut.push_back(node);
+    scheduleFlush();
+}
+
+// 同一帧内只挂起一次合并
+void SceneBatcher::scheduleFlush() {
+    if (flushScheduled) return;
+    flushScheduled = true;
+    AnimationScheduler::instance().after(channel, frameIntervalMs, [this]() { flush(); });
+}
+
+void SceneBatcher::flush() {
+    flushScheduled = false;
+    auto& scheduler = AnimationScheduler::instance();
+
+    // 先布局，新节点在正确的位置上淡入
+    if (layoutRequested) {
+        layoutRequested = false;
+        if (layout) layout();
+    }
+
+    // 本帧插入的节点合成一组淡入动画
+    for (NodeItem* node : pendingFadeIn)
+        scheduler.animateOpacity(node, 0.0, 1.0, 500, channel);
+    pendingFadeIn.clear();
+
+    // 本帧删除的节点合成一组淡出动画，全部结束后统一回收并重新布局一次
+    if (!pendingFadeOut.empty()) {
+        auto doomed = std::make_shared<std::vector<NodeItem*>>();
+        doomed->swap(pendingFadeOut);
+        int group = scheduler.createGroup(channel, [this, doomed]() {
+            for (NodeItem* node : *doomed) {
+                if (itemPool) {
+                    itemPool->release(node);
+                    continue;
+                }
+                scene->removeItem(node);
+                delete node;
+            }
+            requestLayout();
+        });
+        for (NodeItem* node : *doomed)
+            scheduler.animateOpacity(node, node->opacity(), 0.0, 500, channel, group);
+    }
+}
+
+void SceneBatcher::finishAll() {
+    flush();
+    AnimationScheduler::instance().finish(channel);
+}
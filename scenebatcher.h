@@ -0,0 +1,45 @@
+#ifndef SCENEBATCHER_H
+#define SCENEBATCHER_H
+
+#include <QObject>
+#include <functional>
+#include <vector>
+
+class QGraphicsScene;
+class NodeItem;
+class NodeItemPool;
+
+// SceneBatcher 把同一帧内的多次场景更新合并成一次：
+// 多次 requestLayout() 只触发一次布局回调，同一帧内插入/删除的节点分别合成一组淡入/淡出动画。
+// 批量导入一万个节点时，只做一次布局、启动两组动画。动画由全局 AnimationScheduler 驱动。
+class SceneBatcher : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr int frameIntervalMs = 16;  // 合并窗口，约一帧
+
+    SceneBatcher(QGraphicsScene* scene, std::function<void()> layout, QObject* parent = nullptr);
+    ~SceneBatcher() override;
+
+    void requestLayout();           // 请求在下一帧重新布局
+    void fadeIn(NodeItem* node);    // 节点淡入，并请求布局
+    void fadeOut(NodeItem* node);   // 节点淡出，结束后归还图元池（未设置时从场景移除、删除），并请求布局
+    void setItemPool(NodeItemPool* pool) { itemPool = pool; }
+    void flush();                   // 立即执行挂起的布局并启动动画
+    void finishAll();               // 立即完成所有动画（淡出的节点随之删除），删除场景中的节点前必须调用
+    int  animationChannel() const { return channel; }   // 控件的其他动画也可挂在这个通道上
+
+private:
+    QGraphicsScene* scene;
+    std::function<void()> layout;
+    NodeItemPool* itemPool = nullptr;
+    std::vector<NodeItem*> pendingFadeIn;
+    std::vector<NodeItem*> pendingFadeOut;
+    int  channel;                   // 本控件在调度器中的动画通道
+    bool flushScheduled = false;
+    bool layoutRequested = false;
+
+    void scheduleFlush();
+};
+
+#endif
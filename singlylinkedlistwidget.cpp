@@ -1,18 +1,20 @@
 #include "SinglyLinkedListWidget.h"
 #include "NodeItem.h"
-#include "ArrowItem.h"
+#include "loditems.h"
+#include "animationscheduler.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
-#include <QGraphicsLineItem>
-#include <QPropertyAnimation>
 #include <QMessageBox>
-#include <QTimer>
 #include <QPen>
+#include <QScrollBar>
+#include <QStyleOptionGraphicsItem>
 #include <cmath>
+#include <algorithm>
+#include <iterator>
 
 SinglyLinkedListWidget::SinglyLinkedListWidget(QWidget* parent)
-    : QWidget(parent), nextNodeId(1)
+    : QWidget(parent), model(LinkedListModel::Singly)
 {
     // 创建垂直布局管理器，并将其设置为当前小部件的布局
     auto *vlay = new QVBoxLayout(this);
@@ -43,6 +45,15 @@ SinglyLinkedListWidget::SinglyLinkedListWidget(QWidget* parent)
     hlay->addWidget(removeSpecifiedButton);
     hlay->addWidget(clearButton);
     vlay->addLayout(hlay);  // 将横向布局添加到垂直布局中
+    opBar = new OpLogBar(&model, this);  // 录制/回放操作日志
+    vlay->addWidget(opBar);
+    importBar = new ImportBar(this);    // 从 CSV 或二进制文件批量导入
+    importBar->setJobFactory([this]() { return makeImportJob(); });
+    vlay->addWidget(importBar);
+    // 导入完成时整条链表被替换，录进日志要逐个节点编码，千万级导入会卡住界面，所以录制期间不能导入
+    connect(opBar, &OpLogBar::recordingChanged, importBar, [this](bool recording) {
+        importBar->setBlocked(recording ? "录制期间不能导入，请先停止录制" : QString());
+    });
 
     // 信号与槽连接
     connect(addEndButton, &QPushButton::clicked, this, &SinglyLinkedListWidget::onAddEnd);
@@ -51,29 +62,42 @@ SinglyLinkedListWidget::SinglyLinkedListWidget(QWidget* parent)
     connect(removeSpecifiedButton, &QPushButton::clicked, this, &SinglyLinkedListWidget::onRemoveSpecified);
     connect(clearButton, &QPushButton::clicked, this, &SinglyLinkedListWidget::onClear);
 
+    pool = std::make_unique<NodeItemPool>(scene);
+    batcher = new SceneBatcher(scene, [this]() { updateScene(); }, this);
+    batcher->setItemPool(pool.get());   // 淡出结束的节点归还图元池
+    overview = new AggregateBlockItem;  // 极度缩小时代替节点绘制的聚合色块
+    scene->addItem(overview);
+    edges = new EdgeLayerItem;  // 所有连线由一个图元批量绘制
+    scene->addItem(edges);
+
+    // 拖动平移时把图元重新绑定到视口内的槽位
+    connect(view->horizontalScrollBar(), &QScrollBar::valueChanged, this, &SinglyLinkedListWidget::bindVisible);
+    connect(view->verticalScrollBar(),   &QScrollBar::valueChanged, this, &SinglyLinkedListWidget::bindVisible);
+
+    // 订阅模型变更，所有图元都由模型事件驱动
+    model.changes().subscribe([this](const ListEvent& e) { onModelChanged(e); });
+
     // 初始化场景矩形区域
     scene->setSceneRect(0,0,800,200);
 }
 
+// 模型先于子控件销毁，先停止录制和回放，取消对模型的订阅
+SinglyLinkedListWidget::~SinglyLinkedListWidget() {
+    opBar->stop();
+}
+
 void SinglyLinkedListWidget::onAddEnd() {
-    // 创建新节点并添加到链表末尾
-    NodeItem* node = new NodeItem(nextNodeId++, nullptr);
-    node->setOpacity(0.0);  // 设置节点的初始透明度为0
-    nodes.push_back(node);  // 将节点添加到链表
-    scene->addItem(node);  // 将节点添加到场景中
-    animateNodeInsertion(node);  // 动画效果：节点插入
-    updateScene();  // 更新场景
+    // 在模型末尾添加节点，图元由 onModelChanged 创建
+    model.append();
 }
 
 void SinglyLinkedListWidget::onRemoveEnd() {
     // 如果链表为空，则弹出提示信息
-    if (nodes.empty()) {
+    if (model.empty()) {
         QMessageBox::information(this, "提示", "链表为空！");
         return;
     }
-    NodeItem* node = nodes.back();  // 获取链表末尾节点
-    animateNodeDeletion(node, [this]() { updateScene(); });  // 动画效果：节点删除
-    nodes.pop_back();  // 删除链表末尾节点
+    model.removeLast();  // 删除链表末尾节点
 }
 
 void SinglyLinkedListWidget::onAddAfter() {
@@ -84,22 +108,13 @@ void SinglyLinkedListWidget::onAddAfter() {
         QMessageBox::warning(this, "输入错误", "请输入合法编号！");
         return;
     }
-    // 查找目标节点
-    int pos = -1;
-    for (int i = 0; i < (int)nodes.size(); ++i) {
-        if (nodes[i]->getValue() == target) { pos = i; break; }
-    }
-    if (pos < 0) {
+    // 通过索引查找目标节点，O(1)
+    if (!model.contains(target)) {
         QMessageBox::warning(this, "错误", "未找到目标节点！");
         return;
     }
-    // 在目标节点后插入新节点
-    NodeItem* newNode = new NodeItem(nextNodeId++, nullptr);
-    newNode->setOpacity(0.0);
-    nodes.insert(nodes.begin() + pos + 1, newNode);
-    scene->addItem(newNode);
-    animateNodeInsertion(newNode);  // 动画效果：节点插入
-    QTimer::singleShot(600, this, &SinglyLinkedListWidget::updateScene);  // 延时更新场景
+    // 在目标节点后插入新节点，链表插入 O(1)，不移动其他节点指针
+    model.insertAfter(target);
     targetLineEdit->clear();  // 清空输入框
 }
 
@@ -111,101 +126,222 @@ void SinglyLinkedListWidget::onRemoveSpecified() {
         QMessageBox::warning(this, "输入错误", "请输入合法编号！");
         return;
     }
-    // 查找目标节点
-    int pos = -1;
-    for (int i = 0; i < (int)nodes.size(); ++i) {
-        if (nodes[i]->getValue() == target) { pos = i; break; }
-    }
-    if (pos < 0) {
+    // 通过索引查找目标节点，O(1)
+    if (!model.contains(target)) {
         QMessageBox::warning(this, "错误", "未找到目标节点！");
         return;
     }
     // 删除指定节点
-    NodeItem* node = nodes[pos];
-    animateNodeDeletion(node, [this]() { updateScene(); });  // 动画效果：节点删除
-    nodes.erase(nodes.begin() + pos);  // 删除节点
+    model.remove(target);
     targetLineEdit->clear();  // 清空输入框
 }
 
 void SinglyLinkedListWidget::onClear() {
-    // 清空所有节点、连线和箭头
-    for (auto *n : nodes) { scene->removeItem(n); delete n; }
-    for (auto *l : lines) { scene->removeItem(l); delete l; }
-    for (auto *a : arrows){ scene->removeItem(a); delete a; }
-    nodes.clear(); lines.clear(); arrows.clear();  // 清空容器
-    nextNodeId = 1;  // 重置节点ID
+    model.clear();
     targetLineEdit->clear();  // 清空输入框
-    updateScene();  // 更新场景
 }
 
+// 模型变更后同步节点：只记录节点并请求布局，图元在绑定可见槽位时才创建；删除时已绑定的图元淡出
+// 图元增删计数在每个事件开始时清零，同一帧内延后的布局和绑定计入最近一次事件
+void SinglyLinkedListWidget::onModelChanged(const ListEvent& e) {
+    sceneItemChurn = 0;
+    switch (e.type) {
+    case ListEvent::Inserted: {
+        auto pos = e.prevId < 0 ? nodes.begin() : std::next(nodeIndex.at(e.prevId));
+        Slot* prev = e.prevId < 0 ? nullptr : &*std::prev(pos);
+        auto it = nodes.insert(pos, Slot{e.id, e.value, nullptr, nullptr, true});  // 插到前驱之后，O(1)
+        nodeIndex[e.id] = it;
+        order.insertAfter(&*it, prev);  // 只改动前驱所在的块
+        freshIds.push_back(e.id);
+        batcher->requestLayout();  // 同一帧内的插入只布局一次
+        break;
+    }
+    case ListEvent::Removed: {
+        auto found = nodeIndex.find(e.id);
+        NodeItem* node = found->second->item;
+        order.erase(&*found->second);
+        nodes.erase(found->second);  // 删除节点，O(1)
+        nodeIndex.erase(found);
+        if (node) batcher->fadeOut(node);  // 动画效果：节点删除，淡出结束后回收图元并重新布局
+        else batcher->requestLayout();
+        break;
+    }
+    case ListEvent::Cleared:
+        releaseAll();   // 清空所有节点和连线，已绑定的图元回收复用
+        updateScene();  // 更新场景
+        break;
+    case ListEvent::Reset:
+        // 整条链表被替换：导入时槽位已在工作线程中按顺序建好，直接交换；否则按模型重建
+        releaseAll();
+        if (staged) {
+            nodes.swap(staged->nodes);
+            nodeIndex.swap(staged->nodeIndex);
+            order.swap(staged->order);
+        } else {
+            nodeIndex.reserve(model.size());
+            for (const ListNode& n : model) {
+                nodeIndex[n.id] = nodes.insert(nodes.end(), Slot{n.id, n.value});
+                order.push_back(&nodes.back());
+            }
+        }
+        updateScene();
+        break;
+    }
+}
+
+void SinglyLinkedListWidget::releaseAll() {
+    batcher->finishAll();  // 先结束进行中的动画，淡出中的节点随之删除
+    for (Slot& s : nodes)
+        if (s.item) pool->release(s.item);
+    sceneItemChurn += edges->count();
+    nodes.clear(); nodeIndex.clear(); order.clear();
+    boundIds.clear(); freshIds.clear();
+    edges->clear(); edgeFirst = 0;
+}
+
+// 工作线程逐块追加到暂存链表，再按链表顺序建好槽位和编号索引；
+// 界面线程只交换容器，之后只为视口内的槽位绑定图元，导入的节点数不影响换入的耗时
+ImportJob SinglyLinkedListWidget::makeImportJob() {
+    auto staging = std::make_shared<ImportStaging>(model.kind());
+    ImportJob job;
+    job.consume = [staging](const int* values, std::size_t count, std::string&) {
+        staging->model.appendMany(values, count);
+        return true;
+    };
+    job.prepare = [staging]() {
+        staging->nodeIndex.reserve(staging->model.size());
+        for (const ListNode& n : staging->model) {
+            Slot& s = staging->nodes.emplace_back(Slot{n.id, n.value});
+            staging->nodeIndex[n.id] = std::prev(staging->nodes.end());
+            staging->order.push_back(&s);
+        }
+    };
+    job.commit = [this, staging]() {
+        staged = staging.get();
+        model.adopt(staging->model);
+        staged = nullptr;
+    };
+    return job;
+}
+
+void SinglyLinkedListWidget::showEvent(QShowEvent* ev) {
+    QWidget::showEvent(ev);
+    bindVisible();
+}
+
+void SinglyLinkedListWidget::resizeEvent(QResizeEvent* ev) {
+    QWidget::resizeEvent(ev);
+    bindVisible();
+}
+
+// 场景范围和概览色块由槽位公式直接算出，不访问任何图元；节点图元只在 bindVisible 中定位
 void SinglyLinkedListWidget::updateScene() {
-    // 清除旧的连线和箭头
-    for (auto *l : lines) { scene->removeItem(l); delete l; }
-    for (auto *a : arrows){ scene->removeItem(a); delete a; }
-    lines.clear(); arrows.clear();  // 清空容器
+    int n = static_cast<int>(nodes.size());
+
+    // 自动扩展场景：由首尾槽位直接算出包围盒。未绑定的槽位没有图元，场景不会自己长大
+    QRectF br(slotPos(0), slotPos(std::max(0, n - 1)) + QPointF(40, 40));
+    scene->setSceneRect(br.united(QRectF(0, 0, 800, 200)).adjusted(-20,-20,20,20));
+
+    // 每 64 个槽位概括为一个色块，供极度缩小时绘制。色块只由槽位决定，
+    // 槽位数从 overviewSlots 变为 n 时，只有序号不小于 min(overviewSlots, n) / 64 的色块会变，通常只是最后一块
+    int count = (n + 63) / 64;
+    overview->resizeBlocks(count);
+    for (int k = std::min(overviewSlots, n) / 64; k < count; ++k)
+        overview->setBlock(k, QRectF(slotPos(k * 64), slotPos(std::min(k * 64 + 63, n - 1)) + QPointF(40, 40)));
+    overview->setBounds(n > 0 ? QRectF(slotPos(0), slotPos(n - 1) + QPointF(40, 40)) : QRectF());
+    overviewSlots = n;
+
+    bindVisible();
+}
 
-    // 布局节点
-    int n = nodes.size();
+// 视口（左右外扩 viewMargin）内的槽位区间由槽位公式反推，只为这些槽位绑定图元，
+// 其余图元隐藏后放回备用列表；拖动平移时图元随视口重新绑定，场景中的图元数只与视口大小有关
+void SinglyLinkedListWidget::bindVisible() {
     const qreal startX = 50, gap = 100, y = 80;
-    for (int i = 0; i < n; ++i) {
-        nodes[i]->setPos(startX + i*gap, y);  // 设置每个节点的位置
+    int n = static_cast<int>(order.size());
+    int first = 0, last = -1;
+    QRectF vis = view->mapToScene(view->viewport()->rect()).boundingRect()
+                     .adjusted(-viewMargin, 0, viewMargin, 0);
+    // 极度缩小时节点和连线都不绘制，由聚合色块代替，不绑定任何图元
+    bool aggregated = QStyleOptionGraphicsItem::levelOfDetailFromTransform(view->transform()) < Lod::Aggregate;
+    if (!aggregated && vis.bottom() >= y && vis.top() <= y + 40) {
+        // 槽位 i 占 [startX + i*gap, startX + i*gap + 40]
+        first = std::max(0, int(std::ceil((vis.left() - startX - 40) / gap)));
+        last  = std::min(n - 1, int(std::floor((vis.right() - startX) / gap)));
     }
 
-    // 绘制节点之间的连接
-    for (int i = 0; i + 1 < n; ++i) {
-        drawConnection(nodes[i], nodes[i+1]);
+    // 回收离开绑定范围的图元，已删除的节点直接跳过
+    std::vector<int> kept;
+    for (int id : boundIds) {
+        auto found = nodeIndex.find(id);
+        if (found == nodeIndex.end() || !found->second->item) continue;
+        Slot& s = *found->second;
+        int index = order.rank(&s);
+        if (index >= first && index <= last) { kept.push_back(id); continue; }
+        pool->release(s.item);
+        s.item = nullptr;
     }
 
-    // 自动扩展场景
-    QRectF br = scene->itemsBoundingRect();
-    scene->setSceneRect(br.adjusted(-20,-20,20,20));  // 调整场景矩形区域
+    // 为范围内的槽位绑定图元，优先复用图元池中的备用图元；刚插入的节点淡入
+    auto& scheduler = AnimationScheduler::instance();
+    int createdBefore = pool->created();
+    order.forRange(first, last, [&](int i, Slot& s) {
+        if (!s.item) {
+            s.item = pool->acquire(s.value);
+            kept.push_back(s.id);
+            if (s.fresh) {
+                s.item->setOpacity(0.0);
+                scheduler.animateOpacity(s.item, 0.0, 1.0, 500, batcher->animationChannel());
+            }
+        }
+        s.item->setPos(slotPos(i));
+    });
+    boundIds.swap(kept);
+    sceneItemChurn += pool->created() - createdBefore;     // 只有图元池不够用时才新建图元
+
+    // 不在视口内的新节点以后滚动进来时直接显示
+    for (int id : freshIds) {
+        auto found = nodeIndex.find(id);
+        if (found != nodeIndex.end()) found->second->fresh = false;
+    }
+    freshIds.clear();
+
+    syncEdges(first, std::max(0, std::min(last, n - 2) - first + 1));
 }
 
-void SinglyLinkedListWidget::drawConnection(NodeItem* from, NodeItem* to) {
-    // 计算连接线的起点和终点
-    QPointF p = from->pos() + QPointF(20, 20);
-    QPointF c = to->pos() + QPointF(20, 20);
+QPointF SinglyLinkedListWidget::slotPos(int index) const {
+    const qreal startX = 50, gap = 100, y = 80;
+    return QPointF(startX + index * gap, y);
+}
+
+// 连线几何只由槽位决定，绑定范围移动时原地改写已有条目，只在末尾增删差额
+void SinglyLinkedListWidget::syncEdges(int first, int count) {
+    if (first == edgeFirst && count == edges->count()) return;
+    edgeFirst = first;
+    int reuse = std::min(count, edges->count());
+    for (int k = 0; k < reuse; ++k) {
+        QLineF l = connection(first + k);
+        edges->moveEdge(k, l.p1(), l.p2());
+    }
+    if (reuse > 0) edges->commitMoves();
+    if (edges->count() > count) {
+        sceneItemChurn += edges->count() - count;
+        edges->removeLast(edges->count() - count);
+    }
+    while (edges->count() < count) {
+        QLineF l = connection(first + edges->count());
+        edges->addEdge(l.p1(), l.p2());  // 箭头由图层在终点绘制
+        ++sceneItemChurn;
+    }
+}
+
+QLineF SinglyLinkedListWidget::connection(int index) const {
+    // 计算第 index 个槽位到第 index+1 个槽位的连接线起点和终点
+    QPointF p = slotPos(index) + QPointF(20, 20);
+    QPointF c = slotPos(index + 1) + QPointF(20, 20);
     qreal ang = std::atan2(c.y() - p.y(), c.x() - p.x());  // 计算角度
     constexpr qreal R = 20.0;
     QPointF pEdge = p + QPointF(std::cos(ang) * R, std::sin(ang) * R);
     QPointF cEdge = c - QPointF(std::cos(ang) * R, std::sin(ang) * R);
-
-    // 绘制连线
-    auto *line = new QGraphicsLineItem(QLineF(pEdge, cEdge));
-    line->setPen(QPen(Qt::black, 2));
-    scene->addItem(line);
-    lines.push_back(line);
-
-    // 绘制箭头
-    QPolygonF tri;
-    tri << QPointF(0, 0) << QPointF(-8, -5) << QPointF(-8, 5);
-    auto *arrow = new ArrowItem(tri);
-    arrow->setBrush(Qt::black);
-    arrow->setPos(cEdge);
-    arrow->setRotation(ang * 180.0 / M_PI);
-    scene->addItem(arrow);
-    arrows.push_back(arrow);
-}
-
-void SinglyLinkedListWidget::animateNodeInsertion(NodeItem* node) {
-    // 动画效果：节点插入时逐渐显示
-    auto *anim = new QPropertyAnimation(node, "opacity");
-    anim->setDuration(500);
-    anim->setStartValue(0.0);
-    anim->setEndValue(1.0);
-    anim->start(QAbstractAnimation::DeleteWhenStopped);
-}
-
-void SinglyLinkedListWidget::animateNodeDeletion(NodeItem* node, std::function<void()> callback) {
-    // 动画效果：节点删除时逐渐消失
-    auto *anim = new QPropertyAnimation(node, "opacity");
-    anim->setDuration(500);
-    anim->setStartValue(1.0);
-    anim->setEndValue(0.0);
-    connect(anim, &QPropertyAnimation::finished, this, [=]() {
-        scene->removeItem(node);  // 移除节点
-        delete node;  // 删除节点
-        if (callback) callback();  // 执行回调函数
-    });
-    anim->start(QAbstractAnimation::DeleteWhenStopped);
+    return QLineF(pEdge, cEdge);
 }
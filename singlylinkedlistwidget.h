@@ -6,10 +6,20 @@
 #include <QGraphicsView>
 #include <QLineEdit>
 #include <QPushButton>
-#include <QGraphicsLineItem>
+#include <QLineF>
 #include "NodeItem.h"
-#include "ArrowItem.h"
+#include "edgelayeritem.h"
+#include "linkedlistmodel.h"
+#include "scenebatcher.h"
+#include "loditems.h"
+#include "nodeitempool.h"
+#include "oplogbar.h"
+#include "importbar.h"
+#include "chunkedorder.h"
+#include <memory>
 #include <vector>
+#include <list>
+#include <unordered_map>
 #include <functional>
 
 class SinglyLinkedListWidget : public QWidget
@@ -17,6 +27,19 @@ class SinglyLinkedListWidget : public QWidget
     Q_OBJECT
 public:
     explicit SinglyLinkedListWidget(QWidget *parent = nullptr);
+    ~SinglyLinkedListWidget() override;
+
+    // 最近一次模型事件（含随后的布局）中创建和销毁的节点图元与连线条目总数，状态栏显示，用于检查增量更新的开销
+    int lastSceneItemChurn() const { return sceneItemChurn; }
+
+    // 链表模型，可脱离界面直接驱动；控件订阅其变更事件并据此绘制
+    LinkedListModel& listModel() { return model; }
+
+    int materializedCount() const { return static_cast<int>(boundIds.size()); }  // 当前绑定了图元的节点数
+
+protected:
+    void showEvent(QShowEvent* ev) override;
+    void resizeEvent(QResizeEvent* ev) override;
 
 private slots:
     void onAddEnd();    // 添加节点到链表末尾
@@ -24,8 +47,29 @@ private slots:
     void onAddAfter();  // 在指定节点后插入新节点
     void onRemoveSpecified();   // 删除指定节点
     void onClear(); // 清空链表
+    void bindVisible();     // 把图元绑定到视口内的槽位，回收离开视口的图元
 
 private:
+    // 显示中的一个节点：只有在视口（外扩一圈）内时才绑定图元
+    struct Slot {
+        int id;
+        int value;
+        NodeItem* item = nullptr;
+        ChunkedOrder<Slot>::Chunk* chunk = nullptr;    // 在 order 中所在的块，由 order 维护
+        bool fresh = false;     // 刚插入，绑定图元时淡入
+    };
+
+    // 导入时在工作线程中构建的链表和槽位，完成后在 Reset 事件中整体换入
+    struct ImportStaging {
+        explicit ImportStaging(LinkedListModel::Kind kind) : model(kind) {}
+        LinkedListModel model;
+        std::list<Slot> nodes;
+        std::unordered_map<int, std::list<Slot>::iterator> nodeIndex;
+        ChunkedOrder<Slot> order;
+    };
+
+    static constexpr qreal viewMargin = 400;   // 视口左右各外扩这么宽的场景坐标
+
     QGraphicsScene *scene;
     QGraphicsView  *view;
     QLineEdit      *targetLineEdit;
@@ -35,15 +79,30 @@ private:
     QPushButton    *removeSpecifiedButton;
     QPushButton    *clearButton;
 
-    std::vector<NodeItem*> nodes; // 存储所有节点的列表
-    std::vector<QGraphicsLineItem*> lines; // 存储节点之间连接的线条
-    std::vector<ArrowItem*> arrows; // 存储箭头，表示节点指向关系
-    int nextNodeId;
+    LinkedListModel model;  // 链表数据，与图元解耦
+    OpLogBar* opBar;        // 录制/回放操作日志
+    ImportBar* importBar;   // 从文件批量导入
+    ImportStaging* staged = nullptr;    // 正在换入的导入结果，只在 adopt 期间非空
+    std::list<Slot> nodes;  // 按链表顺序存储所有节点，支持 O(1) 插入/删除
+    std::unordered_map<int, std::list<Slot>::iterator> nodeIndex;  // 节点编号 -> 节点位置
+    ChunkedOrder<Slot> order;   // 按槽位顺序的节点，增删只改动所在的块，按槽位查找 O(log n)
+    std::vector<int> boundIds;  // 绑定了图元的节点编号
+    std::vector<int> freshIds;  // 尚未绑定过的新节点编号
+    std::unique_ptr<NodeItemPool> pool; // 节点图元池：离开视口或删除的图元回收复用
+    EdgeLayerItem *edges;   // 边图层：只含绑定范围内的连线，第 k 条连接第 edgeFirst+k 和下一个槽位
+    int edgeFirst = 0;
+    int sceneItemChurn = 0; // 当前操作中创建/销毁的图元计数
+    SceneBatcher *batcher;  // 合并同一帧内的布局和淡入/淡出动画
+    AggregateBlockItem* overview;  // 聚合色块，用于极度缩小时的概览
+    int overviewSlots = 0;  // 概览色块对应的槽位数；色块只由槽位决定，槽位数变化时只改末尾的色块
 
-    void updateScene(); // 更新图形场景
-    void drawConnection(NodeItem* from, NodeItem* to);  // 绘制从一个节点到另一个节点的连接线
-    void animateNodeInsertion(NodeItem *node);  // 插入节点动画效果
-    void animateNodeDeletion(NodeItem *node, std::function<void()> callback);   // 删除节点动画效果，并在删除完成后执行回调
+    void onModelChanged(const ListEvent& e);    // 根据模型变更事件增删图元
+    ImportJob makeImportJob();  // 为一次导入准备暂存模型
+    void releaseAll();  // 回收所有图元和连线，清空槽位
+    void updateScene(); // 更新场景范围和概览色块，再重新绑定可见槽位
+    QPointF slotPos(int index) const;   // 第 index 个槽位的节点位置
+    QLineF connection(int index) const; // 从第 index 个槽位指向下一个槽位的连线
+    void syncEdges(int first, int count);   // 让边图层恰好包含从 first 开始的 count 条连线
 };
 
 #endif
@@ -0,0 +1,375 @@
+#include "tidytreelayout.h"
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+TidyTreeLayout::TidyTreeLayout(const BinaryTreeModel& tree, double separation)
+    : tree(tree), separation(separation)
+{
+}
+
+// 节点编号来自模型的节点池，按池容量扩展各数组
+void TidyTreeLayout::ensure(int id) {
+    if (id < static_cast<int>(offset.size())) return;
+    size_t n = std::max(id + 1, tree.capacity());
+    offset.resize(n, 0);
+    thread.resize(n, npos);
+    threadOffset.resize(n, 0);
+    threadSource.resize(n, npos);
+    leftExtreme.resize(n, npos);
+    rightExtreme.resize(n, npos);
+    leftExtremeOffset.resize(n, 0);
+    rightExtremeOffset.resize(n, 0);
+    subtreeHeight.resize(n, 0);
+    dirty.resize(n, 0);
+    m_x.resize(n, 0);
+    m_depth.resize(n, 0);
+}
+
+// 把新节点到根的路径标记为脏；遇到已标记的节点即停止，它的祖先必然也已标记
+void TidyTreeLayout::markPath(int id) {
+    anyDirty = true;
+    while (id != npos && !dirty[id]) {
+        dirty[id] = 1;
+        id = tree.parent(id);
+    }
+}
+
+void TidyTreeLayout::resetNode(int id) {
+    ensure(id);
+    offset[id] = 0;
+    m_x[id] = std::numeric_limits<double>::quiet_NaN();    // 与任何坐标都不相等，place() 必然把它计入 moved()
+    thread[id] = npos;      // 编号可能是复用的，清掉旧状态
+    threadSource[id] = npos;
+    dirty[id] = 0;
+}
+
+void TidyTreeLayout::unlinkNode(int id) {
+    ensure(id);
+    if (threadSource[id] != npos) thread[threadSource[id]] = npos;
+    threadSource[id] = npos;
+    thread[id] = npos;
+    dirty[id] = 0;
+}
+
+void TidyTreeLayout::nodeInserted(int id) {
+    resetNode(id);
+    markPath(id);
+}
+
+void TidyTreeLayout::nodeRemoved(int id, int anchor) {
+    unlinkNode(id);
+    invalidate(anchor);
+}
+
+// 旋转或删除改变了祖先链，已标记的节点上方未必已标记（例如后继节点被接到上方），因此一直走到根
+void TidyTreeLayout::invalidate(int id) {
+    anyDirty = true;
+    if (id == npos) return;
+    ensure(id);
+    for (; id != npos; id = tree.parent(id)) dirty[id] = 1;
+}
+
+void TidyTreeLayout::invalidateAll() {
+    if (tree.capacity() == 0) return;
+    ensure(tree.capacity() - 1);
+    for (int id = 0; id < tree.capacity(); ++id) dirty[id] = tree.isValid(id);
+    anyDirty = true;
+}
+
+void TidyTreeLayout::clear() {
+    offset.clear(); thread.clear(); threadOffset.clear(); threadSource.clear();
+    leftExtreme.clear(); rightExtreme.clear(); leftExtremeOffset.clear(); rightExtremeOffset.clear();
+    subtreeHeight.clear(); dirty.clear(); m_x.clear(); m_depth.clear(); m_moved.clear();
+    anyDirty = false;
+    m_minX = m_maxX = 0;
+    m_height = -1;
+}
+
+// 先按顺序处理节点的增删，再设置脏标记。本批中先标记后删除的节点仍留着脏标记，
+// 它已不在树上，update() 从根出发走不到它，编号被复用时 resetNode() 会清掉
+void TidyTreeLayout::apply(const TreeLayoutChanges::Batch& changes) {
+    if (changes.all) {
+        // 与 nodeInserted 相同，把坐标置为 NaN，所有节点都计入 moved()
+        clear();
+        invalidateAll();
+        std::fill(m_x.begin(), m_x.end(), std::numeric_limits<double>::quiet_NaN());
+        return;
+    }
+    for (int id : changes.nodes) {
+        if (id >= 0) resetNode(id);
+        else unlinkNode(~id);
+    }
+    for (int id : changes.dirty) {
+        ensure(id);
+        dirty[id] = 1;
+    }
+    anyDirty = true;
+}
+
+int TidyTreeLayout::update() {
+    if (!anyDirty) {
+        m_moved.clear();    // 没有脏节点时也没有节点移动，不能留着上一次的结果
+        return 0;
+    }
+    anyDirty = false;
+    if (tree.capacity() > 0) ensure(tree.capacity() - 1);
+    int root = tree.root();
+    int merged = 0;
+
+    if (root != npos && dirty[root]) {
+        // 先撤销所有脏节点上次合并时设置的线索：旧线索可能落在其他脏节点的子树中，会干扰轮廓行走
+        stack.clear();
+        stack.push_back(root);
+        while (!stack.empty()) {
+            int v = stack.back();
+            stack.pop_back();
+            if (threadSource[v] != npos) thread[threadSource[v]] = npos;
+            threadSource[v] = npos;
+            for (int c : {tree.left(v), tree.right(v)})
+                if (c != npos && dirty[c]) stack.push_back(c);
+        }
+
+        // 再按后序重新合并：孩子的轮廓先于父节点算好。按位取反的编号表示孩子已经入栈
+        stack.push_back(root);
+        while (!stack.empty()) {
+            int v = stack.back();
+            stack.pop_back();
+            if (v >= 0) {
+                stack.push_back(~v);
+                for (int c : {tree.left(v), tree.right(v)})
+                    if (c != npos && dirty[c]) stack.push_back(c);
+            } else {
+                merge(~v);
+                ++merged;
+            }
+        }
+    }
+    place();
+    return merged;
+}
+
+int TidyTreeLayout::nextLeft(int v, double& x) const {
+    int c = tree.left(v) != npos ? tree.left(v) : tree.right(v);
+    if (c != npos) {
+        x += offset[c];
+        return c;
+    }
+    if (thread[v] != npos) x += threadOffset[v];
+    return thread[v];
+}
+
+int TidyTreeLayout::nextRight(int v, double& x) const {
+    int c = tree.right(v) != npos ? tree.right(v) : tree.left(v);
+    if (c != npos) {
+        x += offset[c];
+        return c;
+    }
+    if (thread[v] != npos) x += threadOffset[v];
+    return thread[v];
+}
+
+// 合并节点 v 的两棵子树，确定孩子的偏移、v 的子树高度和最底层端点
+void TidyTreeLayout::merge(int v) {
+    int l = tree.left(v), r = tree.right(v);
+    if (l == npos && r == npos) {
+        leftExtreme[v] = rightExtreme[v] = v;
+        leftExtremeOffset[v] = rightExtremeOffset[v] = 0;
+        subtreeHeight[v] = 0;
+        return;
+    }
+    if (l == npos || r == npos) {
+        // 只有一个孩子时偏向它所在的一侧，仍能看出是左孩子还是右孩子
+        int c = l != npos ? l : r;
+        offset[c] = l != npos ? -separation / 2 : separation / 2;
+        leftExtreme[v] = leftExtreme[c];
+        rightExtreme[v] = rightExtreme[c];
+        leftExtremeOffset[v] = offset[c] + leftExtremeOffset[c];
+        rightExtremeOffset[v] = offset[c] + rightExtremeOffset[c];
+        subtreeHeight[v] = subtreeHeight[c] + 1;
+        return;
+    }
+
+    // a 沿左子树的右轮廓、b 沿右子树的左轮廓逐层向下，ax/bx 为它们相对各自子树根的横坐标
+    int a = l, b = r;
+    double ax = 0, bx = 0;
+    double sep = separation;    // 两棵子树根之间的距离
+    for (;;) {
+        sep = std::max(sep, ax - bx + separation);
+        double nax = ax, nbx = bx;
+        int na = nextRight(a, nax);
+        int nb = nextLeft(b, nbx);
+        if (na == npos || nb == npos) {
+            offset[l] = -sep / 2;
+            offset[r] = sep / 2;
+            // 较矮子树最底层的外侧端点接上较高子树下一层的轮廓
+            if (na != npos) {
+                int s = rightExtreme[r];
+                thread[s] = na;
+                threadOffset[s] = (offset[l] + nax) - (offset[r] + rightExtremeOffset[r]);
+                threadSource[v] = s;
+            } else if (nb != npos) {
+                int s = leftExtreme[l];
+                thread[s] = nb;
+                threadOffset[s] = (offset[r] + nbx) - (offset[l] + leftExtremeOffset[l]);
+                threadSource[v] = s;
+            }
+            break;
+        }
+        a = na; ax = nax;
+        b = nb; bx = nbx;
+    }
+
+    int hl = subtreeHeight[l], hr = subtreeHeight[r];
+    int deepLeft = hl >= hr ? l : r;     // 最底层最左端所在的子树
+    int deepRight = hr >= hl ? r : l;
+    leftExtreme[v] = leftExtreme[deepLeft];
+    leftExtremeOffset[v] = offset[deepLeft] + leftExtremeOffset[deepLeft];
+    rightExtreme[v] = rightExtreme[deepRight];
+    rightExtremeOffset[v] = offset[deepRight] + rightExtremeOffset[deepRight];
+    subtreeHeight[v] = std::max(hl, hr) + 1;
+}
+
+// 自根向下累加偏移得到绝对坐标。只进入位置发生变化或刚重新合并过的节点：
+// 干净子树的内部偏移没变，只要子树根不动，整棵子树都不动。随后清除脏标记
+void TidyTreeLayout::place() {
+    m_moved.clear();
+    int root = tree.root();
+    if (root == npos) {
+        m_minX = m_maxX = 0;
+        m_height = -1;
+        return;
+    }
+    if (m_x[root] != 0 || m_depth[root] != 0) {
+        m_x[root] = 0;
+        m_depth[root] = 0;
+        m_moved.push_back(root);
+    }
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty()) {
+        int v = stack.back();
+        stack.pop_back();
+        dirty[v] = 0;
+        for (int c : {tree.left(v), tree.right(v)}) {
+            if (c == npos) continue;
+            double x = m_x[v] + offset[c];
+            int depth = m_depth[v] + 1;
+            bool moved = x != m_x[c] || depth != m_depth[c];
+            if (moved) {
+                m_x[c] = x;
+                m_depth[c] = depth;
+                m_moved.push_back(c);
+            }
+            if (moved || dirty[c]) stack.push_back(c);
+        }
+    }
+
+    // 轮廓上的节点就是每层的最左、最右节点，沿轮廓走一遍即得包围范围
+    m_height = subtreeHeight[root];
+    double x = 0;
+    m_minX = 0;
+    for (int v = nextLeft(root, x); v != npos; v = nextLeft(v, x)) m_minX = std::min(m_minX, x);
+    x = 0;
+    m_maxX = 0;
+    for (int v = nextRight(root, x); v != npos; v = nextRight(v, x)) m_maxX = std::max(m_maxX, x);
+}
+
+void TidyTreeLayout::copyTo(TreeLayoutBuffer& out) const {
+    out.x = m_x;
+    out.depth = m_depth;
+    out.moved = m_moved;
+    out.minX = m_minX;
+    out.maxX = m_maxX;
+    out.height = m_height;
+}
+
+void TreeLayoutChanges::Batch::append(Batch&& later) {
+    if (later.all) {
+        // 整体重新布局会丢弃之前的全部状态，带来的父子关系也覆盖了所有节点
+        *this = std::move(later);
+        return;
+    }
+    links.insert(links.end(), later.links.begin(), later.links.end());
+    root = later.root;
+    capacity = later.capacity;
+    if (all) return;    // 整体重新布局不需要节点和脏标记
+    nodes.insert(nodes.end(), later.nodes.begin(), later.nodes.end());
+    dirty.insert(dirty.end(), later.dirty.begin(), later.dirty.end());
+}
+
+void TreeLayoutChanges::ensure(const BinaryTreeModel& tree, int id) {
+    if (id >= static_cast<int>(marked.size())) marked.resize(std::max(id + 1, tree.capacity()), 0);
+}
+
+// 与 TidyTreeLayout::markPath 相同：遇到本批已标记的节点即停止
+void TreeLayoutChanges::markPath(const BinaryTreeModel& tree, int id) {
+    while (id != npos && !marked[id]) {
+        marked[id] = Dirty;
+        batch.dirty.push_back(id);
+        id = tree.parent(id);
+    }
+}
+
+void TreeLayoutChanges::nodeInserted(const BinaryTreeModel& tree, int id) {
+    ensure(tree, id);
+    batch.nodes.push_back(id);
+    marked[id] = 0;
+    markPath(tree, id);
+}
+
+void TreeLayoutChanges::nodeRemoved(const BinaryTreeModel& tree, int id, int anchor) {
+    ensure(tree, id);
+    batch.nodes.push_back(~id);
+    marked[id] = 0;
+    invalidate(tree, anchor);
+}
+
+// 与 TidyTreeLayout::invalidate 相同，一直走到根
+void TreeLayoutChanges::invalidate(const BinaryTreeModel& tree, int id) {
+    if (id == npos) return;
+    ensure(tree, id);
+    for (; id != npos; id = tree.parent(id)) {
+        if (!marked[id]) batch.dirty.push_back(id);
+        marked[id] = Dirty;
+    }
+}
+
+void TreeLayoutChanges::invalidateAll() {
+    batch.nodes.clear();
+    batch.dirty.clear();
+    batch.all = true;
+    marked.clear();
+}
+
+// 父子关系可能变化的节点：增删的节点、脏节点（子树形状变了，孩子指针可能变了）和脏节点现在的孩子
+// （父指针可能变了）。标记只清除本批用过的位置，不随树的大小增长
+TreeLayoutChanges::Batch TreeLayoutChanges::take(const BinaryTreeModel& tree) {
+    batch.root = tree.root();
+    batch.capacity = tree.capacity();
+    if (batch.all) {
+        batch.links.reserve(tree.capacity());
+        for (int id = 0; id < tree.capacity(); ++id) batch.links.push_back(tree.link(id));
+    } else {
+        if (tree.capacity() > 0) ensure(tree, tree.capacity() - 1);
+        auto record = [&](int id) {
+            if (id == npos || (marked[id] & Linked)) return;
+            marked[id] |= Linked;
+            linked.push_back(id);
+            batch.links.push_back(tree.link(id));
+        };
+        for (int id : batch.nodes) record(id >= 0 ? id : ~id);
+        for (int id : batch.dirty) {
+            record(id);
+            if (!tree.isValid(id)) continue;
+            record(tree.left(id));
+            record(tree.right(id));
+        }
+        for (int id : linked) marked[id] = 0;
+        linked.clear();
+    }
+    for (int id : batch.dirty) marked[id] = 0;
+    Batch taken = std::move(batch);
+    batch = Batch();
+    return taken;
+}
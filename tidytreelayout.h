@@ -0,0 +1,136 @@
+#ifndef TIDYTREELAYOUT_H
+#define TIDYTREELAYOUT_H
+
+#include "binarytreemodel.h"
+#include <vector>
+
+// 一次布局的结果，算好后不再修改，可以在线程之间共享
+struct TreeLayoutBuffer {
+    long long generation = 0;   // 提交布局时的编号，用来识别过期的结果
+    std::vector<double> x;      // 按节点编号：节点中心的横坐标
+    std::vector<int>    depth;
+    std::vector<int>    moved;  // 与上一次布局相比坐标或深度变化的节点（含新节点）
+    int    merged = 0;          // 重新合并的节点数
+    double minX = 0, maxX = 0;
+    int    height = -1;         // 最深节点的深度，空树为 -1
+
+    // 概览色块：每层从左到右每若干个节点概括为一块，各层依次排列
+    struct Block {
+        double left, right;     // 块内首尾节点中心的横坐标
+        int    depth;
+    };
+    std::vector<Block> blocks;
+    std::vector<int> changedBlocks;     // 与上一次布局相比内容变化或新增的色块
+
+    // 各层从左到右的节点编号，逐层依次排列；第 d 层为 levels[levelStart[d] .. levelStart[d+1])。
+    // 同一层中横坐标随下标递增，按可见范围二分即可找出落在视口内的节点
+    std::vector<int> levels;
+    std::vector<int> levelStart;
+};
+
+// TreeLayoutChanges 在模型所在的线程中记下一批结构变更，交给另一线程中的 TidyTreeLayout::apply()。
+// 脏路径必须沿事件发生时的父节点链标记（规则与 TidyTreeLayout 的同名函数相同），所以在这里标记好；
+// 取走时再带上这些节点及其孩子当前的父子关系，另一线程中的树副本据此打补丁，不必复制整棵树
+class TreeLayoutChanges
+{
+public:
+    static constexpr int npos = BinaryTreeModel::npos;
+
+    struct Batch {
+        std::vector<int> nodes;     // 按发生顺序：新节点的编号，或按位取反的被删节点编号
+        std::vector<int> dirty;     // 需要重新合并的节点
+        bool all = false;           // 整棵树重新布局，此时忽略 nodes 和 dirty
+        std::vector<BinaryTreeModel::Link> links;   // 取走时结构可能变化的节点，整体重新布局时为所有节点
+        int root = npos;
+        int capacity = 0;
+
+        void append(Batch&& later); // 接上随后的一批
+    };
+
+    void nodeInserted(const BinaryTreeModel& tree, int id);
+    void nodeRemoved(const BinaryTreeModel& tree, int id, int anchor);
+    void invalidate(const BinaryTreeModel& tree, int id);
+    void invalidateAll();
+    bool empty() const { return batch.nodes.empty() && batch.dirty.empty() && !batch.all; }
+    Batch take(const BinaryTreeModel& tree);    // 取走已记下的变更并附上 tree 中相关节点的父子关系，重新开始记录
+
+private:
+    void ensure(const BinaryTreeModel& tree, int id);
+    void markPath(const BinaryTreeModel& tree, int id);
+
+    Batch batch;
+    std::vector<char> marked;   // 按节点编号：本批中已标记为脏（Dirty）、已附上父子关系（Linked）
+    std::vector<int> linked;
+    enum : char { Dirty = 1, Linked = 2 };
+};
+
+// TidyTreeLayout 是不依赖 Qt 的二叉树整齐布局（Reingold–Tilford 算法），适用于任意形状的二叉树：
+// 每个节点只保存相对父节点的横向偏移；合并左右子树时沿左子树的右轮廓和右子树的左轮廓同时向下走，
+// 求出两棵子树在每一层都不小于 separation 的最小间距，父节点位于两个孩子正中。
+// 轮廓用“线索”连接：较矮子树最底层的端点指向较高子树下一层的轮廓节点，沿轮廓行走不需要遍历整棵子树。
+//
+// 布局是增量的：插入、删除或旋转只把变化处到根的路径标记为脏，update() 只重新合并这些节点的轮廓，
+// 其余子树的偏移和线索保持不变。绝对坐标由偏移累加得到，只沿位置变化的节点向下传播，
+// moved() 给出本次位置变化的节点，视图只需移动这些节点的图元。
+// 布局也可以放在另一线程中（见 TreeLayoutWorker）：模型所在的线程用 TreeLayoutChanges 记录变更，由 apply() 应用。
+// 纵坐标为深度，横坐标以根节点为 0，单位与 separation 相同。
+class TidyTreeLayout
+{
+public:
+    static constexpr int npos = BinaryTreeModel::npos;
+
+    explicit TidyTreeLayout(const BinaryTreeModel& tree, double separation = 1.0);
+
+    void nodeInserted(int id);              // 新节点已挂到树上
+    void nodeRemoved(int id, int anchor);   // 节点已删除，anchor 为结构变化的最深节点（删除叶子时即父节点）
+    void invalidate(int id);                // 节点绕父节点旋转下移后调用，重新合并它到根的路径
+    void invalidateAll();                   // 整棵树重新布局
+    void clear();
+    // 应用另一线程中记下的一批变更，调用前所属的树已替换为变更之后的副本
+    void apply(const TreeLayoutChanges::Batch& changes);
+
+    // 重新合并所有脏节点并刷新绝对坐标，返回重新合并的节点数
+    int  update();
+
+    double x(int id) const { return m_x[id]; }
+    int    depth(int id) const { return m_depth[id]; }
+    double minX() const { return m_minX; }
+    double maxX() const { return m_maxX; }
+    int    height() const { return m_height; }     // 最深节点的深度，空树为 -1
+    const std::vector<int>& moved() const { return m_moved; }  // 上次 update() 中坐标或深度变化的节点（含新节点）
+    void copyTo(TreeLayoutBuffer& out) const;   // 复制坐标、包围范围和 moved()
+
+private:
+    void ensure(int id);
+    void resetNode(int id);     // 新节点：清掉复用编号的旧状态
+    void unlinkNode(int id);    // 被删节点：撤销它设置和收到的线索
+    void markPath(int id);
+    void merge(int v);
+    int  nextLeft(int v, double& offset) const;     // 左轮廓的下一层节点，offset 累加其相对横坐标
+    int  nextRight(int v, double& offset) const;    // 右轮廓的下一层节点
+    void place();
+
+    const BinaryTreeModel& tree;
+    double separation;
+
+    // 以下数组都按节点编号索引
+    std::vector<double> offset;         // 相对父节点的横向偏移
+    std::vector<int>    thread;         // 轮廓线索：没有孩子的节点指向下一层的轮廓节点
+    std::vector<double> threadOffset;   // 线索目标相对本节点的横向偏移
+    std::vector<int>    threadSource;   // 本节点合并时设置的线索所在的节点，重新合并前需撤销
+    // 子树最底层的最左、最右节点及其相对子树根的偏移，合并时用来设置线索
+    std::vector<int>    leftExtreme, rightExtreme;
+    std::vector<double> leftExtremeOffset, rightExtremeOffset;
+    std::vector<int>    subtreeHeight;
+    std::vector<char>   dirty;
+    bool anyDirty = false;
+
+    std::vector<double> m_x;
+    std::vector<int>    m_depth;
+    std::vector<int>    m_moved;
+    double m_minX = 0, m_maxX = 0;
+    int    m_height = -1;
+    std::vector<int>    stack;          // 遍历用的显式栈，跨调用复用
+};
+
+#endif
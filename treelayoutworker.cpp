@@ -0,0 +1,104 @@
+#include "treelayoutworker.h"
+#include <algorithm>
+#include <utility>
+
+TreeLayoutWorker::TreeLayoutWorker(double separation, Ready ready)
+    : layout(tree, separation), ready(std::move(ready)), thread([this]() { run(); })
+{
+}
+
+TreeLayoutWorker::~TreeLayoutWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+void TreeLayoutWorker::submit(long long generation, TreeLayoutChanges::Batch changes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (pending) pendingChanges.append(std::move(changes));
+        else pendingChanges = std::move(changes);
+        pendingGeneration = generation;
+        pending = true;
+    }
+    wake.notify_one();
+}
+
+// 取走最新的提交后解锁计算，计算期间到达的提交留到下一轮合并处理
+void TreeLayoutWorker::run() {
+    for (;;) {
+        TreeLayoutChanges::Batch changes;
+        auto result = std::make_shared<TreeLayoutBuffer>();
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return pending || stopping; });
+            if (stopping) return;
+            changes = std::move(pendingChanges);
+            pendingChanges = TreeLayoutChanges::Batch();
+            result->generation = pendingGeneration;
+            pending = false;
+        }
+        tree.applyLinks(changes.links, changes.root, changes.capacity);
+        layout.apply(changes);
+        result->merged = layout.update();
+        layout.copyTo(*result);
+        // 整体重新布局前调用方已清空概览，所有色块都算作变化；没有节点重新合并时结构和坐标都没变，
+        // 沿用上一次的色块和各层顺序
+        if (changes.all) lastResult.reset();
+        if (result->merged > 0 || !lastResult) {
+            summarize(tree, lastResult ? lastResult->blocks : std::vector<TreeLayoutBuffer::Block>(), *result);
+        } else {
+            result->blocks = lastResult->blocks;
+            result->levels = lastResult->levels;
+            result->levelStart = lastResult->levelStart;
+        }
+        lastResult = result;
+        ready(std::move(result));
+    }
+}
+
+std::shared_ptr<const TreeLayoutBuffer> TreeLayoutWorker::layoutWhole(const BinaryTreeModel& tree, double separation) {
+    TidyTreeLayout layout(tree, separation);
+    layout.invalidateAll();
+    auto result = std::make_shared<TreeLayoutBuffer>();
+    result->merged = layout.update();
+    layout.copyTo(*result);
+    summarize(tree, {}, *result);
+    return result;
+}
+
+void TreeLayoutWorker::summarize(const BinaryTreeModel& tree, const std::vector<TreeLayoutBuffer::Block>& previous,
+                                 TreeLayoutBuffer& out) {
+    out.blocks.clear();
+    out.changedBlocks.clear();
+    // 逐层广度优先：先左后右地追加孩子，每层自然按从左到右排列
+    std::vector<int>& order = out.levels;
+    order.clear();
+    order.reserve(tree.size());
+    out.levelStart.clear();
+    if (tree.root() != BinaryTreeModel::npos) order.push_back(tree.root());
+    for (size_t begin = 0, depth = 0; begin < order.size(); ++depth) {
+        size_t end = order.size();
+        out.levelStart.push_back(static_cast<int>(begin));
+        for (size_t first = begin; first < end; first += OverviewGroup) {
+            size_t last = std::min(first + OverviewGroup, end) - 1;
+            out.blocks.push_back(TreeLayoutBuffer::Block{out.x[order[first]], out.x[order[last]], int(depth)});
+        }
+        for (size_t k = begin; k < end; ++k) {
+            int v = order[k];
+            if (tree.left(v) != BinaryTreeModel::npos) order.push_back(tree.left(v));
+            if (tree.right(v) != BinaryTreeModel::npos) order.push_back(tree.right(v));
+        }
+        begin = end;
+    }
+    out.levelStart.push_back(static_cast<int>(order.size()));
+    for (size_t i = 0; i < out.blocks.size(); ++i) {
+        const TreeLayoutBuffer::Block& b = out.blocks[i];
+        if (i >= previous.size() || previous[i].left != b.left || previous[i].right != b.right
+            || previous[i].depth != b.depth)
+            out.changedBlocks.push_back(static_cast<int>(i));
+    }
+}
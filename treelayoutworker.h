@@ -0,0 +1,55 @@
+#ifndef TREELAYOUTWORKER_H
+#define TREELAYOUTWORKER_H
+
+#include "binarytreemodel.h"
+#include "tidytreelayout.h"
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// TreeLayoutWorker 在自己的线程中维护树的副本和一份 TidyTreeLayout，增量布局不占用模型所在的线程。
+// 每次提交一批 TreeLayoutChanges，其中带着结构可能变化的节点的父子关系，副本据此打补丁后增量布局；
+// 还没开始计算的提交会被下一次提交合并（变更按顺序接上），过期的任务因此不会执行。
+// 每算完一次，把坐标和概览色块作为不可变的 TreeLayoutBuffer 交给回调，回调在工作线程中调用
+class TreeLayoutWorker
+{
+public:
+    using Ready = std::function<void(std::shared_ptr<const TreeLayoutBuffer>)>;
+
+    static constexpr int OverviewGroup = 64;    // 概览中每层每 64 个节点概括为一个色块
+
+    TreeLayoutWorker(double separation, Ready ready);
+    ~TreeLayoutWorker();    // 等进行中的计算结束后退出，不再调用回调
+
+    TreeLayoutWorker(const TreeLayoutWorker&) = delete;
+    TreeLayoutWorker& operator=(const TreeLayoutWorker&) = delete;
+
+    // generation 原样写入结果，供调用方识别过期的结果
+    void submit(long long generation, TreeLayoutChanges::Batch changes);
+
+    // 在调用线程中一次布局整棵树，所有色块都算作变化，用于整体换入的树
+    static std::shared_ptr<const TreeLayoutBuffer> layoutWhole(const BinaryTreeModel& tree, double separation);
+
+private:
+    void run();
+    // 按层列出节点并概括色块，与 previous 比较得出变化的色块
+    static void summarize(const BinaryTreeModel& tree, const std::vector<TreeLayoutBuffer::Block>& previous,
+                          TreeLayoutBuffer& out);
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool pending = false;
+    bool stopping = false;
+    long long pendingGeneration = 0;
+    TreeLayoutChanges::Batch pendingChanges;
+
+    BinaryTreeModel tree;   // 布局所用的副本，只在工作线程中访问
+    TidyTreeLayout layout;
+    std::shared_ptr<const TreeLayoutBuffer> lastResult;   // 上一次的结果，没有节点重新合并时沿用其中的色块和各层顺序
+    Ready ready;
+    std::thread thread;     // 最后启动，此前的成员都已构造
+};
+
+#endif
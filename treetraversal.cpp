@@ -0,0 +1,124 @@
+#include "treetraversal.h"
+#include <algorithm>
+
+namespace {
+constexpr int npos = BinaryTreeModel::npos;
+}
+
+std::unique_ptr<TraversalCursor> makeTraversal(BinaryTreeModel& tree, TraversalOrder order) {
+    switch (order) {
+    case TraversalOrder::Preorder:       return std::make_unique<PreorderCursor>(tree);
+    case TraversalOrder::Inorder:        return std::make_unique<InorderCursor>(tree);
+    case TraversalOrder::Postorder:      return std::make_unique<PostorderCursor>(tree);
+    case TraversalOrder::Levelorder:     return std::make_unique<LevelorderCursor>(tree);
+    case TraversalOrder::MorrisInorder:  return std::make_unique<MorrisCursor>(tree, false);
+    case TraversalOrder::MorrisPreorder: return std::make_unique<MorrisCursor>(tree, true);
+    }
+    return nullptr;
+}
+
+// 前序：弹出即访问，先压右孩子再压左孩子
+PreorderCursor::PreorderCursor(const BinaryTreeModel& tree) : tree(tree) {
+    if (tree.root() != npos) stack.push_back(tree.root());
+}
+
+bool PreorderCursor::next(int& id) {
+    if (stack.empty()) return false;
+    id = stack.back();
+    stack.pop_back();
+    if (tree.right(id) != npos) stack.push_back(tree.right(id));
+    if (tree.left(id) != npos) stack.push_back(tree.left(id));
+    return true;
+}
+
+// 中序：沿左链压栈到底，弹出访问后转向右子树
+InorderCursor::InorderCursor(const BinaryTreeModel& tree) : tree(tree), cur(tree.root()) {}
+
+bool InorderCursor::next(int& id) {
+    while (cur != npos) {
+        stack.push_back(cur);
+        cur = tree.left(cur);
+    }
+    if (stack.empty()) return false;
+    id = stack.back();
+    stack.pop_back();
+    cur = tree.right(id);
+    return true;
+}
+
+// 后序：单栈 + 上一个访问的节点，右子树访问完后才访问栈顶
+PostorderCursor::PostorderCursor(const BinaryTreeModel& tree) : tree(tree), cur(tree.root()) {}
+
+bool PostorderCursor::next(int& id) {
+    while (cur != npos || !stack.empty()) {
+        if (cur != npos) {
+            stack.push_back(cur);
+            cur = tree.left(cur);
+            continue;
+        }
+        int top = stack.back();
+        int r = tree.right(top);
+        if (r != npos && r != last) {
+            cur = r;
+        } else {
+            stack.pop_back();
+            last = id = top;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 层序：队列
+LevelorderCursor::LevelorderCursor(const BinaryTreeModel& tree) : tree(tree) {
+    if (tree.root() != npos) queue.push_back(tree.root());
+}
+
+bool LevelorderCursor::next(int& id) {
+    if (queue.empty()) return false;
+    id = queue.front();
+    queue.pop_front();
+    if (tree.left(id) != npos) queue.push_back(tree.left(id));
+    if (tree.right(id) != npos) queue.push_back(tree.right(id));
+    return true;
+}
+
+// Morris：把左子树最右节点（中序前驱）的右链接临时指回当前节点，
+// 第二次到达当前节点时拆除线索，整个过程不需要栈
+MorrisCursor::MorrisCursor(BinaryTreeModel& tree, bool preorder)
+    : tree(tree), preorder(preorder), cur(tree.root()) {}
+
+MorrisCursor::~MorrisCursor() {
+    for (int pred : threads) tree.m_right[pred] = npos;
+}
+
+bool MorrisCursor::next(int& id) {
+    auto& right = tree.m_right;
+    while (cur != npos) {
+        int l = tree.left(cur);
+        if (l == npos) {
+            id = cur;
+            cur = right[cur];   // 可能沿线索回到祖先
+            return true;
+        }
+        int pred = l;
+        while (right[pred] != npos && right[pred] != cur) pred = right[pred];
+        if (right[pred] == npos) {
+            // 第一次到达：建立线索，进入左子树
+            right[pred] = cur;
+            threads.push_back(pred);
+            int visit = cur;
+            cur = l;
+            if (preorder) { id = visit; return true; }
+        } else {
+            // 第二次到达：左子树已走完，拆除线索
+            right[pred] = npos;
+            auto it = std::find(threads.rbegin(), threads.rend(), pred);
+            if (it != threads.rend()) threads.erase(std::next(it).base());
+            int visit = cur;
+            cur = right[cur];
+            if (!preorder) { id = visit; return true; }
+        }
+    }
+    return false;
+}
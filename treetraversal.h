@@ -0,0 +1,91 @@
+#ifndef TREETRAVERSAL_H
+#define TREETRAVERSAL_H
+
+#include "binarytreemodel.h"
+#include <deque>
+#include <memory>
+#include <vector>
+
+// 遍历顺序
+enum class TraversalOrder {
+    Preorder,       // 前序（显式栈）
+    Inorder,        // 中序（显式栈）
+    Postorder,      // 后序（显式栈）
+    Levelorder,     // 层序（队列）
+    MorrisInorder,  // Morris 中序（线索化，不使用栈）
+    MorrisPreorder, // Morris 前序（线索化，不使用栈）
+};
+
+// TraversalCursor 是惰性遍历器：每次调用 next() 产生下一个被访问的节点，
+// 不预先生成整个访问序列，也不使用递归，退化成链的深树也不会栈溢出。
+// 自定义遍历顺序只需继承它并实现 next()。
+class TraversalCursor
+{
+public:
+    virtual ~TraversalCursor() = default;
+    virtual bool next(int& id) = 0;     // 取下一个访问的节点编号，遍历结束时返回 false
+};
+
+// 按顺序创建遍历器。Morris 遍历在进行中会临时改写节点池的右孩子链接（线索），
+// 遍历结束或遍历器销毁时恢复；期间不要读取右孩子或修改树的结构
+std::unique_ptr<TraversalCursor> makeTraversal(BinaryTreeModel& tree, TraversalOrder order);
+
+// 以下为各顺序的实现
+
+class PreorderCursor : public TraversalCursor
+{
+public:
+    explicit PreorderCursor(const BinaryTreeModel& tree);
+    bool next(int& id) override;
+private:
+    const BinaryTreeModel& tree;
+    std::vector<int> stack;
+};
+
+class InorderCursor : public TraversalCursor
+{
+public:
+    explicit InorderCursor(const BinaryTreeModel& tree);
+    bool next(int& id) override;
+private:
+    const BinaryTreeModel& tree;
+    std::vector<int> stack;
+    int cur;
+};
+
+class PostorderCursor : public TraversalCursor
+{
+public:
+    explicit PostorderCursor(const BinaryTreeModel& tree);
+    bool next(int& id) override;
+private:
+    const BinaryTreeModel& tree;
+    std::vector<int> stack;
+    int cur;
+    int last = BinaryTreeModel::npos;   // 上一个访问的节点，用来判断右子树是否已访问
+};
+
+class LevelorderCursor : public TraversalCursor
+{
+public:
+    explicit LevelorderCursor(const BinaryTreeModel& tree);
+    bool next(int& id) override;
+private:
+    const BinaryTreeModel& tree;
+    std::deque<int> queue;
+};
+
+class MorrisCursor : public TraversalCursor
+{
+public:
+    MorrisCursor(BinaryTreeModel& tree, bool preorder);
+    ~MorrisCursor() override;   // 提前结束时拆除剩余的线索
+    bool next(int& id) override;
+private:
+    BinaryTreeModel& tree;
+    bool preorder;
+    int cur;
+    std::vector<int> threads;   // 当前存在的线索（前驱节点编号），只用于提前结束时恢复
+};
+
+#endif
@@ -1,24 +1,29 @@
 #include "TreeTraversalWidget.h"
+#include "animationscheduler.h"
+#include "NodeItem.h"
+#include "nodeitempool.h"
+#include "pathlogmodel.h"
+#include "oplogbar.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
-#include <QGraphicsEllipseItem>
-#include <QGraphicsTextItem>
-#include <QGraphicsLineItem>
+#include <QScrollBar>
 #include <QPen>
 #include <QMessageBox>
-#include <QTimer>
 #include <QShowEvent>
+#include <QResizeEvent>
+#include <algorithm>
 #include <cmath>
 
 // 构造函数，初始化UI组件，布局，按钮连接信号槽
 TreeTraversalWidget::TreeTraversalWidget(QWidget* parent)
-    : QWidget(parent)
+    : QWidget(parent), traversalChannel(AnimationScheduler::instance().newChannel())
 {
     auto *vlay = new QVBoxLayout(this);
     auto *hlay = new QHBoxLayout;
 
     // 初始化视图和场景
     scene    = new QGraphicsScene(this);
+    pool     = std::make_unique<NodeItemPool>(scene);
     mainView = new QGraphicsView(scene,this);
     mainView->setRenderHint(QPainter::Antialiasing);
     mainView->setDragMode(QGraphicsView::ScrollHandDrag);
@@ -40,17 +45,41 @@ TreeTraversalWidget::TreeTraversalWidget(QWidget* parent)
     btnIn    = new QPushButton("中序遍历", this);
     btnPost  = new QPushButton("后序遍历", this);
     btnLevel = new QPushButton("层序遍历", this);
+    btnMorris = new QPushButton("Morris中序", this);
+    sizeSpin = new QSpinBox(this);
+    sizeSpin->setRange(1, 2000000);
+    sizeSpin->setValue(15);
+    sizeSpin->setPrefix("节点数 ");
+    btnLoad  = new QPushButton("生成", this);
     auto *btnLay = new QHBoxLayout;
+    btnLay->addWidget(sizeSpin);
+    btnLay->addWidget(btnLoad);
     btnLay->addWidget(btnPre);
     btnLay->addWidget(btnIn);
     btnLay->addWidget(btnPost);
     btnLay->addWidget(btnLevel);
+    btnLay->addWidget(btnMorris);
     vlay->addLayout(btnLay);
 
+    // 操作日志只记录载入树和开始遍历，回放时交给本控件执行
+    opBar = new OpLogBar(nullptr, this);
+    opBar->setTreeHandlers({
+        [this](int n) { sizeSpin->setValue(n); loadCompleteTree(n); },
+        [this](int order) { highlightTraversal(static_cast<TraversalOrder>(order)); },
+        [this]() { return tree.size(); },
+    });
+    vlay->addWidget(opBar);
+
     // 初始化文本框用于显示路径
-    pathLog = new QTextEdit(this);
-    pathLog->setReadOnly(true);
-    pathLog->setPlaceholderText("遍历路径将在此显示");
+    pathLabel = new QLabel("遍历路径将在此显示", this);
+    pathLabel->setTextFormat(Qt::PlainText);
+    vlay->addWidget(pathLabel);
+    pathModel = new PathLogModel([this](int id) { return formatPath(id); }, this);
+    pathLog = new QListView(this);
+    pathLog->setModel(pathModel);
+    pathLog->setUniformItemSizes(true);     // 行高一致，滚动和追加都不需要逐行测量
+    pathLog->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    pathLog->setSelectionMode(QAbstractItemView::NoSelection);
     vlay->addWidget(pathLog);
 
     // 信号槽连接
@@ -58,164 +87,263 @@ TreeTraversalWidget::TreeTraversalWidget(QWidget* parent)
     connect(btnIn,    &QPushButton::clicked, this, &TreeTraversalWidget::onInorder);
     connect(btnPost,  &QPushButton::clicked, this, &TreeTraversalWidget::onPostorder);
     connect(btnLevel, &QPushButton::clicked, this, &TreeTraversalWidget::onLevelorder);
+    connect(btnMorris, &QPushButton::clicked, this, &TreeTraversalWidget::onMorrisInorder);
+    connect(btnLoad,  &QPushButton::clicked, this, &TreeTraversalWidget::onLoad);
 
-    // 构建和布局二叉树
-    buildBinaryTree();
-    layoutBinaryTree();
+    // 平移、缩放视图时按需创建视口内的节点图元
+    connect(mainView->horizontalScrollBar(), &QScrollBar::valueChanged, this, &TreeTraversalWidget::materializeVisible);
+    connect(mainView->verticalScrollBar(),   &QScrollBar::valueChanged, this, &TreeTraversalWidget::materializeVisible);
+
+    edges = new EdgeLayerItem;  // 所有连线由一个图元批量绘制
+    edges->setZValue(-1);
+    scene->addItem(edges);
+
+    // 默认构建 15 个节点的完全二叉树
+    loadCompleteTree(sizeSpin->value());
+}
+
+TreeTraversalWidget::~TreeTraversalWidget() {
+    opBar->stop();
+    stopTraversal();
 }
 
 // 重写showEvent方法，显示时调整视图和缩略图的显示区域
 void TreeTraversalWidget::showEvent(QShowEvent* ev) {
     QWidget::showEvent(ev);
-    QRectF br = scene->itemsBoundingRect();
-    scene->setSceneRect(br.adjusted(-20,-20,20,20));  // 调整场景矩形边界
-    thumbView->fitInView(br, Qt::KeepAspectRatio);     // 调整缩略图适配
-}
-
-// 构建二叉树，创建节点并建立父子关系
-void TreeTraversalWidget::buildBinaryTree() {
-    for (int i = 1; i <= 15; ++i) {
-        nodes[i] = new TreeNode{i};
-        nodes[i]->circle = new QGraphicsEllipseItem(0,0,40,40);
-        nodes[i]->circle->setBrush(Qt::blue);   // 设置节点颜色为蓝色
-        nodes[i]->circle->setPen(QPen(Qt::black,2));  // 设置边框颜色为黑色
-        scene->addItem(nodes[i]->circle);
-        nodes[i]->label = new QGraphicsTextItem(QString::number(i), nodes[i]->circle);
-        QFont f; f.setPointSize(14); f.setBold(true);  // 设置字体样式
-        nodes[i]->label->setFont(f);
-        nodes[i]->label->setDefaultTextColor(Qt::white);  // 字体颜色为白色
-        nodes[i]->label->setPos((40-nodes[i]->label->boundingRect().width())/2,
-                                (40-nodes[i]->label->boundingRect().height())/2);
-        nodes[i]->label->setZValue(1);
-    }
-    root = nodes[1];
-    // 设定节点的父子关系
-    for (int i = 1; i <= 7; ++i) {
-        nodes[i]->left  = nodes[2*i]; nodes[2*i]->parent = nodes[i];
-        nodes[i]->right = nodes[2*i+1]; nodes[2*i+1]->parent = nodes[i];
-    }
+    thumbView->fitInView(scene->sceneRect(), Qt::KeepAspectRatio);     // 调整缩略图适配
+    materializeVisible();
+}
+
+void TreeTraversalWidget::resizeEvent(QResizeEvent* ev) {
+    QWidget::resizeEvent(ev);
+    materializeVisible();
+}
+
+// 载入任意规模的完全二叉树：节点一次性追加到节点池，不创建任何图元
+void TreeTraversalWidget::loadCompleteTree(int nodeCount) {
+    stopTraversal();    // 先拆除 Morris 线索再清空节点池
+    clearVisuals();
+    resetPath();        // 按旧节点池的编号清理路径栈
+    tree.clear();
+    tree.appendLevelOrder(nodeCount);   // 新节点池中节点编号与层序槽位一致
+    opBar->recorder().treeLoaded(nodeCount);
+    visited.assign(nodeCount, 0);
+    stackDepth.assign(tree.capacity(), -1);
+    layoutBinaryTree();
+    mainView->centerOn(slotPos(0) + QPointF(20, 20));
+    thumbView->fitInView(scene->sceneRect(), Qt::KeepAspectRatio);
+    materializeVisible();
+}
+
+void TreeTraversalWidget::onLoad() {
+    loadCompleteTree(sizeSpin->value());
 }
 
-// 布局二叉树，确定每个节点的显示位置
+// 布局二叉树：每层节点等分布局宽度，宽度随最底层的节点数增长，保证节点不重叠
 void TreeTraversalWidget::layoutBinaryTree() {
-    constexpr int W=800, gapY=100;
-    QRectF rect(0,0,W,gapY*4);
-    for (int i = 1; i <= 15; ++i) {
-        int lvl = int(std::floor(std::log2(i)));
-        int idx = i - ((1<<lvl)-1), cnt=1<<lvl;
-        qreal x = W*(idx/(qreal)(cnt+1)) - 20;  // 计算节点的x位置
-        qreal y = lvl*gapY;                      // 计算节点的y位置
-        nodes[i]->circle->setPos(x,y);
+    constexpr qreal gapY = 100, minLeafGap = 50;
+    int n = tree.size();
+    levels = 0;
+    while (levels < 31 && (1LL << levels) - 1 < n) ++levels;
+    qreal leaves = levels > 0 ? qreal(1LL << (levels - 1)) : 1;
+    layoutWidth = std::max<qreal>(800, leaves * minLeafGap);
+    QRectF br(0, 0, layoutWidth, std::max(1, levels) * gapY);
+    scene->setSceneRect(br.adjusted(-20,-20,20,20));
+}
+
+// 第 slot 个槽位节点的左上角坐标
+QPointF TreeTraversalWidget::slotPos(int slot) const {
+    constexpr qreal gapY = 100;
+    int lvl = 0;
+    while ((2LL << lvl) - 1 <= slot) ++lvl;
+    long long idx = slot - ((1LL << lvl) - 1) + 1, cnt = 1LL << lvl;
+    qreal x = layoutWidth * (idx / qreal(cnt + 1)) - 20;  // 计算节点的x位置
+    qreal y = lvl * gapY;                                  // 计算节点的y位置
+    return QPointF(x, y);
+}
+
+// 为视口（外扩一圈）内的节点创建图元，回收已离开视口的图元。
+// 每层可见的槽位区间直接由坐标公式反推，只访问可见节点
+void TreeTraversalWidget::materializeVisible() {
+    constexpr qreal gapY = 100, margin = 100;
+    QRectF vis = mainView->mapToScene(mainView->viewport()->rect()).boundingRect()
+                     .adjusted(-margin, -margin, margin, margin);
+    int n = tree.size();
+    int pass = ++materializePass;
+    int budget = materializeBudget;
+    bool changed = false;
+
+    for (int lvl = 0; lvl < levels && budget > 0; ++lvl) {
+        qreal y = lvl * gapY;
+        if (y + 40 < vis.top() || y > vis.bottom()) continue;
+        long long first = (1LL << lvl) - 1, cnt = 1LL << lvl;
+        // x = W*(idx+1)/(cnt+1) - 20，要求 x+40 >= left 且 x <= right
+        long long lo = (long long)std::ceil((vis.left() - 20) * (cnt + 1) / layoutWidth) - 1;
+        long long hi = (long long)std::floor((vis.right() + 20) * (cnt + 1) / layoutWidth) - 1;
+        lo = std::max(0LL, lo);
+        hi = std::min({hi, cnt - 1, n - 1 - first});
+        for (long long idx = lo; idx <= hi && budget > 0; ++idx, --budget) {
+            int id = int(first + idx);
+            auto found = visuals.find(id);
+            if (found != visuals.end()) { found->second.pass = pass; continue; }
+            NodeItem* item = pool->acquire(tree.value(id));    // 优先复用离开视口时回收的图元
+            item->setPos(slotPos(id));
+            visuals.emplace(id, Visual{item, -1, pass});
+            changed = true;
+        }
     }
-    constexpr qreal R=20;
-    for (int i = 1; i <= 7; ++i) {
-        auto *p=nodes[i];
-        for (auto *c: {p->left,p->right}) {
-            QPointF pc = p->circle->pos()+QPointF(R,R);
-            QPointF cc = c->circle->pos()+QPointF(R,R);
+
+    // 回收本轮不可见的图元：隐藏后留在场景中，平移回来时直接复用
+    for (auto it = visuals.begin(); it != visuals.end(); ) {
+        if (it->second.pass == pass) { ++it; continue; }
+        pool->release(it->second.item);
+        it = visuals.erase(it);
+        changed = true;
+    }
+    if (!changed) return;
+
+    // 重建可见节点的连线，并恢复遍历高亮状态
+    constexpr qreal R = 20;
+    edges->clear();
+    edges->reserve(materializedCount());
+    for (auto& [id, v] : visuals) {
+        int p = tree.parent(id);
+        v.edgeIndex = -1;
+        if (p != BinaryTreeModel::npos) {
+            QPointF pc = slotPos(p) + QPointF(R,R);
+            QPointF cc = slotPos(id) + QPointF(R,R);
             qreal ang = std::atan2(cc.y()-pc.y(), cc.x()-pc.x());  // 计算角度
             QPointF pEdge=pc+QPointF(std::cos(ang)*R,std::sin(ang)*R);
             QPointF cEdge=cc-QPointF(std::cos(ang)*R,std::sin(ang)*R);
-            auto *line=new QGraphicsLineItem(QLineF(pEdge,cEdge));
-            line->setPen(QPen(Qt::black,2));  // 设置连线颜色为黑色
-            scene->addItem(line);
-            c->parentEdge=line;
+            v.edgeIndex = edges->addEdge(pEdge, cEdge, 0);
         }
+        applyVisited(id, v);
     }
-    QRectF br = scene->itemsBoundingRect();
-    scene->setSceneRect(br.adjusted(-20,-20,20,20));
+}
+
+// 按遍历状态设置节点和连线的颜色：已访问的节点为黄底黑字，连线为红色
+void TreeTraversalWidget::applyVisited(int id, const Visual& v) {
+    bool on = visited[id];
+    v.item->setColors(on ? QColor(Qt::yellow) : QColor(Qt::blue), on ? QColor(Qt::black) : QColor(Qt::white));
+    if (v.edgeIndex >= 0) edges->setEdgeFlags(v.edgeIndex, on ? EdgeLayerItem::Highlight : 0);
+}
+
+void TreeTraversalWidget::clearVisuals() {
+    for (auto& [id, v] : visuals) {
+        pool->release(v.item);
+    }
+    visuals.clear();
+    edges->clear();
 }
 
 // 重置节点和路径的视觉效果
 void TreeTraversalWidget::resetVisuals() {
-    for (int i = 1; i <= 15; ++i) {
-        nodes[i]->circle->setBrush(Qt::blue);  // 恢复节点颜色为蓝色
-        if (nodes[i]->parentEdge) nodes[i]->parentEdge->setPen(QPen(Qt::black,2));  // 恢复连线颜色为黑色
-    }
-    pathLog->clear();  // 清空路径日志
+    std::fill(visited.begin(), visited.end(), 0);
+    for (auto& [id, v] : visuals) applyVisited(id, v);  // 恢复节点颜色为蓝色、连线为黑色
+    resetPath();  // 清空路径日志
 }
 
-// 高亮显示遍历过程中的节点和边
-void TreeTraversalWidget::highlightTraversal() {
+// 高亮显示遍历过程中的节点和边：由调度器每隔 traversalDelayMs 推进一步，
+// 每一步向遍历器取下一个节点，不预先生成整个访问序列；开始新遍历时先取消上一次尚未执行的步骤
+void TreeTraversalWidget::highlightTraversal(TraversalOrder order) {
+    auto& scheduler = AnimationScheduler::instance();
+    stopTraversal();
     resetVisuals();
-    int step = 0;
-    for (TreeNode* tn : visitOrder) {
-        QTimer::singleShot(traversalDelayMs * step, [this, tn]() {
-            // 节点变色为黄色
-            tn->circle->setBrush(Qt::yellow);
-            // 边变色为红色
-            if (tn->parentEdge)
-                tn->parentEdge->setPen(QPen(Qt::red,2));
-            // 序号文字改为黑色，确保可见
-            tn->label->setDefaultTextColor(Qt::black);
-            // 更新路径输出
-            QStringList path;
-            for (TreeNode* p = tn; p; p = p->parent)
-                path.prepend(QString::number(p->id));
-            pathLog->append(path.join(" -> "));
-        });
-        ++step;
-    }
-    QTimer::singleShot(traversalDelayMs * visitOrder.size(), [this]() {
-        QMessageBox::information(this, "提示", "遍历结束");
+    opBar->recorder().traversalStarted(static_cast<int>(order));
+    cursor = makeTraversal(tree, order);
+    scheduler.every(traversalChannel, traversalDelayMs, [this]() {
+        int id;
+        if (!cursor->next(id)) {
+            cursor.reset();
+            // 在事件循环中弹出提示，避免在调度器的帧回调里运行模态对话框
+            QMetaObject::invokeMethod(this, [this]() {
+                QMessageBox::information(this, "提示", "遍历结束");
+            }, Qt::QueuedConnection);
+            return false;
+        }
+        // 节点变黄、边变红；尚未创建图元的节点在进入视口时按状态着色
+        visited[id] = 1;
+        auto found = visuals.find(id);
+        if (found != visuals.end()) applyVisited(id, found->second);
+        // 更新路径输出：当前路径增量更新，日志只追加节点编号
+        advancePath(id);
+        pathLabel->setText(pathText);
+        pathModel->append(id);
+        pathLog->scrollToBottom();
+        return true;
     });
 }
 
+// 把当前路径更新为根到 id 的路径：从 id 向上找到仍在栈中的祖先，
+// 弹出该祖先以下的部分，再压入沿途的节点。代价与两条路径的差异成正比，
+// 前序/中序/后序中相邻两次访问的路径通常只差一两个节点
+void TreeTraversalWidget::advancePath(int id) {
+    std::vector<int> pushes;
+    int p = id;
+    while (p != BinaryTreeModel::npos && stackDepth[p] < 0) {
+        pushes.push_back(p);
+        p = tree.parent(p);
+    }
+    size_t keep = p == BinaryTreeModel::npos ? 0 : stackDepth[p] + 1;
+    if (keep < pathStack.size()) pathText.truncate(pathOffsets[keep]);
+    while (pathStack.size() > keep) {
+        stackDepth[pathStack.back()] = -1;
+        pathStack.pop_back();
+        pathOffsets.pop_back();
+    }
+    for (auto it = pushes.rbegin(); it != pushes.rend(); ++it) {
+        pathOffsets.push_back(pathText.size());
+        if (!pathStack.empty()) pathText += " -> ";
+        pathText += QString::number(tree.value(*it));
+        stackDepth[*it] = static_cast<int>(pathStack.size());
+        pathStack.push_back(*it);
+    }
+}
+
+void TreeTraversalWidget::resetPath() {
+    for (int id : pathStack) stackDepth[id] = -1;
+    pathStack.clear();
+    pathOffsets.clear();
+    pathText.clear();
+    pathLabel->setText("遍历路径将在此显示");
+    pathModel->clear();
+}
+
+// 日志行的文本在绘制时生成，每次只有可见的几十行需要沿父链回溯
+QString TreeTraversalWidget::formatPath(int id) const {
+    QStringList path;
+    for (int p = id; p != BinaryTreeModel::npos; p = tree.parent(p))
+        path.prepend(QString::number(tree.value(p)));
+    return path.join(" -> ");
+}
+
+// 取消进行中的遍历；销毁遍历器时 Morris 遍历留下的线索随之拆除
+void TreeTraversalWidget::stopTraversal() {
+    AnimationScheduler::instance().cancel(traversalChannel);
+    cursor.reset();
+}
+
 // 前序遍历的槽函数
 void TreeTraversalWidget::onPreorder() {
-    visitOrder.clear();
-    dfsPre(root);  // 执行前序遍历
-    highlightTraversal();
+    highlightTraversal(TraversalOrder::Preorder);
 }
 
 // 中序遍历的槽函数
 void TreeTraversalWidget::onInorder() {
-    visitOrder.clear();
-    dfsIn(root);   // 执行中序遍历
-    highlightTraversal();
+    highlightTraversal(TraversalOrder::Inorder);
 }
 
 // 后序遍历的槽函数
 void TreeTraversalWidget::onPostorder() {
-    visitOrder.clear();
-    dfsPost(root); // 执行后序遍历
-    highlightTraversal();
+    highlightTraversal(TraversalOrder::Postorder);
 }
 
 // 层序遍历的槽函数
 void TreeTraversalWidget::onLevelorder() {
-    visitOrder.clear();
-    std::queue<TreeNode*> q;
-    if (root) q.push(root);
-    while (!q.empty()) {
-        TreeNode* n = q.front(); q.pop();
-        visitOrder.push_back(n);
-        if (n->left)  q.push(n->left);
-        if (n->right) q.push(n->right);
-    }
-    highlightTraversal();
-}
-
-// 前序遍历的递归实现
-void TreeTraversalWidget::dfsPre(TreeNode* n) {
-    if (!n) return;
-    visitOrder.push_back(n);
-    dfsPre(n->left);
-    dfsPre(n->right);
-}
-
-// 中序遍历的递归实现
-void TreeTraversalWidget::dfsIn(TreeNode* n) {
-    if (!n) return;
-    dfsIn(n->left);
-    visitOrder.push_back(n);
-    dfsIn(n->right);
+    highlightTraversal(TraversalOrder::Levelorder);
 }
 
-// 后序遍历的递归实现
-void TreeTraversalWidget::dfsPost(TreeNode* n) {
-    if (!n) return;
-    dfsPost(n->left);
-    dfsPost(n->right);
-    visitOrder.push_back(n);
+// Morris 中序遍历的槽函数：访问顺序与中序相同，但不使用栈
+void TreeTraversalWidget::onMorrisInorder() {
+    highlightTraversal(TraversalOrder::MorrisInorder);
 }
@@ -5,38 +5,55 @@
 #include <QGraphicsScene>
 #include <QGraphicsView>
 #include <QPushButton>
-#include <QTextEdit>
+#include <QListView>
+#include <QLabel>
+#include <QSpinBox>
+#include <memory>
 #include <vector>
-#include <queue>
-
-// TreeNode 结构体，表示二叉树的一个节点
-struct TreeNode {
-    int id;
-    QGraphicsEllipseItem* circle;  // 节点的图形表示
-    QGraphicsTextItem* label;  // 节点的文本标签
-    QGraphicsLineItem* parentEdge;  // 父节点和当前节点之间的连接线
-    TreeNode* parent;  // 父节点指针
-    TreeNode* left;  // 左子节点指针
-    TreeNode* right;  // 右子节点指针
-};
+#include <unordered_map>
+#include "binarytreemodel.h"
+#include "treetraversal.h"
+#include "edgelayeritem.h"
+
+class NodeItem;
+class NodeItemPool;
+class PathLogModel;
+class OpLogBar;
 
+// 树的遍历控件：树存放在连续的节点池中（BinaryTreeModel），可以载入任意规模的完全二叉树，
+// 只为视口附近的节点创建图元，平移/缩放时再按需创建或回收
 class TreeTraversalWidget : public QWidget {
     Q_OBJECT
 
 public:
     explicit TreeTraversalWidget(QWidget* parent = nullptr);
+    ~TreeTraversalWidget() override;
+
+    void loadCompleteTree(int nodeCount);   // 载入 nodeCount 个节点的完全二叉树
+    int  materializedCount() const { return static_cast<int>(visuals.size()); }  // 当前已创建图元的节点数
 
 protected:
     // 重写 showEvent 函数，在窗口显示时进行初始化操作
     void showEvent(QShowEvent* ev) override;
+    void resizeEvent(QResizeEvent* ev) override;
 
 private slots:
     void onPreorder();  // 执行前序遍历
     void onInorder();   // 执行中序遍历
     void onPostorder(); // 插槽：执行后序遍历
     void onLevelorder();    // 插槽：执行层次遍历
+    void onMorrisInorder(); // 插槽：执行 Morris 中序遍历
+    void onLoad();      // 按输入的节点数重新生成树
+    void materializeVisible();  // 为视口内的节点创建图元，回收视口外的图元
 
 private:
+    // 已创建图元的节点：节点图元及其连向父节点的连线在边图层中的下标
+    struct Visual {
+        NodeItem* item;
+        int edgeIndex;
+        int pass;   // 最近一次可见时的刷新轮次
+    };
+
     QGraphicsScene* scene;
     QGraphicsView* mainView;
     QGraphicsView* thumbView;
@@ -44,19 +61,42 @@ private:
     QPushButton* btnIn;
     QPushButton* btnPost;
     QPushButton* btnLevel;
-    QTextEdit* pathLog;
-    TreeNode* nodes[16]  = {}; // 存储树的节点，最多支持 16 个节点
-    TreeNode* root;
-    std::vector<TreeNode*> visitOrder;    // 记录节点遍历的顺序
+    QPushButton* btnMorris;
+    QPushButton* btnLoad;
+    QSpinBox* sizeSpin;
+    QLabel* pathLabel;                  // 当前路径
+    QListView* pathLog;                 // 路径日志，只绘制可见行
+    PathLogModel* pathModel;
+    OpLogBar* opBar;                    // 录制/回放载入树和遍历的操作
+    EdgeLayerItem* edges;               // 已创建节点的连线
+    BinaryTreeModel tree;               // 节点池：值、左右孩子、父节点都用下标表示
+    std::vector<quint8> visited;        // 按节点编号记录是否已被遍历高亮
+    std::unordered_map<int, Visual> visuals;   // 节点编号 -> 图元，只包含视口附近的节点
+    std::unique_ptr<NodeItemPool> pool; // 节点图元池：离开视口的图元隐藏后等待复用
+    int levels = 0;                     // 树的层数
+    qreal layoutWidth = 800;            // 布局宽度，随最底层节点数增长
+    int materializePass = 0;
+    std::unique_ptr<TraversalCursor> cursor;    // 进行中的遍历，每一步取一个节点
+    // 当前路径（根到最近访问节点）按栈增量维护：相邻两次访问只弹出/压入不同的部分
+    std::vector<int> pathStack;         // 路径上的节点编号
+    std::vector<int> pathOffsets;       // 每个节点的文本在 pathText 中的起始位置
+    std::vector<int> stackDepth;        // 按节点编号记录其在 pathStack 中的位置，不在栈中为 -1
+    QString pathText;                   // 当前路径文本
     int traversalDelayMs = 1000;    // 遍历的延迟时间，单位：毫秒
+    int traversalChannel;           // 遍历动画在调度器中的通道，开始新遍历时整体取消
+
+    static constexpr int materializeBudget = 4000;  // 一次最多为这么多节点创建图元
 
-    void buildBinaryTree(); // 构建二叉树
-    void layoutBinaryTree();    // 布局二叉树节点的位置
+    void layoutBinaryTree();    // 根据节点数确定布局尺寸和场景范围
+    QPointF slotPos(int slot) const;    // 第 slot 个槽位节点的左上角坐标
+    void applyVisited(int id, const Visual& v);  // 按遍历状态设置节点和连线的颜色
+    void clearVisuals();        // 回收所有已创建的图元
     void resetVisuals();    // 重置所有视觉元素
-    void highlightTraversal();  // 高亮显示当前遍历路径
-    void dfsPre(TreeNode* n);   // 前序遍历
-    void dfsIn(TreeNode* n);    // 中序遍历
-    void dfsPost(TreeNode* n);  // 后序遍历
+    void highlightTraversal(TraversalOrder order);  // 按给定顺序逐步高亮遍历路径
+    void stopTraversal();       // 取消进行中的遍历
+    void advancePath(int id);   // 把当前路径更新为根到 id 的路径
+    void resetPath();           // 清空当前路径和路径日志
+    QString formatPath(int id) const;   // 生成根到 id 的路径文本，只用于日志的可见行
 };
 
 #endif
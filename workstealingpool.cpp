@@ -0,0 +1,120 @@
+#include "workstealingpool.h"
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(int threadCount) {
+    int n = threadCount > 0 ? threadCount : static_cast<int>(std::thread::hardware_concurrency());
+    n = std::max(1, n);
+    for (int i = 0; i < n; ++i) queues.push_back(std::make_unique<Queue>());
+    for (int i = 0; i + 1 < n; ++i) threads.emplace_back([this, i]() { workerLoop(i); });
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : threads) t.join();
+}
+
+WorkStealingPool& WorkStealingPool::instance() {
+    static WorkStealingPool pool;
+    return pool;
+}
+
+void WorkStealingPool::parallelFor(int begin, int end, int grainSize, const Body& loopBody) {
+    if (end <= begin) return;
+    const int self = concurrency() - 1;
+    grainSize = std::max(1, grainSize);
+    if (concurrency() == 1 || end - begin <= grainSize) {
+        loopBody(begin, end, self);
+        return;
+    }
+
+    body = &loopBody;
+    grain = grainSize;
+    remaining = end - begin;
+    {
+        std::lock_guard<std::mutex> lock(queues[self]->mutex);
+        queues[self]->ranges.push_back(Range{begin, end});
+    }
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        ++queued;
+    }
+    wake.notify_all();
+
+    // 提交线程也参与执行，没有可做的任务时等待其余线程完成
+    while (remaining > 0) {
+        Range r;
+        if (takeLocal(self, r) || steal(self, r)) {
+            execute(self, r);
+        } else {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            done.wait(lock, [this]() { return remaining == 0 || queued > 0; });
+        }
+    }
+    body = nullptr;
+}
+
+void WorkStealingPool::workerLoop(int worker) {
+    for (;;) {
+        Range r;
+        if (takeLocal(worker, r) || steal(worker, r)) {
+            execute(worker, r);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(stateMutex);
+        wake.wait(lock, [this]() { return stopping || queued > 0; });
+        if (stopping) return;
+    }
+}
+
+bool WorkStealingPool::takeLocal(int worker, Range& r) {
+    Queue& q = *queues[worker];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.ranges.empty()) return false;
+    r = q.ranges.back();
+    q.ranges.pop_back();
+    --queued;
+    return true;
+}
+
+// 依次尝试其他线程的队列，从头部取走最早放入、也就是最大的区间
+bool WorkStealingPool::steal(int worker, Range& r) {
+    int n = concurrency();
+    for (int k = 1; k < n; ++k) {
+        Queue& q = *queues[(worker + k) % n];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.ranges.empty()) continue;
+        r = q.ranges.front();
+        q.ranges.pop_front();
+        --queued;
+        ++m_steals;
+        return true;
+    }
+    return false;
+}
+
+// 区间大于粒度时对半拆分，后一半放回自己的队列供他人窃取，直到剩下的部分不超过粒度
+void WorkStealingPool::execute(int worker, Range r) {
+    while (r.end - r.begin > grain) {
+        int mid = r.begin + (r.end - r.begin) / 2;
+        {
+            std::lock_guard<std::mutex> lock(queues[worker]->mutex);
+            queues[worker]->ranges.push_back(Range{mid, r.end});
+        }
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);  // 与等待方的判断互斥，避免丢失唤醒
+            ++queued;
+        }
+        wake.notify_one();
+        r.end = mid;
+    }
+    (*body)(r.begin, r.end, worker);
+    int count = r.end - r.begin;
+    if (remaining.fetch_sub(count) == count) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        done.notify_all();
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// WorkStealingPool 是按核数创建的工作窃取线程池，只提供并行循环 parallelFor：
+// 整个区间作为一个任务放入提交线程的队列，线程取到区间后不断对半拆分，
+// 后一半留在自己队列的尾部，空闲的线程从别人队列的头部窃取（取走的总是较大的区间）。
+// 提交线程也参与执行，直到整个区间完成后返回。
+// 同一时间只能有一个线程提交任务，parallelFor 的循环体中不能再调用 parallelFor。
+class WorkStealingPool
+{
+public:
+    using Body = std::function<void(int begin, int end, int worker)>;
+
+    explicit WorkStealingPool(int threads = 0);     // threads <= 0 时按硬件核数创建
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    static WorkStealingPool& instance();    // 按核数创建的全局线程池
+
+    // 参与执行的线程数（工作线程加提交线程），worker 参数的取值范围为 0..concurrency()-1，
+    // 可用来索引每个线程私有的缓冲区
+    int concurrency() const { return static_cast<int>(queues.size()); }
+
+    // 并行处理 [begin, end)，每次调用 body 处理的区间不超过 grain 个元素
+    void parallelFor(int begin, int end, int grain, const Body& body);
+
+    long long steals() const { return m_steals; }   // 累计窃取次数
+
+private:
+    struct Range {
+        int begin;
+        int end;
+    };
+
+    // 每个线程一个双端队列：自己从尾部取，别人从头部偷
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Range> ranges;
+    };
+
+    void workerLoop(int worker);
+    bool takeLocal(int worker, Range& r);
+    bool steal(int worker, Range& r);
+    void execute(int worker, Range r);
+
+    std::vector<std::unique_ptr<Queue>> queues;    // 最后一个属于提交线程
+    std::vector<std::thread> threads;
+
+    std::mutex stateMutex;
+    std::condition_variable wake;       // 有新任务或需要退出时唤醒工作线程
+    std::condition_variable done;       // 当前并行循环完成时唤醒提交线程
+    const Body* body = nullptr;         // 当前并行循环的循环体
+    int grain = 1;
+    std::atomic<int> queued{0};         // 各队列中尚未被取走的区间数
+    std::atomic<int> remaining{0};      // 当前并行循环中尚未处理完的元素数
+    std::atomic<long long> m_steals{0};
+    bool stopping = false;
+};
+
+#endif